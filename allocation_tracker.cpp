@@ -0,0 +1,188 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocation_tracker.h"
+
+namespace daw {
+	char const * alloc_phase_name( alloc_phase_t phase ) {
+		switch( phase ) {
+		case alloc_phase_t::other:
+			return "other";
+		case alloc_phase_t::parse:
+			return "parse";
+		case alloc_phase_t::analysis:
+			return "analysis";
+		case alloc_phase_t::rendering:
+			return "rendering";
+		}
+		return "unknown";
+	}
+
+#if TRACK_ALLOCATIONS
+	namespace {
+		struct phase_counters_t {
+			::std::atomic<uint64_t> allocations;
+			::std::atomic<uint64_t> bytes_allocated;
+			::std::atomic<int64_t> bytes_live;
+		};	// phase_counters_t
+
+		// Zero initialized before any constructor runs, operator new can be called that early
+		phase_counters_t s_counters[alloc_phase_count];
+		thread_local alloc_phase_t t_phase = alloc_phase_t::other;
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Put in front of every block so delete knows what to take
+		/// off which phase.  Padded so the block keeps malloc's alignment</summary>
+		//////////////////////////////////////////////////////////////////////////
+		struct alignas( alignof( ::std::max_align_t ) ) block_header_t {
+			size_t size;
+			alloc_phase_t phase;
+		};	// block_header_t
+
+		void * tracked_alloc( size_t size ) {
+			auto const header = static_cast<block_header_t *>(::std::malloc( sizeof( block_header_t ) + size ));
+			if( nullptr == header ) {
+				return nullptr;
+			}
+			header->size = size;
+			header->phase = t_phase;
+			auto & counters = s_counters[static_cast<size_t>(header->phase)];
+			counters.allocations.fetch_add( 1, ::std::memory_order_relaxed );
+			counters.bytes_allocated.fetch_add( size, ::std::memory_order_relaxed );
+			counters.bytes_live.fetch_add( static_cast<int64_t>(size), ::std::memory_order_relaxed );
+			return header + 1;
+		}
+
+		void tracked_free( void * ptr ) {
+			if( nullptr == ptr ) {
+				return;
+			}
+			auto const header = static_cast<block_header_t *>(ptr) - 1;
+			s_counters[static_cast<size_t>(header->phase)].bytes_live.fetch_sub( static_cast<int64_t>(header->size), ::std::memory_order_relaxed );
+			::std::free( header );
+		}
+
+		void * tracked_new( size_t size ) {
+			while( true ) {
+				if( auto const result = tracked_alloc( size ) ) {
+					return result;
+				}
+				auto const handler = ::std::get_new_handler( );
+				if( nullptr == handler ) {
+					throw ::std::bad_alloc( );
+				}
+				handler( );
+			}
+		}
+	}	// namespace anonymous
+
+	bool allocation_tracking_enabled( ) {
+		return true;
+	}
+
+	::std::array<phase_allocations_t, alloc_phase_count> phase_allocations( ) {
+		::std::array<phase_allocations_t, alloc_phase_count> result;
+		for( size_t n = 0; n < alloc_phase_count; ++n ) {
+			result[n].allocations = s_counters[n].allocations.load( ::std::memory_order_relaxed );
+			result[n].bytes_allocated = s_counters[n].bytes_allocated.load( ::std::memory_order_relaxed );
+			result[n].bytes_live = s_counters[n].bytes_live.load( ::std::memory_order_relaxed );
+		}
+		return result;
+	}
+
+	alloc_phase_t current_alloc_phase( ) {
+		return t_phase;
+	}
+
+	alloc_phase_scope_t::alloc_phase_scope_t( alloc_phase_t phase ):
+			m_previous( t_phase ) {
+
+		t_phase = phase;
+	}
+
+	alloc_phase_scope_t::~alloc_phase_scope_t( ) {
+		t_phase = m_previous;
+	}
+#else
+	bool allocation_tracking_enabled( ) {
+		return false;
+	}
+
+	::std::array<phase_allocations_t, alloc_phase_count> phase_allocations( ) {
+		::std::array<phase_allocations_t, alloc_phase_count> result;
+		result.fill( phase_allocations_t{ 0, 0, 0 } );
+		return result;
+	}
+
+	alloc_phase_t current_alloc_phase( ) {
+		return alloc_phase_t::other;
+	}
+#endif
+}	// namespace daw
+
+#if TRACK_ALLOCATIONS
+void * operator new( size_t size ) {
+	return daw::tracked_new( size );
+}
+
+void * operator new[]( size_t size ) {
+	return daw::tracked_new( size );
+}
+
+void * operator new( size_t size, ::std::nothrow_t const & ) noexcept {
+	return daw::tracked_alloc( size );
+}
+
+void * operator new[]( size_t size, ::std::nothrow_t const & ) noexcept {
+	return daw::tracked_alloc( size );
+}
+
+void operator delete( void * ptr ) noexcept {
+	daw::tracked_free( ptr );
+}
+
+void operator delete[]( void * ptr ) noexcept {
+	daw::tracked_free( ptr );
+}
+
+void operator delete( void * ptr, size_t ) noexcept {
+	daw::tracked_free( ptr );
+}
+
+void operator delete[]( void * ptr, size_t ) noexcept {
+	daw::tracked_free( ptr );
+}
+
+void operator delete( void * ptr, ::std::nothrow_t const & ) noexcept {
+	daw::tracked_free( ptr );
+}
+
+void operator delete[]( void * ptr, ::std::nothrow_t const & ) noexcept {
+	daw::tracked_free( ptr );
+}
+#endif
+
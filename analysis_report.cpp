@@ -0,0 +1,260 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+
+#include <daw/csv_helper/data_common.h>
+
+#include "analysis_report.h"
+#include "task_pool.h"
+#include "trace.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		namespace {
+			using aggregate_t = daw::AggregateData<daw::data::real_t>;
+
+			void finish( aggregate_t & aggregate ) {
+				// process_values divides by the count
+				if( 0 != aggregate.count ) {
+					aggregate.process_values( );
+				}
+			}
+
+			bool in_range( basal_window_t const & window, analysis_options_t const & options ) {
+				return (options.from.is_not_a_date_time( ) || window.start >= options.from) && (options.to.is_not_a_date_time( ) || window.end <= options.to);
+			}
+
+			::std::string iso_time( boost::posix_time::ptime const & value ) {
+				return value.is_not_a_date_time( ) ? ::std::string( ) : boost::posix_time::to_iso_extended_string( value );
+			}
+
+			/// Start of 5 minute period n of a day as HH:MM
+			::std::string bin_time( size_t n ) {
+				::std::ostringstream ss;
+				ss << ::std::setfill( '0' ) << ::std::setw( 2 ) << n / 12 << ':' << ::std::setw( 2 ) << (n % 12) * 5;
+				return ss.str( );
+			}
+
+			::std::string json_string( ::std::string const & value ) {
+				::std::string result = "\"";
+				for( auto const c : value ) {
+					switch( c ) {
+					case '"': result += "\\\""; break;
+					case '\\': result += "\\\\"; break;
+					case '\n': result += "\\n"; break;
+					case '\r': result += "\\r"; break;
+					case '\t': result += "\\t"; break;
+					default:
+						if( static_cast<unsigned char>(c) < 0x20 ) {
+							char buff[8];
+							snprintf( buff, sizeof( buff ), "\\u%04x", static_cast<unsigned>(c) );
+							result += buff;
+						} else {
+							result += c;
+						}
+					}
+				}
+				return result + "\"";
+			}
+
+			::std::string csv_string( ::std::string const & value ) {
+				if( ::std::string::npos == value.find_first_of( ",\"\r\n" ) ) {
+					return value;
+				}
+				::std::string result = "\"";
+				for( auto const c : value ) {
+					if( '"' == c ) {
+						result += '"';
+					}
+					result += c;
+				}
+				return result + "\"";
+			}
+
+			/// Empty aggregates have no meaningful statistics, they are written as null
+			void write_json_stats( ::std::ostream & out, aggregate_t const & aggregate ) {
+				out << "\"count\":" << aggregate.count;
+				if( 0 == aggregate.count || !::std::isfinite( aggregate.std_dev ) ) {
+					out << ",\"average\":null,\"low\":null,\"high\":null,\"std_dev\":null";
+					return;
+				}
+				out << ",\"average\":" << aggregate.average << ",\"low\":" << aggregate.low << ",\"high\":" << aggregate.high << ",\"std_dev\":" << aggregate.std_dev;
+			}
+
+			void write_json_bins( ::std::ostream & out, ::std::vector<aggregate_t> const & bins ) {
+				out << '[';
+				for( size_t n = 0; n < bins.size( ); ++n ) {
+					out << (0 == n ? "" : ",") << "{\"time\":\"" << bin_time( n ) << "\",";
+					write_json_stats( out, bins[n] );
+					out << '}';
+				}
+				out << ']';
+			}
+
+			void write_csv_stats( ::std::ostream & out, aggregate_t const & aggregate ) {
+				out << ',' << aggregate.count;
+				if( 0 == aggregate.count || !::std::isfinite( aggregate.std_dev ) ) {
+					out << ",,,,";
+					return;
+				}
+				out << ',' << aggregate.average << ',' << aggregate.low << ',' << aggregate.high << ',' << aggregate.std_dev;
+			}
+
+			void write_csv_bins( ::std::ostream & out, ::std::string const & file, char const * record, ::std::vector<aggregate_t> const & bins ) {
+				for( size_t n = 0; n < bins.size( ); ++n ) {
+					out << file << ',' << record << ',' << n << ',' << bin_time( n ) << ',';
+					write_csv_stats( out, bins[n] );
+					out << ",\n";
+				}
+			}
+		}	// namespace anonymous
+
+		file_report_t analyse_file( ::std::string const & filename, analysis_options_t const & options, cancellation_token_t const & cancelled ) {
+			trace_span_t span( "analyse_file" );
+			file_report_t result;
+			result.filename = filename;
+			try {
+				cancelled.throw_if_cancelled( );
+				auto const data = load_pump_data( filename, []( ::std::string ) { } );
+				cancelled.throw_if_cancelled( );
+				auto const & ts_col = data["Timestamp"];
+				auto const & bg_col = data["Sensor Glucose (mmol/L)"];
+				result.row_count = ts_col.size( );
+				if( options.measure_memory ) {
+					result.memory = make_memory_report( filename, data );
+				}
+				if( !ts_col.empty( ) ) {
+					result.first_timestamp = ts_col[0].timestamp( );
+					result.last_timestamp = ts_col[ts_col.size( ) - 1].timestamp( );
+				}
+
+				PumpDataAnalysis::basal_tests_t tests;
+				for( auto const & test : find_basal_tests( data, options.detector, cancelled ) ) {
+					basal_window_t window{ test.first, test.second, ts_col[test.first].timestamp( ), ts_col[test.second].timestamp( ), aggregate_t( ) };
+					if( !in_range( window, options ) ) {
+						continue;
+					}
+					for( auto row = test.first; row <= test.second; ++row ) {
+						if( bg_col[row] ) {
+							window.glucose.add_value( bg_col[row].real( ) );
+							result.glucose.add_value( bg_col[row].real( ) );
+						}
+					}
+					finish( window.glucose );
+					result.window_hours += static_cast<double>((window.end - window.start).total_seconds( )) / 3600.0;
+					result.windows.push_back( ::std::move( window ) );
+					tests.push_back( test );
+				}
+				finish( result.glucose );
+
+				result.bins = aggregate_basal_tests( data, tests, cancelled );
+				if( options.derivatives ) {
+					result.derivative_bins = aggregate_basal_test_derivatives( data, tests, cancelled );
+				}
+			} catch( ::std::exception const & ex ) {
+				result.error = ex.what( );
+			} catch( ... ) {
+				result.error = "Unknown error";
+			}
+			return result;
+		}
+
+		::std::vector<file_report_t> analyse_files( ::std::vector<::std::string> const & filenames, analysis_options_t const & options, cancellation_token_t const & cancelled ) {
+			::std::vector<task_future_t<file_report_t>> pending;
+			pending.reserve( filenames.size( ) );
+			for( auto const & filename : filenames ) {
+				pending.push_back( task_pool_t::get( ).submit( task_priority_t::background, [&filename, &options, cancelled]( ) {
+					return analyse_file( filename, options, cancelled );
+				}, load_memory_estimate( filename ) ) );
+			}
+			::std::vector<file_report_t> result;
+			result.reserve( pending.size( ) );
+			for( auto & report : pending ) {
+				result.push_back( report.get( ) );
+			}
+			return result;
+		}
+
+		void write_reports_json( ::std::ostream & out, ::std::vector<file_report_t> const & reports ) {
+			out << "{\"files\":[";
+			for( size_t n = 0; n < reports.size( ); ++n ) {
+				auto const & report = reports[n];
+				out << (0 == n ? "" : ",") << "\n{\"file\":" << json_string( report.filename );
+				if( !report.error.empty( ) ) {
+					out << ",\"error\":" << json_string( report.error ) << '}';
+					continue;
+				}
+				out << ",\"rows\":" << report.row_count;
+				out << ",\"first_timestamp\":" << json_string( iso_time( report.first_timestamp ) );
+				out << ",\"last_timestamp\":" << json_string( iso_time( report.last_timestamp ) );
+				out << ",\"summary\":{\"windows\":" << report.windows.size( ) << ",\"window_hours\":" << report.window_hours << ',';
+				write_json_stats( out, report.glucose );
+				out << "},\"windows\":[";
+				for( size_t w = 0; w < report.windows.size( ); ++w ) {
+					auto const & window = report.windows[w];
+					out << (0 == w ? "" : ",") << "{\"first_row\":" << window.first_row << ",\"last_row\":" << window.last_row;
+					out << ",\"start\":" << json_string( iso_time( window.start ) ) << ",\"end\":" << json_string( iso_time( window.end ) ) << ',';
+					write_json_stats( out, window.glucose );
+					out << '}';
+				}
+				out << "],\"bins\":";
+				write_json_bins( out, report.bins );
+				if( !report.derivative_bins.empty( ) ) {
+					out << ",\"derivative_bins\":";
+					write_json_bins( out, report.derivative_bins );
+				}
+				out << '}';
+			}
+			out << "\n]}\n";
+		}
+
+		void write_reports_csv( ::std::ostream & out, ::std::vector<file_report_t> const & reports ) {
+			out << "file,record,index,start,end,count,average,low,high,std_dev,error\n";
+			for( auto const & report : reports ) {
+				auto const file = csv_string( report.filename );
+				if( !report.error.empty( ) ) {
+					out << file << ",error,,,,,,,,," << csv_string( report.error ) << '\n';
+					continue;
+				}
+				out << file << ",summary," << report.windows.size( ) << ',' << iso_time( report.first_timestamp ) << ',' << iso_time( report.last_timestamp );
+				write_csv_stats( out, report.glucose );
+				out << ",\n";
+				for( size_t w = 0; w < report.windows.size( ); ++w ) {
+					auto const & window = report.windows[w];
+					out << file << ",window," << w << ',' << iso_time( window.start ) << ',' << iso_time( window.end );
+					write_csv_stats( out, window.glucose );
+					out << ",\n";
+				}
+				write_csv_bins( out, file, "bin", report.bins );
+				write_csv_bins( out, file, "derivative_bin", report.derivative_bins );
+			}
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
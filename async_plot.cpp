@@ -0,0 +1,109 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "allocation_tracker.h"
+#include "async_plot.h"
+#include "trace.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		async_plot_t::async_plot_t( ):
+				m_cancel( ),
+				m_result( ) { }
+
+		async_plot_t::async_plot_t( ::std::unique_ptr<graph_config_t> graph_config, builder_t builder, task_priority_t priority ):
+				m_cancel( ),
+				m_result( ) {
+
+			// The first call measures the fonts so it has to happen here, on the UI thread
+			auto metrics = text_metrics_t::for_graphs( );
+			m_result = task_pool_t::get( ).submit( priority, [graph_config = ::std::move( graph_config ), builder = ::std::move( builder ), metrics = ::std::move( metrics ), cancelled = m_cancel.token( )]( ) mutable {
+				// The pens and fonts go back with the result so the UI thread is the only one to release them
+				build_t result{ ::std::move( graph_config ), nullptr, nullptr };
+				try {
+					// A build cancelled before it started is run by the thread cancelling it, keep that short
+					cancelled.throw_if_cancelled( );
+					trace_span_t span( "build_plot" );
+					alloc_phase_scope_t phase( alloc_phase_t::rendering );
+					result.plot.reset( new PanelGenericPlotter( ) );
+					result.plot->set_text_metrics( metrics );
+					builder( *result.plot, *result.graph_config, cancelled );
+					span.counter( "actions", static_cast<int64_t>(result.plot->action_count( )) );
+				} catch( ... ) {
+					result.error = ::std::current_exception( );
+				}
+				return result;
+			} );
+		}
+
+		async_plot_t::~async_plot_t( ) {
+			cancel_and_wait( );
+		}
+
+		async_plot_t & async_plot_t::operator=( async_plot_t && rhs ) {
+			if( this != &rhs ) {
+				// The builder may be reading data its owner is about to replace
+				cancel_and_wait( );
+				m_cancel = ::std::move( rhs.m_cancel );
+				m_result = ::std::move( rhs.m_result );
+			}
+			return *this;
+		}
+
+		void async_plot_t::cancel_and_wait( ) {
+			if( m_result.valid( ) ) {
+				m_cancel.cancel( );
+				// Take the result so what the builder made is destroyed here, on the UI thread
+				m_result.get( );
+			}
+		}
+
+		bool async_plot_t::valid( ) const {
+			return m_result.valid( );
+		}
+
+		bool async_plot_t::is_ready( ) const {
+			return m_result.is_ready( );
+		}
+
+		bool async_plot_t::is_started( ) const {
+			return m_result.is_started( );
+		}
+
+		::std::unique_ptr<PanelGenericPlotter> async_plot_t::get( ) {
+			auto result = m_result.get( );
+			if( result.error ) {
+				::std::rethrow_exception( result.error );
+			}
+			return ::std::move( result.plot );
+		}
+
+		void draw_plot_placeholder( wxDC & dc, wxSize area, wxString const & text ) {
+			dc.SetBackground( *wxWHITE_BRUSH );
+			dc.Clear( );
+			auto const text_size = dc.GetTextExtent( text );
+			dc.DrawText( text, (area.GetWidth( ) - text_size.GetWidth( )) / 2, (area.GetHeight( ) - text_size.GetHeight( )) / 2 );
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
@@ -0,0 +1,348 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <wx/image.h>
+
+#include "batch_render.h"
+#include "cancellation.h"
+#include "panel_average_basal.h"
+#include "panel_data_plot.h"
+#include "panel_generic_plot.h"
+#include "plot_renderer.h"
+#include "pump_data_analysis.h"
+#include "task_pool.h"
+#include "text_metrics.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		batch_render_options_t::batch_render_options_t( ):
+				size( 1200, 600 ),
+				write_png( true ),
+				write_svg( false ),
+				thread_count( 0 ) { }
+
+		batch_render_result_t::batch_render_result_t( ):
+				files_loaded( 0 ),
+				images_written( 0 ),
+				errors( ) { }
+
+		namespace {
+			/// The pens and fonts a plot is built with.  Created and destroyed by the thread drawing, and in
+			/// between only touched by the job holding the worker or by that thread while it draws the job's
+			/// plot, so their reference counts are never changed by two threads at once
+			struct worker_t {
+				::std::unique_ptr<graph_config_t> graph_config;
+			};
+
+			struct job_t {
+				/// A plot job returns its display list, which keeps the worker until it has been drawn
+				::std::function<::std::unique_ptr<PanelGenericPlotter>( worker_t & )> run;
+				::std::string base;	// Images are written to base plus the extension
+				size_t memory;	// Estimate for the task pool
+			};
+
+			struct ready_plot_t {
+				::std::string base;
+				::std::unique_ptr<PanelGenericPlotter> plot;
+				worker_t * worker;
+			};
+
+			::std::string zero_pad( size_t value, size_t width ) {
+				auto result = ::std::to_string( value );
+				if( result.size( ) < width ) {
+					result.insert( 0, width - result.size( ), '0' );
+				}
+				return result;
+			}
+		}	// namespace anonymous
+
+		namespace impl {
+			/// Jobs are handed to the task pool as workers come free, so no more than one job per
+			/// worker runs at once and no pool thread ever blocks waiting for a worker
+			class batch_t final: public ::std::enable_shared_from_this<batch_t> {
+				::std::mutex m_mutex;
+				::std::condition_variable m_changed;	// A plot is ready or the last job finished
+				::std::deque<job_t> m_jobs;
+				::std::deque<ready_plot_t> m_ready;
+				::std::vector<worker_t> m_workers;
+				::std::vector<worker_t *> m_idle_workers;
+				size_t m_running;
+				bool m_finished;
+				cancellation_source_t m_cancel;
+				boost::filesystem::path const m_out_dir;
+				batch_render_options_t const m_options;
+				::std::shared_ptr<text_metrics_t const> const m_metrics;
+				batch_render_result_t m_result;
+
+				void push( ::std::function<::std::unique_ptr<PanelGenericPlotter>( worker_t & )> job, ::std::string base = ::std::string( ), size_t memory = 0 ) {
+					// Started by schedule once a worker is free, jobs added by a job wait for it to finish
+					::std::lock_guard<::std::mutex> lock( m_mutex );
+					if( !m_cancel.is_cancelled( ) ) {
+						m_jobs.push_back( job_t{ ::std::move( job ), ::std::move( base ), memory } );
+					}
+				}
+
+				void run( job_t const & job, worker_t & worker ) {
+					::std::unique_ptr<PanelGenericPlotter> plot;
+					try {
+						if( !m_cancel.is_cancelled( ) ) {
+							plot = job.run( worker );
+						}
+					} catch( ::std::exception const & ex ) {
+						add_error( ex.what( ) );
+					} catch( ... ) {
+						add_error( "Unknown error rendering report" );
+					}
+					{
+						::std::lock_guard<::std::mutex> lock( m_mutex );
+						--m_running;
+						if( plot ) {
+							m_ready.push_back( ready_plot_t{ job.base, ::std::move( plot ), &worker } );
+						} else {
+							m_idle_workers.push_back( &worker );
+						}
+					}
+					m_changed.notify_all( );
+					schedule( );
+				}
+
+				void add_error( ::std::string msg ) {
+					::std::lock_guard<::std::mutex> lock( m_mutex );
+					m_result.errors.push_back( ::std::move( msg ) );
+				}
+
+				void push_plot( ::std::string name, ::std::string axis_title_y, ::std::function<void( PanelGenericPlotter &, graph_config_t & )> build ) {
+					push( [this, axis_title_y = ::std::move( axis_title_y ), build = ::std::move( build )]( worker_t & worker ) {
+						::std::unique_ptr<PanelGenericPlotter> gen_plot( new PanelGenericPlotter( ) );
+						gen_plot->set_text_metrics( m_metrics );
+						worker.graph_config->axis_title_y = axis_title_y;
+						build( *gen_plot, *worker.graph_config );
+						return gen_plot;
+					}, (m_out_dir / name).string( ) );
+				}
+
+				void push_file( ::std::string filename ) {
+					push( [this, filename]( worker_t & ) -> ::std::unique_ptr<PanelGenericPlotter> {
+						auto const data = ::std::make_shared<daw::data::compact_table_t const>( load_pump_data( filename, []( ::std::string ) { } ) );
+						auto const cancelled = m_cancel.token( );
+						auto const tests = ::std::make_shared<PumpDataAnalysis::basal_tests_t const>( find_basal_tests( *data, cancelled ) );
+						{
+							::std::lock_guard<::std::mutex> lock( m_mutex );
+							++m_result.files_loaded;
+						}
+						auto const stem = boost::filesystem::path( filename ).stem( ).string( );
+						for( size_t n = 0; n < tests->size( ); ++n ) {
+							auto const period = (*tests)[n];
+							push_plot( stem + "_basal_test_" + zero_pad( n + 1, 3 ), "mmol/L", [data, period]( PanelGenericPlotter & gen_plot, graph_config_t & graph_config ) {
+								build_basal_test_plot( gen_plot, *data, period.first, period.second, graph_config );
+							} );
+						}
+						if( tests->empty( ) ) {
+							return nullptr;
+						}
+						push_plot( stem + "_average_basal", "mmol/L", [data, tests]( PanelGenericPlotter & gen_plot, graph_config_t & graph_config ) {
+							build_average_basal_plot( gen_plot, aggregate_basal_tests( *data, *tests ), graph_config );
+						} );
+						push_plot( stem + "_average_basal_derivative", "mmol/L per hour", [data, tests]( PanelGenericPlotter & gen_plot, graph_config_t & graph_config ) {
+							build_average_basal_plot( gen_plot, aggregate_basal_test_derivatives( *data, *tests ), graph_config );
+						} );
+						return nullptr;
+					}, ::std::string( ), load_memory_estimate( filename ) );
+				}
+
+				void draw( ready_plot_t const & ready ) {
+					size_t written = 0;
+					if( m_options.write_png ) {
+						render_to_png( *ready.plot, m_options.size, ready.base + ".png" );
+						++written;
+					}
+					if( m_options.write_svg ) {
+						render_to_svg( *ready.plot, m_options.size, ready.base + ".svg" );
+						++written;
+					}
+					::std::lock_guard<::std::mutex> lock( m_mutex );
+					m_result.images_written += written;
+				}
+
+				bool is_done( ) const {
+					return m_jobs.empty( ) && m_ready.empty( ) && 0 == m_running;
+				}
+			public:
+				batch_t( ::std::vector<::std::string> const & filenames, ::std::string out_dir, batch_render_options_t options ):
+						m_mutex( ),
+						m_changed( ),
+						m_jobs( ),
+						m_ready( ),
+						m_workers( ),
+						m_idle_workers( ),
+						m_running( 0 ),
+						m_finished( false ),
+						m_cancel( ),
+						m_out_dir( ::std::move( out_dir ) ),
+						m_options( ::std::move( options ) ),
+						m_metrics( text_metrics_t::for_graphs( ) ),
+						m_result( ) {
+
+					// Created here, on the thread that draws, which is also the one that destroys them
+					auto const worker_count = 0 != m_options.thread_count ? m_options.thread_count : task_pool_t::get( ).thread_count( );
+					m_workers.resize( worker_count );
+					for( auto & worker : m_workers ) {
+						worker.graph_config.reset( new graph_config_t( ) );
+						m_idle_workers.push_back( &worker );
+					}
+					for( auto const & filename : filenames ) {
+						push_file( filename );
+					}
+				}
+
+				/// Start queued jobs on idle workers
+				void schedule( ) {
+					::std::lock_guard<::std::mutex> lock( m_mutex );
+					while( !m_jobs.empty( ) && !m_idle_workers.empty( ) ) {
+						auto job = ::std::make_shared<job_t const>( ::std::move( m_jobs.front( ) ) );
+						m_jobs.pop_front( );
+						auto worker = m_idle_workers.back( );
+						m_idle_workers.pop_back( );
+						++m_running;
+						task_pool_t::get( ).submit( task_priority_t::background, [self = shared_from_this( ), job, worker]( ) {
+							self->run( *job, *worker );
+						}, job->memory );
+					}
+				}
+
+				bool draw_ready( ::std::chrono::milliseconds timeout ) {
+					::std::deque<ready_plot_t> ready;
+					{
+						::std::unique_lock<::std::mutex> lock( m_mutex );
+						if( m_finished ) {
+							return true;
+						}
+						m_changed.wait_for( lock, timeout, [&]( ) {
+							return !m_ready.empty( ) || is_done( );
+						} );
+						ready.swap( m_ready );
+					}
+					for( auto & item : ready ) {
+						if( !m_cancel.is_cancelled( ) ) {
+							try {
+								draw( item );
+							} catch( ::std::exception const & ex ) {
+								add_error( ex.what( ) );
+							} catch( ... ) {
+								add_error( "Unknown error writing " + item.base );
+							}
+						}
+						// The display list shares the worker's pens, it is released before the worker is reused
+						item.plot.reset( );
+						::std::lock_guard<::std::mutex> lock( m_mutex );
+						m_idle_workers.push_back( item.worker );
+					}
+					schedule( );
+					{
+						::std::lock_guard<::std::mutex> lock( m_mutex );
+						// A job still running can add more
+						if( !is_done( ) ) {
+							return false;
+						}
+						m_finished = true;
+					}
+					// Nothing else holds a worker now, their GDI objects are released by the thread that made them
+					for( auto & worker : m_workers ) {
+						worker.graph_config.reset( );
+					}
+					return true;
+				}
+
+				void cancel( ) {
+					{
+						::std::lock_guard<::std::mutex> lock( m_mutex );
+						m_cancel.cancel( );
+						m_jobs.clear( );
+					}
+					// Running jobs stop at their next check, their plots are released here without drawing
+					while( !draw_ready( ::std::chrono::milliseconds( 50 ) ) ) { }
+				}
+
+				batch_render_result_t result( ) {
+					::std::lock_guard<::std::mutex> lock( m_mutex );
+					return m_result;
+				}
+			};	// batch_t
+		}	// namespace impl
+
+		batch_render_t::batch_render_t( ):
+				m_batch( ) { }
+
+		batch_render_t::batch_render_t( ::std::vector<::std::string> const & filenames, ::std::string out_dir, batch_render_options_t options ):
+				m_batch( ) {
+
+			if( nullptr == wxImage::FindHandler( wxBITMAP_TYPE_PNG ) ) {
+				wxImage::AddHandler( new wxPNGHandler );
+			}
+			boost::filesystem::create_directories( out_dir );
+
+			m_batch = ::std::make_shared<impl::batch_t>( filenames, ::std::move( out_dir ), ::std::move( options ) );
+			m_batch->schedule( );
+		}
+
+		batch_render_t::~batch_render_t( ) {
+			cancel( );
+		}
+
+		batch_render_t & batch_render_t::operator=( batch_render_t && rhs ) {
+			if( this != &rhs ) {
+				cancel( );
+				m_batch = ::std::move( rhs.m_batch );
+			}
+			return *this;
+		}
+
+		bool batch_render_t::valid( ) const {
+			return static_cast<bool>(m_batch);
+		}
+
+		bool batch_render_t::draw_ready( ::std::chrono::milliseconds timeout ) {
+			return m_batch->draw_ready( timeout );
+		}
+
+		void batch_render_t::cancel( ) {
+			if( m_batch ) {
+				m_batch->cancel( );
+				m_batch.reset( );
+			}
+		}
+
+		batch_render_result_t batch_render_t::get( ) {
+			auto result = m_batch->result( );
+			m_batch.reset( );
+			return result;
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
@@ -0,0 +1,281 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/init.h>
+#include <wx/wx.h>
+
+#include <daw/csv_helper/data_table.h>
+
+#include "bench_stats.h"
+#include "carelink_generator.h"
+#include "csv_parser.h"
+#include "panel_average_basal.h"
+#include "panel_data_plot.h"
+#include "panel_generic_plot.h"
+#include "pump_data_analysis.h"
+#include "text_metrics.h"
+
+// ---------------------------------------------------------------------------
+// Throughput of loading, detection, binning and display list construction on
+// generated CareLink exports from days to years long.  Each result is the
+// median of several runs, reported as rows and megabytes per second
+// ---------------------------------------------------------------------------
+
+namespace {
+	using namespace daw::pumpdataanalysis;
+
+	struct bench_context_t {
+		::std::string filter;	// Run only benchmarks whose name contains this
+		daw::bench::run_limits_t limits;
+	};	// bench_context_t
+
+	/// rows and bytes are the work done by one run, either may be 0 when meaningless
+	void run_bench( bench_context_t const & context, ::std::string const & name, size_t days, size_t rows, size_t bytes, ::std::function<void( )> const & setup, ::std::function<void( )> const & body ) {
+		if( !context.filter.empty( ) && ::std::string::npos == name.find( context.filter ) ) {
+			return;
+		}
+		auto const stats = daw::bench::summarize( daw::bench::time_runs( context.limits, setup, body ) );
+		auto const per_second = []( size_t amount, double seconds ) {
+			return seconds > 0.0 ? static_cast<double>(amount) / seconds : 0.0;
+		};
+		printf( "%-32s %6llu %10llu %10.3f %10.3f %14.0f %10.1f\n", name.c_str( ), static_cast<unsigned long long>(days), static_cast<unsigned long long>(rows),
+			stats.median * 1000.0, stats.min * 1000.0, per_second( rows, stats.median ), per_second( bytes, stats.median ) / (1024.0 * 1024.0) );
+		fflush( stdout );
+	}
+
+	daw::data::DataTable parse_export( ::std::string const & filename ) {
+		auto && tbl = daw::data::parse_csv_data( daw::data::parse_csv_data_param( filename, 11, pump_column_filter, []( ::std::string ) { } ) );
+		if( !tbl.has_value( ) ) {
+			throw ::std::runtime_error( "Could not parse " + filename + ": " + tbl.get_exception_message( ) );
+		}
+		return ::std::move( tbl.get( ) );
+	}
+
+	size_t test_rows( PumpDataAnalysis::basal_tests_t const & tests ) {
+		size_t result = 0;
+		for( auto const & test : tests ) {
+			result += test.second - test.first + 1;
+		}
+		return result;
+	}
+
+	void bench_size( bench_context_t const & context, size_t days, uint64_t seed, bool with_plots, bool keep_file ) {
+		carelink_generator_options_t generator_options;
+		generator_options.days = days;
+		generator_options.seed = seed;
+		auto const filename = (boost::filesystem::temp_directory_path( ) / boost::filesystem::unique_path( "carelink_%%%%%%%%.csv" )).string( );
+		auto const generated = generate_carelink_csv( filename, generator_options );
+		auto const rows = generated.rows;
+		auto const bytes = generated.bytes;
+
+		// Micro benchmarks of each load stage
+		run_bench( context, "parse_csv", days, rows, bytes, nullptr, [&]( ) {
+			parse_export( filename );
+		} );
+		// The parser used when loading, dropping empty rows as it goes.  Compare with parse_csv plus remove_empty_rows
+		run_bench( context, "parse_csv_skip_empty", days, rows, bytes, nullptr, [&]( ) {
+			daw::data::csv_parse_options_t options;
+			options.header_row = 11;
+			options.column_filter = &pump_column_filter;
+			options.skip_empty_rows = true;
+			daw::data::parse_csv_file( filename, options );
+		} );
+		run_bench( context, "parse_csv_lazy", days, rows, bytes, nullptr, [&]( ) {
+			daw::data::csv_parse_options_t options;
+			options.header_row = 11;
+			options.column_filter = &pump_column_filter;
+			options.parse_now = &pump_column_is_hot;
+			options.skip_empty_rows = true;
+			daw::data::parse_csv_file( filename, options );
+		} );
+
+		auto const parsed = parse_export( filename );
+		daw::data::DataTable table;
+		run_bench( context, "remove_empty_rows", days, rows, 0, [&]( ) {
+			table = parsed;
+		}, [&]( ) {
+			remove_empty_rows( table );
+		} );
+
+		auto cleaned = parsed;
+		remove_empty_rows( cleaned );
+		auto const cleaned_rows = cleaned["Timestamp"].size( );
+		run_bench( context, "convert_timestamps", days, cleaned_rows, 0, [&]( ) {
+			table = cleaned;
+		}, [&]( ) {
+			convert_timestamps( table, 0, cleaned_rows );
+		} );
+		convert_timestamps( cleaned, 0, cleaned_rows );
+		run_bench( context, "compact_pump_data", days, cleaned_rows, 0, [&]( ) {
+			table = cleaned;
+		}, [&]( ) {
+			compact_pump_data( ::std::move( table ) );
+		} );
+		table = daw::data::DataTable( );
+		auto const compact = compact_pump_data( ::std::move( cleaned ) );
+
+		// Detection and binning
+		PumpDataAnalysis::basal_tests_t tests;
+		run_bench( context, "find_basal_tests", days, cleaned_rows, 0, nullptr, [&]( ) {
+			tests = find_basal_tests( compact );
+		} );
+		auto const tested_rows = test_rows( tests );
+		run_bench( context, "aggregate_basal_tests", days, tested_rows, 0, nullptr, [&]( ) {
+			aggregate_basal_tests( compact, tests );
+		} );
+		run_bench( context, "aggregate_basal_test_derivatives", days, tested_rows, 0, nullptr, [&]( ) {
+			aggregate_basal_test_derivatives( compact, tests );
+		} );
+
+		// Macro benchmarks of the whole pipeline
+		run_bench( context, "load_pump_data", days, rows, bytes, nullptr, [&]( ) {
+			load_pump_data( filename, []( ::std::string ) { } );
+		} );
+		::std::unique_ptr<PumpDataAnalysis> analysis;
+		run_bench( context, "PumpDataAnalysis", days, rows, bytes, [&]( ) {
+			analysis.reset( );
+		}, [&]( ) {
+			analysis.reset( new PumpDataAnalysis( filename ) );
+			analysis->wait( );
+		} );
+		if( analysis && analysis->is_ready( ) ) {
+			// One query per 30 days of data, each scans the table from the start
+			auto const & ts_col = analysis->data_table( )["Timestamp"];
+			auto const first = ts_col[0].timestamp( );
+			auto const last = ts_col[ts_col.size( ) - 1].timestamp( );
+			::std::vector<::std::pair<boost::posix_time::ptime, boost::posix_time::ptime>> ranges;
+			for( auto from = first; from + boost::gregorian::days( 30 ) < last; from += boost::gregorian::days( 30 ) ) {
+				ranges.emplace_back( from, from + boost::gregorian::days( 30 ) );
+			}
+			if( !ranges.empty( ) && !analysis->basal_tests( ).empty( ) ) {
+				run_bench( context, "basal_tests_in_range", days, ts_col.size( ) * ranges.size( ), 0, nullptr, [&]( ) {
+					for( auto const & range : ranges ) {
+						try {
+							analysis->basal_tests_in_range( range );
+						} catch( ::std::exception const & ) {
+							// A month without basal tests
+						}
+					}
+				} );
+			}
+		}
+		analysis.reset( );
+
+		if( with_plots && !tests.empty( ) ) {
+			// Display lists are built the way async_plot_t builds them, with measured fonts
+			auto const metrics = text_metrics_t::for_graphs( );
+			graph_config_t graph_config;
+			graph_config.axis_title_y = "mmol/L";
+			run_bench( context, "build_basal_test_plot", days, tested_rows, 0, nullptr, [&]( ) {
+				for( auto const & test : tests ) {
+					PanelGenericPlotter gen_plot;
+					gen_plot.set_text_metrics( metrics );
+					build_basal_test_plot( gen_plot, compact, test.first, test.second, graph_config );
+				}
+			} );
+			auto const bins = aggregate_basal_tests( compact, tests );
+			run_bench( context, "build_average_basal_plot", days, tested_rows, 0, nullptr, [&]( ) {
+				PanelGenericPlotter gen_plot;
+				gen_plot.set_text_metrics( metrics );
+				build_average_basal_plot( gen_plot, bins, graph_config );
+			} );
+		}
+
+		if( keep_file ) {
+			::std::cerr << "Kept " << filename << '\n';
+		} else {
+			boost::system::error_code ec;
+			boost::filesystem::remove( filename, ec );
+		}
+	}
+}	// namespace anonymous
+
+int main( int argc, char ** argv ) {
+	namespace po = boost::program_options;
+
+	bench_context_t context;
+	::std::vector<size_t> days_list;
+	uint64_t seed = 1;
+
+	po::options_description desc( "Usage: mm_history_bench [options]\nOptions" );
+	desc.add_options( )
+		( "help,h", "Show this message" )
+		( "days,d", po::value<::std::vector<size_t>>( &days_list )->multitoken( ), "Days of data to generate, may be repeated.  Default 7 90 365 3650" )
+		( "seed", po::value<uint64_t>( &seed )->default_value( seed ), "Generator seed" )
+		( "filter", po::value<::std::string>( &context.filter ), "Only run benchmarks whose name contains this" )
+		( "min-seconds", po::value<double>( &context.limits.min_seconds )->default_value( context.limits.min_seconds ), "Time to spend on each benchmark" )
+		( "no-plots", "Skip display list construction, it needs a display" )
+		( "keep", "Keep the generated exports" );
+
+	po::variables_map vm;
+	try {
+		po::store( po::parse_command_line( argc, argv, desc ), vm );
+		po::notify( vm );
+	} catch( ::std::exception const & ex ) {
+		::std::cerr << ex.what( ) << '\n' << desc << '\n';
+		return 1;
+	}
+	if( vm.count( "help" ) ) {
+		::std::cout << desc << '\n';
+		return 0;
+	}
+	if( days_list.empty( ) ) {
+		days_list = { 7, 90, 365, 3650 };
+	}
+
+	bool with_plots = 0 == vm.count( "no-plots" );
+	if( with_plots ) {
+		// Fonts and pens need the GUI toolkit, but no window is ever shown
+		wxApp::SetInstance( new wxApp( ) );
+		if( !wxEntryStart( argc, argv ) ) {
+			::std::cerr << "Could not start wxWidgets, skipping display list benchmarks\n";
+			with_plots = false;
+		}
+	}
+
+	printf( "%-32s %6s %10s %10s %10s %14s %10s\n", "benchmark", "days", "rows", "median ms", "best ms", "rows/s", "MB/s" );
+	int result = 0;
+	for( auto const days : days_list ) {
+		try {
+			bench_size( context, days, seed, with_plots, 0 != vm.count( "keep" ) );
+		} catch( ::std::exception const & ex ) {
+			::std::cerr << days << " days: " << ex.what( ) << '\n';
+			result = 1;
+		}
+	}
+	if( with_plots ) {
+		wxEntryCleanup( );
+	}
+	return result;
+}
+
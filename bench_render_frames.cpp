@@ -0,0 +1,294 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <atomic>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include <wx/dcmemory.h>
+#include <wx/init.h>
+#include <wx/wx.h>
+
+#include "allocation_tracker.h"
+#include "bench_stats.h"
+#include "carelink_generator.h"
+#include "defs.h"
+#include "panel_average_basal.h"
+#include "panel_data_plot.h"
+#include "panel_generic_plot.h"
+#include "pump_data_analysis.h"
+#include "text_metrics.h"
+
+// ---------------------------------------------------------------------------
+// Frame times of replaying display lists into an offscreen wxMemoryDC, the
+// paint path of every plot window without the window
+// ---------------------------------------------------------------------------
+
+namespace {
+#if !TRACK_ALLOCATIONS
+	// Every allocation of the process is counted, frames are measured by the difference
+	::std::atomic<uint64_t> s_allocations( 0 );
+	::std::atomic<uint64_t> s_allocated_bytes( 0 );
+#endif
+
+	struct allocation_count_t {
+		uint64_t count;
+		uint64_t bytes;
+
+		static allocation_count_t now( ) {
+#if TRACK_ALLOCATIONS
+			// The tracker has replaced operator new already, add up its phases
+			allocation_count_t result{ 0, 0 };
+			for( auto const & phase : daw::phase_allocations( ) ) {
+				result.count += phase.allocations;
+				result.bytes += phase.bytes_allocated;
+			}
+			return result;
+#else
+			return allocation_count_t{ s_allocations.load( ::std::memory_order_relaxed ), s_allocated_bytes.load( ::std::memory_order_relaxed ) };
+#endif
+		}
+
+		allocation_count_t operator-( allocation_count_t const & rhs ) const {
+			return allocation_count_t{ count - rhs.count, bytes - rhs.bytes };
+		}
+	};	// allocation_count_t
+}	// namespace anonymous
+
+#if !TRACK_ALLOCATIONS
+void * operator new( size_t size ) {
+	s_allocations.fetch_add( 1, ::std::memory_order_relaxed );
+	s_allocated_bytes.fetch_add( size, ::std::memory_order_relaxed );
+	if( auto const result = ::std::malloc( 0 == size ? 1 : size ) ) {
+		return result;
+	}
+	throw ::std::bad_alloc( );
+}
+
+void * operator new[]( size_t size ) {
+	return ::operator new( size );
+}
+
+void operator delete( void * ptr ) noexcept {
+	::std::free( ptr );
+}
+
+void operator delete[]( void * ptr ) noexcept {
+	::std::free( ptr );
+}
+
+void operator delete( void * ptr, size_t ) noexcept {
+	::std::free( ptr );
+}
+
+void operator delete[]( void * ptr, size_t ) noexcept {
+	::std::free( ptr );
+}
+#endif
+
+namespace {
+	using namespace daw::pumpdataanalysis;
+
+	struct view_t {
+		::std::string name;
+		::std::function<void( PanelGenericPlotter & )> build;
+	};	// view_t
+
+	struct frame_options_t {
+		size_t frames = 200;
+		size_t warmup_frames = 5;
+		size_t builds = 10;
+	};	// frame_options_t
+
+	void bench_view( view_t const & view, ::std::vector<wxSize> const & sizes, frame_options_t const & options, ::std::shared_ptr<text_metrics_t const> const & metrics ) {
+		using clock_t = ::std::chrono::steady_clock;
+
+		// Building the display list, what async_plot_t does off the UI thread
+		::std::vector<double> build_times;
+		allocation_count_t build_allocations{ 0, 0 };
+		::std::unique_ptr<PanelGenericPlotter> gen_plot;
+		for( size_t n = 0; n < options.builds; ++n ) {
+			gen_plot.reset( new PanelGenericPlotter( ) );
+			gen_plot->set_text_metrics( metrics );
+			auto const allocations_before = allocation_count_t::now( );
+			auto const start = clock_t::now( );
+			view.build( *gen_plot );
+			build_times.push_back( ::std::chrono::duration<double>( clock_t::now( ) - start ).count( ) );
+			build_allocations = allocation_count_t::now( ) - allocations_before;
+		}
+		auto const build = daw::bench::summarize( build_times );
+		printf( "%-14s %11s %8llu %9.3f %9.3f %9.3f %9.3f %9llu %11llu  (build, %llu KiB)\n", view.name.c_str( ), "-", static_cast<unsigned long long>(gen_plot->action_count( )),
+			build.min * 1000.0, build.median * 1000.0, build.p95 * 1000.0, build.max * 1000.0,
+			static_cast<unsigned long long>(build_allocations.count), static_cast<unsigned long long>(build_allocations.bytes), static_cast<unsigned long long>(gen_plot->footprint( ) / 1024) );
+
+		// Replaying it, what every paint event does
+		for( auto const & size : sizes ) {
+			wxBitmap bitmap( size.GetWidth( ), size.GetHeight( ) );
+			wxMemoryDC dc( bitmap );
+			for( size_t n = 0; n < options.warmup_frames; ++n ) {
+				dc.SetBackground( *wxWHITE_BRUSH );
+				dc.Clear( );
+				gen_plot->plot( dc, size );
+			}
+			::std::vector<double> frame_times;
+			frame_times.reserve( options.frames );
+			auto const allocations_before = allocation_count_t::now( );
+			for( size_t n = 0; n < options.frames; ++n ) {
+				auto const start = clock_t::now( );
+				dc.SetBackground( *wxWHITE_BRUSH );
+				dc.Clear( );
+				gen_plot->plot( dc, size );
+				frame_times.push_back( ::std::chrono::duration<double>( clock_t::now( ) - start ).count( ) );
+			}
+			// frame_times had its room reserved, so everything counted here came from painting
+			auto const allocations = allocation_count_t::now( ) - allocations_before;
+			auto const frames = static_cast<double>(options.frames);
+			auto const stats = daw::bench::summarize( ::std::move( frame_times ) );
+			char size_text[32];
+			snprintf( size_text, sizeof( size_text ), "%dx%d", size.GetWidth( ), size.GetHeight( ) );
+			printf( "%-14s %11s %8llu %9.3f %9.3f %9.3f %9.3f %9.1f %11.0f\n", view.name.c_str( ), size_text, static_cast<unsigned long long>(gen_plot->action_count( )),
+				stats.min * 1000.0, stats.median * 1000.0, stats.p95 * 1000.0, stats.max * 1000.0,
+				static_cast<double>(allocations.count) / frames, static_cast<double>(allocations.bytes) / frames );
+		}
+		fflush( stdout );
+	}
+
+	wxSize parse_size( ::std::string const & text ) {
+		int width = 0;
+		int height = 0;
+		if( 2 != sscanf( text.c_str( ), "%dx%d", &width, &height ) || width <= 0 || height <= 0 ) {
+			throw ::std::runtime_error( "Sizes are WIDTHxHEIGHT, not '" + text + "'" );
+		}
+		return wxSize( width, height );
+	}
+}	// namespace anonymous
+
+int main( int argc, char ** argv ) {
+	namespace po = boost::program_options;
+
+	frame_options_t options;
+	::std::vector<::std::string> size_texts;
+	size_t days = 90;
+	::std::string filter;
+
+	po::options_description desc( "Usage: mm_history_render_bench [options]\nOptions" );
+	desc.add_options( )
+		( "help,h", "Show this message" )
+		( "size,s", po::value<::std::vector<::std::string>>( &size_texts )->multitoken( ), "Frame sizes as WIDTHxHEIGHT, may be repeated.  Default 400x300 800x600 1280x720 1920x1080 3840x2160" )
+		( "frames,n", po::value<size_t>( &options.frames )->default_value( options.frames ), "Frames timed per view and size" )
+		( "days,d", po::value<size_t>( &days )->default_value( days ), "Days of generated data" )
+		( "filter", po::value<::std::string>( &filter ), "Only views whose name contains this" );
+
+	::std::vector<wxSize> sizes;
+	try {
+		po::variables_map vm;
+		po::store( po::parse_command_line( argc, argv, desc ), vm );
+		po::notify( vm );
+		if( vm.count( "help" ) ) {
+			::std::cout << desc << '\n';
+			return 0;
+		}
+		if( size_texts.empty( ) ) {
+			size_texts = { "400x300", "800x600", "1280x720", "1920x1080", "3840x2160" };
+		}
+		for( auto const & text : size_texts ) {
+			sizes.push_back( parse_size( text ) );
+		}
+	} catch( ::std::exception const & ex ) {
+		::std::cerr << ex.what( ) << '\n' << desc << '\n';
+		return 1;
+	}
+
+	// Fonts, pens and bitmaps need the GUI toolkit, but no window is ever shown
+	wxApp::SetInstance( new wxApp( ) );
+	if( !wxEntryStart( argc, argv ) ) {
+		::std::cerr << "Could not start wxWidgets\n";
+		return 1;
+	}
+
+	int result = 0;
+	try {
+		carelink_generator_options_t generator_options;
+		generator_options.days = days;
+		auto const filename = (boost::filesystem::temp_directory_path( ) / boost::filesystem::unique_path( "carelink_%%%%%%%%.csv" )).string( );
+		generate_carelink_csv( filename, generator_options );
+		auto const data = load_pump_data( filename, []( ::std::string ) { } );
+		boost::system::error_code ec;
+		boost::filesystem::remove( filename, ec );
+
+		auto const tests = find_basal_tests( data );
+		auto const bins = aggregate_basal_tests( data, tests );
+		auto const & ts_col = data["Timestamp"];
+		size_t month_last = 0;
+		auto const month_end = ts_col[0].timestamp( ) + boost::gregorian::days( 30 );
+		while( month_last + 1 < ts_col.size( ) && ts_col[month_last + 1].timestamp( ) < month_end ) {
+			++month_last;
+		}
+		// The longest test is the worst case of the basal test pages
+		::std::pair<size_t, size_t> longest_test{ 0, 0 };
+		for( auto const & test : tests ) {
+			if( test.second - test.first > longest_test.second - longest_test.first ) {
+				longest_test = test;
+			}
+		}
+
+		graph_config_t graph_config;
+		graph_config.axis_title_y = "mmol/L";
+		::std::vector<view_t> views;
+		if( !tests.empty( ) ) {
+			views.push_back( view_t{ "basal_test", [&]( PanelGenericPlotter & gen_plot ) {
+				build_basal_test_plot( gen_plot, data, longest_test.first, longest_test.second, graph_config );
+			} } );
+		}
+		views.push_back( view_t{ "sensor_month", [&]( PanelGenericPlotter & gen_plot ) {
+			build_basal_test_plot( gen_plot, data, 0, month_last, graph_config );
+		} } );
+		views.push_back( view_t{ "average_day", [&]( PanelGenericPlotter & gen_plot ) {
+			build_average_basal_plot( gen_plot, bins, graph_config );
+		} } );
+
+		auto const metrics = text_metrics_t::for_graphs( );
+		printf( "%-14s %11s %8s %9s %9s %9s %9s %9s %11s\n", "view", "size", "actions", "min ms", "median ms", "p95 ms", "max ms", "allocs", "bytes" );
+		for( auto const & view : views ) {
+			if( filter.empty( ) || ::std::string::npos != view.name.find( filter ) ) {
+				bench_view( view, sizes, options, metrics );
+			}
+		}
+	} catch( ::std::exception const & ex ) {
+		::std::cerr << ex.what( ) << '\n';
+		result = 1;
+	}
+	wxEntryCleanup( );
+	return result;
+}
+
@@ -0,0 +1,68 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <chrono>
+
+#include "bench_stats.h"
+
+namespace daw {
+	namespace bench {
+		sample_stats_t summarize( ::std::vector<double> samples ) {
+			sample_stats_t result;
+			if( samples.empty( ) ) {
+				return result;
+			}
+			::std::sort( samples.begin( ), samples.end( ) );
+			result.count = samples.size( );
+			result.min = samples.front( );
+			result.max = samples.back( );
+			result.median = samples[samples.size( ) / 2];
+			result.p95 = samples[::std::min( samples.size( ) - 1, (samples.size( ) * 95 + 99) / 100 - 1 )];
+			double sum = 0.0;
+			for( auto const sample : samples ) {
+				sum += sample;
+			}
+			result.mean = sum / static_cast<double>(samples.size( ));
+			return result;
+		}
+
+		::std::vector<double> time_runs( run_limits_t const & limits, ::std::function<void( )> const & setup, ::std::function<void( )> const & body ) {
+			using clock_t = ::std::chrono::steady_clock;
+			::std::vector<double> result;
+			double total = 0.0;
+			while( result.size( ) < limits.max_runs && (result.size( ) < limits.min_runs || total < limits.min_seconds) ) {
+				if( setup ) {
+					setup( );
+				}
+				auto const start = clock_t::now( );
+				body( );
+				auto const seconds = ::std::chrono::duration<double>( clock_t::now( ) - start ).count( );
+				result.push_back( seconds );
+				total += seconds;
+			}
+			return result;
+		}
+	}	// namespace bench
+}	// namespace daw
+
@@ -0,0 +1,63 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <utility>
+
+#include "cancellation.h"
+
+namespace daw {
+	operation_cancelled_t::operation_cancelled_t( ):
+			::std::runtime_error( "Operation cancelled" ) { }
+
+	cancellation_token_t::cancellation_token_t( ::std::shared_ptr<::std::atomic<bool> const> flag ):
+			m_flag( ::std::move( flag ) ) { }
+
+	bool cancellation_token_t::is_cancelled( ) const {
+		return m_flag && m_flag->load( ::std::memory_order_relaxed );
+	}
+
+	void cancellation_token_t::throw_if_cancelled( ) const {
+		if( is_cancelled( ) ) {
+			throw operation_cancelled_t( );
+		}
+	}
+
+	cancellation_source_t::cancellation_source_t( ):
+			m_flag( ::std::make_shared<::std::atomic<bool>>( false ) ) { }
+
+	cancellation_token_t cancellation_source_t::token( ) const {
+		return cancellation_token_t( m_flag );
+	}
+
+	void cancellation_source_t::cancel( ) {
+		// A moved from source has no flag and nothing to cancel
+		if( m_flag ) {
+			m_flag->store( true, ::std::memory_order_relaxed );
+		}
+	}
+
+	bool cancellation_source_t::is_cancelled( ) const {
+		return m_flag && m_flag->load( ::std::memory_order_relaxed );
+	}
+}	// namespace daw
+
@@ -0,0 +1,267 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "carelink_generator.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		namespace {
+			/// splitmix64, std engines are portable but std distributions are not
+			class random_t final {
+				uint64_t m_state;
+			public:
+				explicit random_t( uint64_t seed ):
+						m_state( seed ) { }
+
+				uint64_t next( ) {
+					auto z = (m_state += 0x9E3779B97F4A7C15ULL);
+					z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+					z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+					return z ^ (z >> 31);
+				}
+
+				/// [0, 1)
+				double uniform( ) {
+					return static_cast<double>(next( ) >> 11) * (1.0 / 9007199254740992.0);
+				}
+
+				double uniform( double low, double high ) {
+					return low + (high - low) * uniform( );
+				}
+
+				/// [low, high]
+				int integer( int low, int high ) {
+					return low + static_cast<int>(next( ) % static_cast<uint64_t>(high - low + 1));
+				}
+
+				bool chance( double probability ) {
+					return uniform( ) < probability;
+				}
+
+				/// Roughly normal, mean 0 and standard deviation 1
+				double normal( ) {
+					return (uniform( ) + uniform( ) + uniform( ) + uniform( ) - 2.0) * 1.7320508075688772;
+				}
+			};	// random_t
+
+			enum class event_kind_t { bg_reading, wizard, bolus, meal_marker, temp_basal };
+
+			struct event_t {
+				int second;	// Of the day
+				event_kind_t kind;
+				double value;	// mmol/L, grams, units or percent by kind
+			};	// event_t
+
+			struct meal_t {
+				int minute;	// Since the start, for the glucose model
+				double carbs;
+			};	// meal_t
+
+			char const * const s_header = "Index,Date,Time,Timestamp,BG Reading (mmol/L),Temp Basal Amount (U/h),Temp Basal Type,Temp Basal Duration (hh:mm:ss),Bolus Type,Bolus Volume Selected (U),Bolus Volume Delivered (U),BWZ Carb Input (grams),Sensor Glucose (mmol/L),ISIG Value,Raw-Type,Raw-Values,Raw-ID,Raw-Upload ID,Raw-Seq Num,Raw-Device Type\n";
+			size_t const s_preamble_rows = 11;
+
+			class writer_t final {
+				::std::ostream & m_out;
+				carelink_generator_result_t m_result;
+				char m_date[16];
+				char m_line[512];
+
+				void write( int len ) {
+					if( len < 0 || static_cast<size_t>(len) >= sizeof( m_line ) ) {
+						throw ::std::runtime_error( "Generated row does not fit the buffer" );
+					}
+					m_out.write( m_line, len );
+					m_result.bytes += static_cast<size_t>(len);
+				}
+			public:
+				explicit writer_t( ::std::ostream & out ):
+						m_out( out ),
+						m_result( ),
+						m_date( ),
+						m_line( ) { }
+
+				void preamble( ) {
+					char const * const lines[s_preamble_rows] = { "Last Name,Synthetic", "First Name,Patient", "Patient ID,", "Start Date,", "End Date,", "Device,Paradigm Revel - 723", "Serial Number,0000000", "Report Created,", ",", "-------,", "Generated for benchmarking," };
+					for( auto const line : lines ) {
+						write( snprintf( m_line, sizeof( m_line ), "%s\n", line ) );
+					}
+					write( snprintf( m_line, sizeof( m_line ), "%s", s_header ) );
+				}
+
+				void set_date( boost::gregorian::date const & day ) {
+					snprintf( m_date, sizeof( m_date ), "%02d/%02d/%02d", static_cast<int>(day.day( )), static_cast<int>(day.month( )), static_cast<int>(day.year( ) % 100) );
+				}
+
+				void empty_row( ) {
+					write( snprintf( m_line, sizeof( m_line ), "%llu,,,,,,,,,,,,,,,,,,,\n", static_cast<unsigned long long>(m_result.rows++) ) );
+				}
+
+				/// columns holds the 12 columns from BG Reading through Raw-Values, already comma separated
+				void row( int second, char const * columns ) {
+					auto const index = m_result.rows++;
+					auto const h = second / 3600;
+					auto const m = (second / 60) % 60;
+					auto const s = second % 60;
+					write( snprintf( m_line, sizeof( m_line ), "%llu,%s,%02d:%02d:%02d,%s %02d:%02d:%02d,%s,%llu,12345678,%llu,Paradigm Revel - 723\n",
+						static_cast<unsigned long long>(index), m_date, h, m, s, m_date, h, m, s, columns,
+						static_cast<unsigned long long>(1000000000ULL + index * 7), static_cast<unsigned long long>(index % 65536) ) );
+				}
+
+				carelink_generator_result_t const & result( ) const {
+					return m_result;
+				}
+			};	// writer_t
+
+			void write_event( writer_t & writer, event_t const & event ) {
+				char columns[256];
+				switch( event.kind ) {
+				case event_kind_t::bg_reading:
+					snprintf( columns, sizeof( columns ), "%.1f,,,,,,,,,,BGReceived,\"AMOUNT=%d, ACTION_REQUESTOR=pump\"", event.value, static_cast<int>(event.value * 18.0) );
+					break;
+				case event_kind_t::wizard:
+					snprintf( columns, sizeof( columns ), ",,,,,,,%d,,,BolusWizardBolusEstimate,\"BG_INPUT=0, CARB_INPUT=%d, CARB_RATIO=10\"", static_cast<int>(event.value), static_cast<int>(event.value) );
+					break;
+				case event_kind_t::bolus:
+					snprintf( columns, sizeof( columns ), ",,,,Normal,%.1f,%.1f,,,,BolusNormal,\"AMOUNT=%.1f, CONCENTRATION=null, PROGRAMMED_AMOUNT=%.1f\"", event.value, event.value, event.value, event.value );
+					break;
+				case event_kind_t::meal_marker:
+					snprintf( columns, sizeof( columns ), ",,,,,,,,,,JournalEntryMealMarker,\"CARB_INPUT=%d\"", static_cast<int>(event.value) );
+					break;
+				case event_kind_t::temp_basal:
+					snprintf( columns, sizeof( columns ), ",%d,Percent,0%d:00:00,,,,,,,ChangeTempBasalPercent,\"PERCENT_OF_RATE=%d\"", static_cast<int>(event.value), 1 + static_cast<int>(event.value) % 4, static_cast<int>(event.value) );
+					break;
+				}
+				writer.row( event.second, columns );
+			}
+
+			/// Carbs raise glucose over about five hours, peaking after 45 minutes
+			double meal_effect( ::std::vector<meal_t> const & meals, int minute ) {
+				double result = 0.0;
+				for( auto const & meal : meals ) {
+					auto const dt = static_cast<double>(minute - meal.minute);
+					if( dt >= 0.0 && dt <= 300.0 ) {
+						result += meal.carbs / 30.0 * (dt / 45.0) * ::std::exp( 1.0 - dt / 45.0 );
+					}
+				}
+				return result;
+			}
+		}	// namespace anonymous
+
+		carelink_generator_result_t generate_carelink_csv( ::std::ostream & out, carelink_generator_options_t const & options ) {
+			random_t rng( options.seed );
+			writer_t writer( out );
+			writer.preamble( );
+
+			boost::gregorian::date const first_day( 2010, 1, 1 );
+			::std::vector<event_t> events;
+			::std::vector<meal_t> meals;
+			double noise = 0.0;
+			int gap_until = -1;	// Minute since the start the sensor reads again
+
+			for( size_t day_no = 0; day_no < options.days; ++day_no ) {
+				writer.set_date( first_day + boost::gregorian::days( static_cast<long>(day_no) ) );
+				auto const day_minute = static_cast<int>(day_no) * 1440;
+
+				events.clear( );
+				static int const meal_times[] = { 450, 750, 1110, 1290 };	// Breakfast, lunch, dinner, supper
+				for( size_t n = 0; n < options.meals_per_day; ++n ) {
+					auto const minute = meal_times[n % 4] + rng.integer( -45, 45 );
+					auto const second = minute * 60 + rng.integer( 0, 59 );
+					auto const carbs = static_cast<double>(rng.integer( 20, 90 ));
+					if( rng.chance( 0.5 ) ) {
+						events.push_back( event_t{ second - 60, event_kind_t::bg_reading, ::std::round( rng.uniform( 4.0, 11.0 ) * 10.0 ) / 10.0 } );
+					}
+					events.push_back( event_t{ second, event_kind_t::wizard, carbs } );
+					events.push_back( event_t{ second + 2, event_kind_t::bolus, ::std::round( carbs ) / 10.0 } );
+					if( rng.chance( options.meal_marker_chance ) ) {
+						events.push_back( event_t{ second + 30, event_kind_t::meal_marker, carbs } );
+					}
+					meals.push_back( meal_t{ day_minute + minute, carbs } );
+				}
+				if( rng.chance( options.temp_basal_chance ) ) {
+					events.push_back( event_t{ rng.integer( 0, 86399 ), event_kind_t::temp_basal, static_cast<double>(rng.integer( 5, 15 ) * 10) } );
+				}
+				::std::sort( events.begin( ), events.end( ), []( event_t const & a, event_t const & b ) {
+					return a.second < b.second;
+				} );
+				if( 0 != options.sensor_change_days && 0 == day_no % options.sensor_change_days && 0 != day_no ) {
+					gap_until = ::std::max( gap_until, day_minute + 9 * 60 + 120 );
+				}
+				// Meals more than a day old no longer matter
+				meals.erase( ::std::remove_if( meals.begin( ), meals.end( ), [day_minute]( meal_t const & meal ) {
+					return meal.minute < day_minute - 1440;
+				} ), meals.end( ) );
+
+				auto next_event = events.begin( );
+				for( int minute = 0; minute < 1440; minute += 5 ) {
+					auto const now = day_minute + minute;
+					while( events.end( ) != next_event && next_event->second <= minute * 60 ) {
+						write_event( writer, *next_event++ );
+					}
+					if( 0 == minute % 60 && rng.chance( options.gap_chance ) ) {
+						gap_until = ::std::max( gap_until, now + rng.integer( 15, 120 ) );
+					}
+					if( rng.chance( options.empty_row_chance ) ) {
+						writer.empty_row( );
+					}
+					noise = 0.9 * noise + 0.3 * rng.normal( );
+					if( now < gap_until ) {
+						continue;
+					}
+					auto const circadian = 1.2 * ::std::sin( 2.0 * 3.141592653589793 * static_cast<double>(minute - 240) / 1440.0 );
+					auto const glucose = ::std::min( ::std::max( 6.5 + circadian + meal_effect( meals, now ) + noise, 2.2 ), 22.2 );
+					auto const rounded = ::std::round( glucose * 10.0 ) / 10.0;
+					auto const isig = rounded * 3.1 + 1.5;
+					char columns[256];
+					snprintf( columns, sizeof( columns ), ",,,,,,,,%.1f,%.2f,GlucoseSensorData,\"AMOUNT=%d, ISIG=%.2f, VCNTR=0, BACKFILL_INDICATOR=null\"", rounded, isig, static_cast<int>(rounded * 18.0), isig );
+					writer.row( minute * 60, columns );
+				}
+				while( events.end( ) != next_event ) {
+					write_event( writer, *next_event++ );
+				}
+			}
+			return writer.result( );
+		}
+
+		carelink_generator_result_t generate_carelink_csv( ::std::string const & filename, carelink_generator_options_t const & options ) {
+			::std::ofstream out( filename, ::std::ios::binary );
+			if( !out ) {
+				throw ::std::runtime_error( "Could not create " + filename );
+			}
+			auto const result = generate_carelink_csv( out, options );
+			if( !out.flush( ) ) {
+				throw ::std::runtime_error( "Could not write " + filename );
+			}
+			return result;
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
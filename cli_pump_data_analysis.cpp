@@ -0,0 +1,172 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/program_options.hpp>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "analysis_report.h"
+#include "task_pool.h"
+#include "trace.h"
+
+// ---------------------------------------------------------------------------
+// Headless analysis of many Carelink exports, for running unattended
+// ---------------------------------------------------------------------------
+
+namespace {
+	boost::posix_time::ptime parse_time_option( ::std::string const & value, char const * name ) {
+		if( value.empty( ) ) {
+			return boost::posix_time::ptime( );
+		}
+		try {
+			// A date alone means midnight
+			return value.find( ' ' ) == ::std::string::npos && value.find( 'T' ) == ::std::string::npos ? boost::posix_time::ptime( boost::gregorian::from_string( value ) ) : boost::posix_time::time_from_string( value );
+		} catch( ::std::exception const & ) {
+			throw ::std::runtime_error( ::std::string( "--" ) + name + " must be YYYY-MM-DD or YYYY-MM-DD HH:MM:SS, not '" + value + "'" );
+		}
+	}
+}	// namespace anonymous
+
+int main( int argc, char ** argv ) {
+	namespace po = boost::program_options;
+	using namespace daw::pumpdataanalysis;
+
+	analysis_options_t options;
+	::std::vector<::std::string> inputs;
+	::std::string from;
+	::std::string to;
+	::std::string format;
+	::std::string output;
+	::std::string trace_file;
+	size_t memory_budget_mib = 0;
+
+	po::options_description visible( "Usage: mm_history_cli [options] export.csv...\nOptions" );
+	visible.add_options( )
+		( "help,h", "Show this message" )
+		( "from", po::value<::std::string>( &from ), "Only basal tests starting at or after this time" )
+		( "to", po::value<::std::string>( &to ), "Only basal tests ending at or before this time" )
+		( "format,f", po::value<::std::string>( &format )->default_value( "json" ), "json or csv" )
+		( "output,o", po::value<::std::string>( &output ), "File to write, standard output when not given" )
+		( "settle-hours", po::value<int>( &options.detector.settle_hours )->default_value( options.detector.settle_hours ), "Hours after food or insulin before a test can start" )
+		( "min-minutes", po::value<int>( &options.detector.min_minutes )->default_value( options.detector.min_minutes ), "Shortest basal test kept" )
+		( "max-hours", po::value<int>( &options.detector.max_hours )->default_value( options.detector.max_hours ), "Basal tests this long or longer are dropped" )
+		( "max-rise", po::value<daw::data::real_t>( &options.detector.max_rise )->default_value( options.detector.max_rise ), "Largest change in mmol/L per hour over a test" )
+		( "no-derivatives", "Leave out the average rate of change" )
+		( "trace", po::value<::std::string>( &trace_file ), "Write a Chrome trace of the run's stages to this file" )
+		( "memory-report", "Write the memory held by each file's table to standard error" )
+		( "memory-budget", po::value<size_t>( &memory_budget_mib ), "MiB of estimated memory the files being loaded at once may use" );
+
+	po::options_description hidden;
+	hidden.add_options( )
+		( "input", po::value<::std::vector<::std::string>>( &inputs ), "Carelink CSV exports" );
+
+	po::options_description all;
+	all.add( visible ).add( hidden );
+	po::positional_options_description positional;
+	positional.add( "input", -1 );
+
+	try {
+		po::variables_map vm;
+		po::store( po::command_line_parser( argc, argv ).options( all ).positional( positional ).run( ), vm );
+		po::notify( vm );
+		if( vm.count( "help" ) || inputs.empty( ) ) {
+			::std::cout << visible << '\n';
+			return inputs.empty( ) && !vm.count( "help" ) ? 1 : 0;
+		}
+		if( "json" != format && "csv" != format ) {
+			throw ::std::runtime_error( "--format must be json or csv" );
+		}
+		options.from = parse_time_option( from, "from" );
+		options.to = parse_time_option( to, "to" );
+		options.derivatives = 0 == vm.count( "no-derivatives" );
+		options.measure_memory = 0 != vm.count( "memory-report" );
+		if( 0 != memory_budget_mib ) {
+			daw::task_pool_t::get( ).set_memory_budget( memory_budget_mib * 1024 * 1024 );
+		}
+	} catch( ::std::exception const & ex ) {
+		::std::cerr << ex.what( ) << '\n' << visible << '\n';
+		return 1;
+	}
+
+	if( !trace_file.empty( ) ) {
+		daw::set_trace_thread_name( "Main" );
+		daw::set_trace_enabled( true );
+	}
+	// Written however the run ends, a failed run is as worth looking at as a slow one
+	auto const write_trace = [&trace_file]( ) {
+		if( trace_file.empty( ) ) {
+			return;
+		}
+		try {
+			daw::write_chrome_trace( trace_file );
+		} catch( ::std::exception const & ex ) {
+			::std::cerr << ex.what( ) << '\n';
+		}
+	};
+
+	try {
+		auto const reports = analyse_files( inputs, options );
+		write_trace( );
+		::std::ofstream out_file;
+		if( !output.empty( ) ) {
+			out_file.open( output );
+			if( !out_file ) {
+				::std::cerr << "Could not open " << output << " for writing\n";
+				return 1;
+			}
+		}
+		auto & out = output.empty( ) ? ::std::cout : out_file;
+		if( "csv" == format ) {
+			write_reports_csv( out, reports );
+		} else {
+			write_reports_json( out, reports );
+		}
+		if( options.measure_memory ) {
+			::std::vector<memory_report_t> memory_reports;
+			for( auto const & report : reports ) {
+				if( report.error.empty( ) ) {
+					memory_reports.push_back( report.memory );
+				}
+			}
+			write_memory_report( ::std::cerr, memory_reports );
+		}
+		size_t failed = 0;
+		for( auto const & report : reports ) {
+			if( !report.error.empty( ) ) {
+				::std::cerr << report.filename << ": " << report.error << '\n';
+				++failed;
+			}
+		}
+		// Partial results are still written, the exit code tells a script some files failed
+		return 0 == failed ? 0 : 2;
+	} catch( ::std::exception const & ex ) {
+		write_trace( );
+		::std::cerr << "Unrecoverable error: " << ex.what( ) << '\n';
+		return 1;
+	}
+}
+
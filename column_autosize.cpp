@@ -0,0 +1,145 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+#include <daw/csv_helper/data_common.h>
+
+#include "column_autosize.h"
+
+namespace daw {
+	namespace data {
+		::std::vector<size_t> autosize_sample_rows( size_t row_count, column_autosize_options_t const & options ) {
+			::std::vector<size_t> result;
+			auto const head = ::std::min( options.head_rows, row_count );
+			auto const tail_first = ::std::max( head, row_count - ::std::min( options.tail_rows, row_count ) );
+			for( size_t row = 0; row < head; ++row ) {
+				result.push_back( row );
+			}
+			auto const middle = tail_first - head;
+			if( middle > 0 && options.random_rows > 0 ) {
+				// Fixed seed so the same file always gets the same widths
+				::std::minstd_rand rng( 5489u );
+				auto const strata = ::std::min( options.random_rows, middle );
+				for( size_t n = 0; n < strata; ++n ) {
+					auto const first = head + (middle * n) / strata;
+					auto const last = head + (middle * (n + 1)) / strata;
+					result.push_back( first + rng( ) % (last - first) );
+				}
+			}
+			for( auto row = tail_first; row < row_count; ++row ) {
+				result.push_back( row );
+			}
+			result.erase( ::std::unique( result.begin( ), result.end( ) ), result.end( ) );
+			return result;
+		}
+
+		namespace {
+			/// Rows of column most likely to be the widest that a random sample would miss: the longest text
+			/// and the smallest and largest numbers
+			void add_extreme_rows( daw::data::compact_table_t::value_type const & column, size_t count, ::std::vector<size_t> & rows ) {
+				if( 0 == count || column.size( ) == 0 ) {
+					return;
+				}
+				::std::vector<::std::pair<size_t, size_t>> longest;	// (length, row) smallest first
+				size_t min_row = column.size( );
+				size_t max_row = column.size( );
+				for( size_t row = 0; row < column.size( ); ++row ) {
+					auto const & cell = column[row];
+					switch( cell.type( ) ) {
+					case DataCellType::string: {
+						auto const len = cell.string( ).size( );
+						if( longest.size( ) < count || len > longest.front( ).first ) {
+							if( longest.size( ) == count ) {
+								::std::pop_heap( longest.begin( ), longest.end( ), ::std::greater<::std::pair<size_t, size_t>>( ) );
+								longest.pop_back( );
+							}
+							longest.emplace_back( len, row );
+							::std::push_heap( longest.begin( ), longest.end( ), ::std::greater<::std::pair<size_t, size_t>>( ) );
+						}
+						break;
+					}
+					case DataCellType::real:
+						if( column.size( ) == min_row || cell.real( ) < column[min_row].real( ) ) {
+							min_row = row;
+						}
+						if( column.size( ) == max_row || cell.real( ) > column[max_row].real( ) ) {
+							max_row = row;
+						}
+						break;
+					default:
+						break;
+					}
+				}
+				for( auto const & item : longest ) {
+					rows.push_back( item.second );
+				}
+				if( column.size( ) != min_row ) {
+					rows.push_back( min_row );
+					rows.push_back( max_row );
+				}
+			}
+		}	// namespace anonymous
+
+		task_future_t<::std::vector<int>> start_column_autosize( ::std::shared_ptr<void const> keep_alive, daw::data::compact_table_t const & table, cell_to_text_t cell_to_text, ::std::shared_ptr<daw::pumpdataanalysis::text_metrics_t const> metrics, daw::pumpdataanalysis::text_metrics_t::font_key_t cell_font, daw::pumpdataanalysis::text_metrics_t::font_key_t label_font, cancellation_token_t cancelled, column_autosize_options_t options ) {
+			return task_pool_t::get( ).submit( task_priority_t::background, [keep_alive = ::std::move( keep_alive ), &table, cell_to_text = ::std::move( cell_to_text ), metrics = ::std::move( metrics ), cell_font, label_font, cancelled = ::std::move( cancelled ), options]( ) {
+				::std::vector<int> result;
+				result.reserve( table.size( ) );
+				auto const sample = autosize_sample_rows( table.empty( ) ? 0 : table[0].size( ), options );
+				::std::vector<size_t> extremes;
+				for( size_t col = 0; col < table.size( ); ++col ) {
+					cancelled.throw_if_cancelled( );
+					auto const & column = table[col];
+					auto width = metrics->get_text_width( label_font, column.header( ) );
+					auto measure = [&]( size_t row ) {
+						auto const & cell = column[row];
+						if( !cell.empty( ) ) {
+							width = ::std::max( width, metrics->get_text_width( cell_font, cell_to_text( cell ) ) );
+						}
+					};
+					// Parsing a lazy column for its width would undo keeping it lazy.  Only its head and tail are
+					// parsed here, other rows are measured if something else has parsed them already
+					auto const lazy = column.is_lazy( );
+					auto const tail_first = column.size( ) - ::std::min( options.tail_rows, column.size( ) );
+					for( auto const row : sample ) {
+						if( !lazy || row < options.head_rows || row >= tail_first || column.is_decoded( row ) ) {
+							measure( row );
+						}
+					}
+					if( !lazy ) {
+						extremes.clear( );
+						add_extreme_rows( column, options.extreme_rows, extremes );
+						for( auto const row : extremes ) {
+							measure( row );
+						}
+					}
+					result.push_back( ::std::min( ::std::max( width + options.padding, options.min_width ), options.max_width ) );
+				}
+				return result;
+			} );
+		}
+	}	// namespace data
+}	// namespace daw
+
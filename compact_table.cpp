@@ -0,0 +1,295 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <stdexcept>
+#include <utility>
+
+#include "compact_table.h"
+
+namespace daw {
+	namespace data {
+		::std::vector<dense_column_t> to_dense_columns( DataTable & table ) {
+			::std::vector<dense_column_t> result;
+			result.reserve( table.size( ) );
+			for( auto & column : table ) {
+				dense_column_t dense;
+				dense.header = column.header( );
+				dense.cells.reserve( column.size( ) );
+				for( auto & cell : column ) {
+					dense.cells.push_back( ::std::move( cell ) );
+				}
+				result.push_back( ::std::move( dense ) );
+			}
+			return result;
+		}
+
+		column_view_t::column_view_t( dense_column_t const & dense, sparse_column_t const * sparse, ::std::vector<packed_cell_t> const * packed, lazy_column_t const * lazy, string_arena_t const & arena ):
+				m_dense( &dense ),
+				m_sparse( sparse ),
+				m_packed( packed ),
+				m_arena( &arena ),
+				m_lazy( lazy ) { }
+
+		size_t column_view_t::size( ) const {
+			if( nullptr != m_packed ) {
+				return m_packed->size( );
+			}
+			if( nullptr != m_lazy ) {
+				return m_lazy->size( );
+			}
+			return nullptr == m_sparse ? m_dense->cells.size( ) : m_sparse->size( );
+		}
+
+		bool column_view_t::empty( ) const {
+			return 0 == size( );
+		}
+
+		::std::string const & column_view_t::header( ) const {
+			return m_dense->header;
+		}
+
+		bool column_view_t::is_sparse( ) const {
+			return nullptr != m_sparse;
+		}
+
+		bool column_view_t::is_packed( ) const {
+			return nullptr != m_packed;
+		}
+
+		bool column_view_t::is_lazy( ) const {
+			return nullptr != m_lazy;
+		}
+
+		bool column_view_t::is_decoded( size_t row ) const {
+			return nullptr == m_lazy || m_lazy->is_decoded( row );
+		}
+
+		size_t column_view_t::cell_size( ) const {
+			if( nullptr != m_packed ) {
+				return sizeof( packed_cell_t );
+			}
+			if( nullptr != m_lazy ) {
+				return sizeof( lazy_column_t::value_type );
+			}
+			return nullptr == m_sparse ? sizeof( DataCell ) : sizeof( sparse_column_t::value_type );
+		}
+
+		size_t column_view_t::footprint( ) const {
+			if( nullptr != m_packed ) {
+				return m_packed->capacity( ) * sizeof( packed_cell_t );
+			}
+			if( nullptr != m_lazy ) {
+				return m_lazy->footprint( );
+			}
+			return nullptr == m_sparse ? m_dense->cells.capacity( ) * sizeof( DataCell ) : m_sparse->footprint( );
+		}
+
+		column_view_t::const_iterator column_view_t::begin( ) const {
+			return const_iterator( this, 0 );
+		}
+
+		column_view_t::const_iterator column_view_t::end( ) const {
+			return const_iterator( this, size( ) );
+		}
+
+		constexpr double compact_table_t::default_max_sparse_density;
+
+		compact_table_t::compact_table_t( ):
+				m_dense( ),
+				m_sparse( ),
+				m_packed( ),
+				m_arena( ),
+				m_lazy( ),
+				m_views( ) { }
+
+		compact_table_t::compact_table_t( DataTable table, ::std::function<bool( ::std::string const & header )> keep_dense, double max_sparse_density ):
+				compact_table_t( to_dense_columns( table ), ::std::move( keep_dense ), max_sparse_density ) { }
+
+		compact_table_t::compact_table_t( ::std::vector<dense_column_t> columns, ::std::function<bool( ::std::string const & header )> keep_dense, double max_sparse_density ):
+				compact_table_t( ::std::move( columns ), ::std::vector<::std::unique_ptr<lazy_column_t const>>( ), ::std::move( keep_dense ), max_sparse_density ) { }
+
+		compact_table_t::compact_table_t( ::std::vector<dense_column_t> columns, ::std::vector<::std::unique_ptr<lazy_column_t const>> lazy, ::std::function<bool( ::std::string const & header )> keep_dense, double max_sparse_density ):
+				m_dense( ::std::move( columns ) ),
+				m_sparse( ),
+				m_packed( ),
+				m_arena( ),
+				m_lazy( ::std::move( lazy ) ),
+				m_views( ) {
+
+			m_sparse.reserve( m_dense.size( ) );
+			m_packed.resize( m_dense.size( ) );
+			m_lazy.resize( m_dense.size( ) );
+			for( size_t col = 0; col < m_dense.size( ); ++col ) {
+				auto & cells = m_dense[col].cells;
+				if( m_lazy[col] || (keep_dense && keep_dense( m_dense[col].header )) ) {
+					m_sparse.emplace_back( nullptr );
+					continue;
+				}
+				if( sparse_column_t::density( cells ) >= max_sparse_density ) {
+					m_sparse.emplace_back( nullptr );
+#if PACK_VARIANT
+					auto & packed = m_packed[col];
+					packed.reserve( cells.size( ) );
+					for( size_t row = 0; row < cells.size( ); ++row ) {
+						packed.emplace_back( cells[row], m_arena );
+					}
+#else
+					continue;
+#endif
+				} else {
+					m_sparse.emplace_back( new sparse_column_t( cells, m_arena ) );
+				}
+				cells.clear( );
+				cells.shrink_to_fit( );
+			}
+			m_arena.shrink_to_fit( );
+			bind_views( );
+		}
+
+		compact_table_t::compact_table_t( compact_table_t && other ):
+				m_dense( ::std::move( other.m_dense ) ),
+				m_sparse( ::std::move( other.m_sparse ) ),
+				m_packed( ::std::move( other.m_packed ) ),
+				m_arena( ::std::move( other.m_arena ) ),
+				m_lazy( ::std::move( other.m_lazy ) ),
+				m_views( ) {
+
+			// The views point at columns of the table they were made for
+			bind_views( );
+			other.bind_views( );
+		}
+
+		compact_table_t & compact_table_t::operator=( compact_table_t && rhs ) {
+			if( this != &rhs ) {
+				m_dense = ::std::move( rhs.m_dense );
+				m_sparse = ::std::move( rhs.m_sparse );
+				m_packed = ::std::move( rhs.m_packed );
+				m_arena = ::std::move( rhs.m_arena );
+				m_lazy = ::std::move( rhs.m_lazy );
+				bind_views( );
+				rhs.bind_views( );
+			}
+			return *this;
+		}
+
+		void compact_table_t::bind_views( ) {
+			m_views.clear( );
+			// A moved from table may have lost its columns, but not its sparse ones
+			m_sparse.resize( m_dense.size( ) );
+			m_packed.resize( m_dense.size( ) );
+			m_lazy.resize( m_dense.size( ) );
+			m_views.reserve( m_dense.size( ) );
+			for( size_t col = 0; col < m_dense.size( ); ++col ) {
+				auto const packed = m_packed[col].empty( ) ? nullptr : &m_packed[col];
+				m_views.emplace_back( m_dense[col], m_sparse[col].get( ), packed, m_lazy[col].get( ), m_arena );
+			}
+		}
+
+		column_view_t const & compact_table_t::operator[]( size_t col ) const {
+			return m_views[col];
+		}
+
+		column_view_t const & compact_table_t::operator[]( ::std::string const & header ) const {
+			for( auto const & view : m_views ) {
+				if( view.header( ) == header ) {
+					return view;
+				}
+			}
+			throw ::std::out_of_range( ": No column named " + header );
+		}
+
+		size_t compact_table_t::size( ) const {
+			return m_views.size( );
+		}
+
+		bool compact_table_t::empty( ) const {
+			return m_views.empty( );
+		}
+
+		compact_table_t::const_iterator compact_table_t::begin( ) const {
+			return m_views.begin( );
+		}
+
+		compact_table_t::const_iterator compact_table_t::end( ) const {
+			return m_views.end( );
+		}
+
+		size_t compact_table_t::sparse_count( ) const {
+			size_t result = 0;
+			for( auto const & sparse : m_sparse ) {
+				if( sparse ) {
+					++result;
+				}
+			}
+			return result;
+		}
+
+		size_t compact_table_t::packed_count( ) const {
+			size_t result = 0;
+			for( auto const & packed : m_packed ) {
+				if( !packed.empty( ) ) {
+					++result;
+				}
+			}
+			return result;
+		}
+
+		size_t compact_table_t::arena_footprint( ) const {
+			return m_arena.footprint( );
+		}
+
+		size_t compact_table_t::lazy_count( ) const {
+			size_t result = 0;
+			for( auto const & lazy : m_lazy ) {
+				if( lazy ) {
+					++result;
+				}
+			}
+			return result;
+		}
+
+		size_t compact_table_t::lazy_source_footprint( ) const {
+			// Every lazy column of a table shares one source
+			for( auto const & lazy : m_lazy ) {
+				if( lazy ) {
+					return lazy->source_footprint( );
+				}
+			}
+			return 0;
+		}
+
+		::std::vector<DataCell> & compact_table_t::dense_cells( ::std::string const & header ) {
+			for( size_t col = 0; col < m_dense.size( ); ++col ) {
+				if( m_dense[col].header != header ) {
+					continue;
+				}
+				if( m_sparse[col] || !m_packed[col].empty( ) || m_lazy[col] ) {
+					throw ::std::out_of_range( ": Column " + header + " is not kept dense" );
+				}
+				return m_dense[col].cells;
+			}
+			throw ::std::out_of_range( ": No column named " + header );
+		}
+	}	// namespace data
+}	// namespace daw
+
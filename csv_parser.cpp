@@ -0,0 +1,294 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <stdexcept>
+
+#include "csv_parser.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			// Bytes parsed between progress reports
+			size_t const s_progress_every = 4 * 1024 * 1024;
+
+			/// Reads fields of one row at a time.  Unquoted fields refer to the text, quoted ones with an
+			/// escaped quote are copied to a buffer of their own
+			class field_reader_t final {
+				char const * m_pos;
+				char const * m_end;
+				::std::deque<::std::string> m_unescaped;	// Growing a deque leaves its elements in place, earlier fields of the row still refer to them
+				size_t m_unescaped_used;
+
+				boost::string_ref quoted_field( ) {
+					++m_pos;	// Opening quote
+					auto const first = m_pos;
+					bool has_escapes = false;
+					while( m_pos < m_end ) {
+						if( '"' == *m_pos ) {
+							if( m_pos + 1 < m_end && '"' == m_pos[1] ) {
+								has_escapes = true;
+								m_pos += 2;
+								continue;
+							}
+							break;
+						}
+						++m_pos;
+					}
+					auto const last = m_pos;
+					if( m_pos < m_end ) {
+						++m_pos;	// Closing quote
+					}
+					// Anything between the closing quote and the separator is dropped
+					while( m_pos < m_end && ',' != *m_pos && '\n' != *m_pos && '\r' != *m_pos ) {
+						++m_pos;
+					}
+					if( !has_escapes ) {
+						return boost::string_ref( first, static_cast<size_t>(last - first) );
+					}
+					if( m_unescaped_used == m_unescaped.size( ) ) {
+						m_unescaped.emplace_back( );
+					}
+					auto & buffer = m_unescaped[m_unescaped_used++];
+					buffer.clear( );
+					for( auto it = first; it < last; ++it ) {
+						buffer.push_back( *it );
+						if( '"' == *it ) {
+							++it;	// Second quote of the pair
+						}
+					}
+					return boost::string_ref( buffer );
+				}
+			public:
+				field_reader_t( char const * first, char const * last ):
+						m_pos( first ),
+						m_end( last ),
+						m_unescaped( ),
+						m_unescaped_used( 0 ) { }
+
+				bool at_end( ) const {
+					return m_pos >= m_end;
+				}
+
+				char const * position( ) const {
+					return m_pos;
+				}
+
+				/// Start of a row, buffers of the previous row's fields are reused
+				void begin_row( ) {
+					m_unescaped_used = 0;
+				}
+
+				/// The next field of the row.  Returns false after the last field, when the reader has moved to
+				/// the next row
+				bool next_field( boost::string_ref & field ) {
+					if( m_pos < m_end && '"' == *m_pos ) {
+						field = quoted_field( );
+					} else {
+						auto const first = m_pos;
+						while( m_pos < m_end && ',' != *m_pos && '\n' != *m_pos && '\r' != *m_pos ) {
+							++m_pos;
+						}
+						field = boost::string_ref( first, static_cast<size_t>(m_pos - first) );
+					}
+					if( m_pos < m_end && ',' == *m_pos ) {
+						++m_pos;
+						return true;
+					}
+					end_row( );
+					return false;
+				}
+
+				/// Skip to the start of the next row
+				void end_row( ) {
+					while( m_pos < m_end && '\n' != *m_pos ) {
+						++m_pos;
+					}
+					if( m_pos < m_end ) {
+						++m_pos;
+					}
+				}
+			};	// field_reader_t
+
+			bool is_number_start( char c ) {
+				return (c >= '0' && c <= '9') || '-' == c || '+' == c || '.' == c;
+			}
+
+			DataCell make_cell( boost::string_ref text ) {
+				if( text.empty( ) ) {
+					return DataCell( );
+				}
+				char buff[64];
+				if( is_number_start( text.front( ) ) && text.size( ) < sizeof( buff ) ) {
+					// strtod needs the text terminated, and accepts more than plain numbers when it starts otherwise
+					::std::memcpy( buff, text.data( ), text.size( ) );
+					buff[text.size( )] = 0;
+					char * last = nullptr;
+					auto const value = ::std::strtod( buff, &last );
+					if( last == buff + text.size( ) ) {
+						return DataCell( static_cast<real_t>(value) );
+					}
+				}
+				return DataCell::from_string( text.to_string( ) );
+			}
+		}	// namespace anonymous
+
+		csv_parse_result_t parse_csv_columns( ::std::string text, csv_parse_options_t const & options ) {
+			csv_parse_result_t result;
+			result.bytes = text.size( );
+			field_reader_t reader( text.data( ), text.data( ) + text.size( ) );
+			for( size_t row = 0; row < options.header_row && !reader.at_end( ); ++row ) {
+				reader.end_row( );
+			}
+
+			// Index of the loaded column of each field of a row, or npos when not loaded
+			static size_t const not_loaded = static_cast<size_t>(-1);
+			::std::vector<size_t> loaded_index;
+			::std::vector<size_t> lazy_fields;	// Per loaded column, the field it is in when lazy or npos
+			boost::string_ref field;
+			reader.begin_row( );
+			bool more = !reader.at_end( );
+			while( more ) {
+				more = reader.next_field( field );
+				auto header = field.to_string( );
+				if( !options.column_filter || options.column_filter( header ) ) {
+					auto const parse_now = !options.parse_now || options.parse_now( header );
+					loaded_index.push_back( result.columns.size( ) );
+					lazy_fields.push_back( parse_now ? not_loaded : loaded_index.size( ) - 1 );
+					result.columns.push_back( dense_column_t{ ::std::move( header ), { } } );
+				} else {
+					loaded_index.push_back( not_loaded );
+				}
+			}
+			auto const has_lazy = ::std::any_of( lazy_fields.begin( ), lazy_fields.end( ), []( size_t lazy_field ) {
+				return not_loaded != lazy_field;
+			} );
+
+			// Every line is at most a row, reserving for them all saves growing every column many times
+			auto const rows_estimate = static_cast<size_t>(::std::count( reader.position( ), text.data( ) + text.size( ), '\n' )) + 1;
+			for( size_t n = 0; n < result.columns.size( ); ++n ) {
+				if( not_loaded == lazy_fields[n] ) {
+					result.columns[n].cells.reserve( rows_estimate );
+				}
+			}
+			auto source = ::std::make_shared<csv_source_t>( );
+			if( has_lazy ) {
+				source->row_offsets.reserve( rows_estimate );
+			}
+
+			::std::vector<boost::string_ref> fields( result.columns.size( ) );
+			auto next_progress = s_progress_every;
+			while( !reader.at_end( ) ) {
+				auto const row_start = reader.position( );
+				if( '\n' == *row_start || '\r' == *row_start ) {
+					reader.end_row( );	// Blank line
+					continue;
+				}
+				::std::fill( fields.begin( ), fields.end( ), boost::string_ref( ) );
+				reader.begin_row( );
+				size_t field_no = 0;
+				do {
+					more = reader.next_field( field );
+					if( field_no < loaded_index.size( ) && not_loaded != loaded_index[field_no] ) {
+						fields[loaded_index[field_no]] = field;
+					}
+					++field_no;
+				} while( more );
+				++result.rows_read;
+
+				// Checked before any cell is made so an empty row is never stored
+				if( options.skip_empty_rows && ::std::all_of( fields.begin( ) + (fields.empty( ) ? 0 : 1), fields.end( ), []( boost::string_ref const & value ) { return value.empty( ); } ) ) {
+					++result.rows_skipped;
+					continue;
+				}
+				for( size_t n = 0; n < fields.size( ); ++n ) {
+					if( not_loaded == lazy_fields[n] ) {
+						result.columns[n].cells.push_back( make_cell( fields[n] ) );
+					}
+				}
+				if( has_lazy ) {
+					source->row_offsets.push_back( static_cast<uint64_t>(row_start - text.data( )) );
+				}
+
+				auto const done = static_cast<size_t>(reader.position( ) - text.data( ));
+				if( options.on_progress && done >= next_progress ) {
+					options.on_progress( done, text.size( ) );
+					next_progress = done + s_progress_every;
+				}
+			}
+			for( auto & column : result.columns ) {
+				column.cells.shrink_to_fit( );
+			}
+			if( options.on_progress ) {
+				options.on_progress( text.size( ), text.size( ) );
+			}
+			result.lazy.resize( result.columns.size( ) );
+			if( has_lazy ) {
+				// Offsets into the text stay valid when it is moved
+				source->row_offsets.shrink_to_fit( );
+				source->text = ::std::move( text );
+				for( size_t n = 0; n < result.columns.size( ); ++n ) {
+					if( not_loaded != lazy_fields[n] ) {
+						result.lazy[n].reset( new lazy_column_t( source, lazy_fields[n] ) );
+					}
+				}
+			}
+			return result;
+		}
+
+		csv_parse_result_t parse_csv_file( ::std::string const & filename, csv_parse_options_t const & options ) {
+			::std::ifstream in( filename, ::std::ios::binary );
+			if( !in ) {
+				throw ::std::runtime_error( ": Error opening " + filename );
+			}
+			in.seekg( 0, ::std::ios::end );
+			auto const size = in.tellg( );
+			in.seekg( 0, ::std::ios::beg );
+			if( size < 0 ) {
+				throw ::std::runtime_error( ": Error reading " + filename );
+			}
+			::std::string text( static_cast<size_t>(size), '\0' );
+			if( !in.read( &text[0], static_cast<::std::streamsize>(text.size( )) ) ) {
+				throw ::std::runtime_error( ": Error reading " + filename );
+			}
+			return parse_csv_columns( ::std::move( text ), options );
+		}
+
+		DataCell decode_csv_field( boost::string_ref text, size_t row_offset, size_t field ) {
+			field_reader_t reader( text.data( ) + row_offset, text.data( ) + text.size( ) );
+			reader.begin_row( );
+			boost::string_ref value;
+			for( size_t n = 0; n <= field; ++n ) {
+				if( !reader.next_field( value ) && n < field ) {
+					return DataCell( );	// Short row
+				}
+			}
+			return make_cell( value );
+		}
+	}	// namespace data
+}	// namespace daw
+
@@ -0,0 +1,62 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE csv_parser
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+#include "csv_parser.h"
+
+using namespace daw::data;
+
+BOOST_AUTO_TEST_CASE( csv_parser_escaped_fields ) {
+	// Several escaped fields in one row, each short enough for the string's own buffer
+	csv_parse_options_t options;
+	auto const result = parse_csv_columns( "A,B,C,D,E\n\"a\"\"b\",\"c\"\"d\",x,\"e\"\"f\",\"g\"\"h\"\n", options );
+	BOOST_REQUIRE_EQUAL( result.columns.size( ), 5u );
+	BOOST_REQUIRE_EQUAL( result.columns[0].cells.size( ), 1u );
+	BOOST_CHECK_EQUAL( result.columns[0].cells[0].string( ), "a\"b" );
+	BOOST_CHECK_EQUAL( result.columns[1].cells[0].string( ), "c\"d" );
+	BOOST_CHECK_EQUAL( result.columns[2].cells[0].string( ), "x" );
+	BOOST_CHECK_EQUAL( result.columns[3].cells[0].string( ), "e\"f" );
+	BOOST_CHECK_EQUAL( result.columns[4].cells[0].string( ), "g\"h" );
+}
+
+BOOST_AUTO_TEST_CASE( csv_parser_skip_empty_rows ) {
+	csv_parse_options_t options;
+	options.header_row = 1;
+	options.skip_empty_rows = true;
+	options.column_filter = []( ::std::string const & header ) {
+		return header != "Skip";
+	};
+	auto const result = parse_csv_columns( "preamble\nA,Skip,B\r\n1,x,\r\n2,x,3.5\n\n3,x,\"a,b\"\n4,x", options );
+	BOOST_REQUIRE_EQUAL( result.columns.size( ), 2u );
+	BOOST_CHECK_EQUAL( result.rows_read, 4u );
+	BOOST_CHECK_EQUAL( result.rows_skipped, 2u );
+	BOOST_REQUIRE_EQUAL( result.columns[1].cells.size( ), 2u );
+	BOOST_CHECK_EQUAL( result.columns[0].cells[0].real( ), 2.0 );
+	BOOST_CHECK_EQUAL( result.columns[1].cells[0].real( ), 3.5 );
+	BOOST_CHECK_EQUAL( result.columns[1].cells[1].string( ), "a,b" );
+}
+
@@ -34,14 +34,26 @@ namespace daw {
 		CSVTable::CSVTable( ):
 				wxGridTableBase{ },
 				m_data_analysis( nullptr ),
-				m_valid( false ) { }
+				m_row_count( 0 ),
+				m_cell_cache( ::std::make_shared<formatted_cell_cache_t>( ) ),
+				m_timestamps( nullptr ),
+				m_timestamp_col( -1 ),
+				m_view_spec( ),
+				m_view( nullptr ),
+				m_view_inverse( nullptr ) { }
 
-		CSVTable::CSVTable( daw::data::parse_csv_data_param const & param ) :
+		CSVTable::CSVTable( ::std::string filename ) :
 				wxGridTableBase{ },
-				m_data_analysis( new daw::pumpdataanalysis::PumpDataAnalysis( param, ::std::bind( &CSVTable::set_valid, this, true ) ) ),
-				m_valid( false ) { }
+				m_data_analysis( ::std::make_shared<daw::pumpdataanalysis::PumpDataAnalysis>( ::std::move( filename ) ) ),
+				m_row_count( 0 ),
+				m_cell_cache( ::std::make_shared<formatted_cell_cache_t>( ) ),
+				m_timestamps( nullptr ),
+				m_timestamp_col( -1 ),
+				m_view_spec( ),
+				m_view( nullptr ),
+				m_view_inverse( nullptr ) { }
 
-		daw::data::DataTable const & CSVTable::data( ) const {
+		daw::data::compact_table_t const & CSVTable::data( ) const {
 			daw::exception::dbg_throw_on_null( m_data_analysis.get( ), ": Attempt to access non-existent data" );
 			return m_data_analysis->data_table( );
 		}
@@ -57,51 +69,214 @@ namespace daw {
 		}
 
 		int CSVTable::GetNumberRows( ) {
-			if( this->data().empty( ) ) {
-				return 0;
+			if( m_view ) {
+				return static_cast<int>(m_view->size( ));
 			}
-			return static_cast<int>(this->data( )[0].size( ));
+			// Only the rows the grid has been told of, see sync_rows
+			return static_cast<int>(m_row_count);
 		}
 
 		int CSVTable::GetNumberCols( ) {
+			if( !has_table( ) ) {
+				return 0;
+			}
 			return static_cast<int>( this->data( ).size( ) );
 		}
 
+		bool CSVTable::has_table( ) const {
+			return m_data_analysis && m_data_analysis->has_table( );
+		}
+
+		bool CSVTable::has_data( ) const {
+			return m_data_analysis && m_data_analysis->has_data( );
+		}
+
+		void CSVTable::cancel( ) {
+			if( m_data_analysis ) {
+				m_data_analysis->cancel( );
+			}
+			// The pre-rendering worker only stops when it is destroyed.  -2 so the next GetValue does not start
+			// another one
+			m_timestamps.reset( );
+			m_timestamp_col = -2;
+		}
+
+		bool CSVTable::sync_rows( ) {
+			if( !m_data_analysis ) {
+				return false;
+			}
+			auto const rows_ready = m_data_analysis->rows_ready( );
+			if( rows_ready <= m_row_count ) {
+				return false;
+			}
+			auto const added = rows_ready - m_row_count;
+			m_row_count = rows_ready;
+			auto grid = GetView( );
+			if( nullptr != grid && !m_view ) {
+				wxGridTableMessage msg( this, wxGRIDTABLE_NOTIFY_ROWS_APPENDED, static_cast<int>(added) );
+				grid->ProcessTableMessage( msg );
+			}
+			return true;
+		}
+
 		bool CSVTable::IsEmptyCell( int row, int col ) {
-			return this->data( )[col][row].empty( );
+			return this->data( )[col][data_row( row )].empty( );
 		}
 
-		wxString CSVTable::GetValue( int row, int col ) {
-			auto const & cell = this->data( )[col][row];
+		namespace {
+			::std::shared_ptr<daw::string::ptime_formatter_t const> const & timestamp_format( ) {
+				static auto const s_timestamp_format = ::std::make_shared<daw::string::ptime_formatter_t const>( "%Y-%m-%d %H:%M" );
+				return s_timestamp_format;
+			}
+		}	// namespace anonymous
+
+		::std::string cell_to_text( daw::data::compact_table_t::value_type::value_type const & cell ) {
 			if( DataCellType::timestamp == cell.type( ) ) {
-				return daw::string::ptime_to_string( cell.timestamp( ), "%Y-%m-%d %H:%M" );
+				char buff[32];
+				return ::std::string( buff, timestamp_format( )->format( cell.timestamp( ), buff, sizeof( buff ) ) );
 			}
 			return cell.to_string( );
 		}
 
+		wxString CSVTable::format_cell( size_t row, size_t col ) const {
+			return cell_to_text( this->data( )[col][data_row( static_cast<int>(row) )] );
+		}
+
+		void CSVTable::start_prerender( ) {
+			// Waits for the load to finish, the loader is still writing the Timestamp column until then
+			if( m_timestamp_col != -1 || !has_data( ) ) {
+				return;
+			}
+			m_timestamp_col = -2;	// Looked for, none found or cancelled
+			auto const & table = this->data( );
+			for( size_t n = 0; n < table.size( ); ++n ) {
+				if( table[n].header( ) == "Timestamp" ) {
+					m_timestamp_col = static_cast<int>(n);
+					m_timestamps = ::std::make_shared<prerendered_timestamps_t>( m_data_analysis, table[n], timestamp_format( ) );
+					break;
+				}
+			}
+		}
+
+		wxString CSVTable::GetValue( int row, int col ) {
+			start_prerender( );
+			if( col == m_timestamp_col ) {
+				wxString result;
+				if( m_timestamps->try_get( data_row( row ), result ) ) {
+					return result;
+				}
+			}
+			// Cached by grid row, the cache is emptied when the view changes
+			auto const row_count = static_cast<size_t>(GetNumberRows( ));
+			return m_cell_cache->get( static_cast<size_t>(row), static_cast<size_t>(col), row_count, [this]( size_t r, size_t c ) {
+				return format_cell( r, c );
+			} );
+		}
+
 		void CSVTable::SetValue( int, int, wxString const & ) {
 			throw daw::exception::NotImplemented( ": DataTable is read-only" );
 		}
 
 		wxString CSVTable::GetColLabelValue( int col ) {
-			auto ret = this->data( )[col].header( );
+			wxString ret = this->data( )[col].header( );
+			if( static_cast<size_t>(col) == m_view_spec.sort_col ) {
+				ret += m_view_spec.ascending ? " (asc)" : " (desc)";
+			}
 			return ret;
 		}
 
-		void CSVTable::Clear( ) { }
+		wxString CSVTable::GetRowLabelValue( int row ) {
+			// Numbered by table row so a row keeps its number when sorted or filtered
+			return wxString::Format( "%llu", static_cast<unsigned long long>(data_row( row )) + 1 );
+		}
+
+		row_view_spec_t const & CSVTable::view_spec( ) const {
+			return m_view_spec;
+		}
+
+		void CSVTable::set_view_spec( row_view_spec_t spec ) {
+			auto const old_rows = GetNumberRows( );
+			m_view = make_row_view( this->data( ), spec );
+			m_view_inverse.reset( );
+			m_view_spec = ::std::move( spec );
+			m_cell_cache->clear( );
+			auto const new_rows = GetNumberRows( );
+			auto grid = GetView( );
+			if( nullptr == grid ) {
+				return;
+			}
+			grid->BeginBatch( );
+			if( new_rows < old_rows ) {
+				wxGridTableMessage msg( this, wxGRIDTABLE_NOTIFY_ROWS_DELETED, new_rows, old_rows - new_rows );
+				grid->ProcessTableMessage( msg );
+			} else if( new_rows > old_rows ) {
+				wxGridTableMessage msg( this, wxGRIDTABLE_NOTIFY_ROWS_APPENDED, new_rows - old_rows );
+				grid->ProcessTableMessage( msg );
+			}
+			grid->EndBatch( );
+			grid->ForceRefresh( );
+		}
+
+		size_t CSVTable::data_row( int row ) const {
+			return m_view ? (*m_view)[static_cast<size_t>(row)] : static_cast<size_t>(row);
+		}
+
+		int CSVTable::grid_row( size_t data_row ) const {
+			if( !m_view ) {
+				return static_cast<int>(data_row);
+			}
+			if( !m_view_inverse ) {
+				auto const & table = this->data( );
+				::std::vector<int> inverse( table.empty( ) ? 0 : table[0].size( ), -1 );
+				for( size_t n = 0; n < m_view->size( ); ++n ) {
+					inverse[(*m_view)[n]] = static_cast<int>(n);
+				}
+				m_view_inverse = ::std::make_shared<::std::vector<int> const>( ::std::move( inverse ) );
+			}
+			return (*m_view_inverse)[data_row];
+		}
+
+		task_future_t<::std::vector<int>> CSVTable::start_autosize( ::std::shared_ptr<daw::pumpdataanalysis::text_metrics_t const> metrics, wxFont const & cell_font, wxFont const & label_font, cancellation_token_t cancelled ) const {
+			using daw::pumpdataanalysis::text_metrics_t;
+			// Font keys are read here as wxFont must stay on the UI thread
+			return start_column_autosize( m_data_analysis, this->data( ), &cell_to_text, ::std::move( metrics ), text_metrics_t::key_of( cell_font ), text_metrics_t::key_of( label_font ), ::std::move( cancelled ) );
+		}
+
+		::std::unique_ptr<text_search_t> CSVTable::start_search( ::std::string needle ) const {
+			return ::std::make_unique<text_search_t>( m_data_analysis, this->data( ), ::std::move( needle ) );
+		}
+
+		void CSVTable::Clear( ) {
+			m_cell_cache->clear( );
+		}
 
 		CSVTable::~CSVTable( ) { }
 
 		CSVTable::CSVTable( CSVTable && other ):
 			wxGridTableBase{ },
 			m_data_analysis{ std::move( other.m_data_analysis ) },
-			m_valid{ other.m_valid } { }
+			m_row_count{ other.m_row_count },
+			m_cell_cache{ ::std::make_shared<formatted_cell_cache_t>( ) },
+			m_timestamps{ std::move( other.m_timestamps ) },
+			m_timestamp_col{ other.m_timestamp_col },
+			m_view_spec{ std::move( other.m_view_spec ) },
+			m_view{ std::move( other.m_view ) },
+			m_view_inverse{ std::move( other.m_view_inverse ) } {
+
+			::std::swap( m_cell_cache, other.m_cell_cache );
+		}
 
 
 		void swap( CSVTable & lhs, CSVTable & rhs ) noexcept {
 			using std::swap;
 			swap( lhs.m_data_analysis, rhs.m_data_analysis );
-			swap( lhs.m_valid, rhs.m_valid );
+			swap( lhs.m_row_count, rhs.m_row_count );
+			swap( lhs.m_cell_cache, rhs.m_cell_cache );
+			swap( lhs.m_timestamps, rhs.m_timestamps );
+			swap( lhs.m_timestamp_col, rhs.m_timestamp_col );
+			swap( lhs.m_view_spec, rhs.m_view_spec );
+			swap( lhs.m_view, rhs.m_view );
+			swap( lhs.m_view_inverse, rhs.m_view_inverse );
 		}
 
 		CSVTable & CSVTable::operator=( CSVTable && rhs ) {
@@ -114,7 +289,7 @@ namespace daw {
 		}
 
 		bool CSVTable::is_valid( ) const {
-			return m_valid;
+			return m_data_analysis && !m_data_analysis->has_failed( );
 		}
 
 	}
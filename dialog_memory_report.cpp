@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <utility>
+#include <wx/wx.h>
+
+#include "dialog_memory_report.h"
+
+namespace daw {
+	namespace wx {
+		DialogMemoryReport::DialogMemoryReport( wxWindow * parent, wxWindowID id, wxString const & title, ::std::function<::std::string( )> make_report, wxPoint const & pos ):
+				wxDialog( parent, id, title, pos, wxSize( 640, 480 ), wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER ),
+				m_make_report( ::std::move( make_report ) ),
+				m_text( nullptr ) {
+
+			m_text = new wxTextCtrl( this, wxID_ANY, wxString( m_make_report( ) ), wxDefaultPosition, wxSize( 640, 420 ), wxTE_MULTILINE | wxTE_READONLY | wxTE_DONTWRAP );
+			// The report is laid out in columns
+			m_text->SetFont( wxFont( 9, wxFONTFAMILY_MODERN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL ) );
+
+			auto btn_refresh = new wxButton( this, wxID_REFRESH, wxT( "Refresh" ), wxDefaultPosition, wxSize( 70, 30 ) );
+			auto btn_close = new wxButton( this, wxID_OK, wxT( "Close" ), wxDefaultPosition, wxSize( 70, 30 ) );
+			btn_close->SetDefault( );
+
+			auto hbox = new wxBoxSizer( wxHORIZONTAL );
+			hbox->Add( btn_refresh, 0, wxRIGHT, 10 );
+			hbox->Add( btn_close );
+
+			auto vbox = new wxBoxSizer( wxVERTICAL );
+			vbox->Add( m_text, 1, wxRIGHT | wxLEFT | wxTOP | wxEXPAND, 10 );
+			vbox->Add( hbox, 0, wxALIGN_RIGHT | wxALL, 10 );
+			vbox->SetSizeHints( this );
+			SetSizer( vbox );
+
+			Centre( );
+
+			btn_refresh->Bind( wxEVT_BUTTON, &daw::wx::DialogMemoryReport::on_refresh, this, wxID_ANY );
+			btn_close->Bind( wxEVT_BUTTON, &daw::wx::DialogMemoryReport::on_close, this, wxID_ANY );
+		}
+
+		DialogMemoryReport::~DialogMemoryReport( ) { }
+
+		void DialogMemoryReport::on_refresh( wxCommandEvent & ) {
+			m_text->SetValue( wxString( m_make_report( ) ) );
+		}
+
+		void DialogMemoryReport::on_close( wxCommandEvent & ) {
+			if( IsModal( ) ) {
+				EndModal( wxOK ); // If modal
+			} else {
+				SetReturnCode( wxOK );
+				Show( false ); // If modeless
+			}
+		}
+	}
+}
+
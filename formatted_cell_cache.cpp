@@ -0,0 +1,139 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+
+#include <daw/csv_helper/data_common.h>
+#include <daw/daw_exception.h>
+
+#include "formatted_cell_cache.h"
+
+namespace daw {
+	namespace data {
+		formatted_cell_cache_t::formatted_cell_cache_t( size_t max_blocks ):
+				m_max_blocks( ::std::max<size_t>( max_blocks, 1 ) ),
+				m_lru( ),
+				m_blocks( ) { }
+
+		wxString const & formatted_cell_cache_t::get( size_t row, size_t col, size_t row_count, format_cell_t const & format_cell ) {
+			daw::exception::dbg_throw_on_false( col < (1u << 20), ": Too many columns for the cell cache" );
+			auto const block_no = row / rows_per_block;
+			auto const key = (static_cast<uint64_t>(block_no) << 20) | static_cast<uint64_t>(col);
+			auto pos = m_blocks.find( key );
+			if( m_blocks.end( ) != pos ) {
+				if( row - block_no * rows_per_block < pos->second.cells.size( ) ) {
+					m_lru.splice( m_lru.begin( ), m_lru, pos->second.lru_pos );
+					return pos->second.cells[row - block_no * rows_per_block];
+				}
+				// The block was cut short by the row count when it was formatted and rows have been added since
+				m_lru.erase( pos->second.lru_pos );
+				m_blocks.erase( pos );
+			}
+			if( m_blocks.size( ) >= m_max_blocks ) {
+				m_blocks.erase( m_lru.back( ) );
+				m_lru.pop_back( );
+			}
+			auto const first_row = block_no * rows_per_block;
+			auto const last_row = ::std::min( first_row + rows_per_block, row_count );
+			block_t block;
+			block.cells.reserve( last_row - first_row );
+			for( auto n = first_row; n < last_row; ++n ) {
+				block.cells.push_back( format_cell( n, col ) );
+			}
+			m_lru.push_front( key );
+			block.lru_pos = m_lru.begin( );
+			auto & result = m_blocks.emplace( key, ::std::move( block ) ).first->second;
+			return result.cells[row - first_row];
+		}
+
+		void formatted_cell_cache_t::clear( ) {
+			m_blocks.clear( );
+			m_lru.clear( );
+		}
+
+		size_t formatted_cell_cache_t::block_count( ) const {
+			return m_blocks.size( );
+		}
+
+		namespace {
+			size_t const s_publish_every = 4096;
+			// Length byte of rows that are not timestamps, they are left to the caller
+			unsigned char const s_not_rendered = 0xFF;
+		}	// namespace anonymous
+
+		prerendered_timestamps_t::prerendered_timestamps_t( ::std::shared_ptr<void const> keep_alive, daw::data::compact_table_t::value_type const & column, ::std::shared_ptr<daw::string::ptime_formatter_t const> format ):
+				m_text( ),
+				m_stride( ::std::min<size_t>( format->max_size( ), s_not_rendered - 1 ) + 1 ),
+				m_rows_ready( 0 ),
+				m_cancel( false ),
+				m_worker( ) {
+
+			// Sized up front so the worker never reallocates under a reader
+			m_text.resize( column.size( ) * m_stride );
+			// Only saves formatting on scroll, anything the user asked for goes first
+			m_worker = task_pool_t::get( ).submit( task_priority_t::cache, [this, keep_alive = ::std::move( keep_alive ), &column, format = ::std::move( format )]( ) {
+				auto const row_count = column.size( );
+				for( size_t first = 0; first < row_count && !m_cancel; first += s_publish_every ) {
+					auto const last = ::std::min( first + s_publish_every, row_count );
+					for( auto row = first; row < last; ++row ) {
+						auto const dest = m_text.data( ) + row * m_stride;
+						auto const & cell = column[row];
+						if( cell.empty( ) ) {
+							dest[0] = 0;
+						} else if( DataCellType::timestamp == cell.type( ) ) {
+							dest[0] = static_cast<char>(format->format( cell.timestamp( ), dest + 1, m_stride - 1 ));
+						} else {
+							dest[0] = static_cast<char>(s_not_rendered);
+						}
+					}
+					m_rows_ready.store( last, ::std::memory_order_release );
+				}
+			} );
+		}
+
+		prerendered_timestamps_t::~prerendered_timestamps_t( ) {
+			m_cancel = true;
+			if( m_worker.valid( ) ) {
+				m_worker.wait( );
+			}
+		}
+
+		bool prerendered_timestamps_t::try_get( size_t row, wxString & out ) const {
+			if( row >= m_rows_ready.load( ::std::memory_order_acquire ) ) {
+				return false;
+			}
+			auto const src = m_text.data( ) + row * m_stride;
+			auto const len = static_cast<unsigned char>(src[0]);
+			if( s_not_rendered == len ) {
+				return false;
+			}
+			out = wxString( src + 1, static_cast<size_t>(len) );
+			return true;
+		}
+
+		size_t prerendered_timestamps_t::rows_ready( ) const {
+			return m_rows_ready.load( ::std::memory_order_acquire );
+		}
+	}	// namespace data
+}	// namespace daw
+
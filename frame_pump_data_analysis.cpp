@@ -21,6 +21,8 @@
 // SOFTWARE.
 
 #include <array>
+#include <exception>
+#include <sstream>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <wx/wx.h>
 
@@ -28,8 +30,10 @@
 
 #include "defs.h"
 #include "dialog_date_range_chooser.h"
+#include "dialog_memory_report.h"
 #include "frame_pump_data_analysis.h"
 #include "panel_pump_data_analysis.h"
+#include "trace.h"
 
 // ---------------------------------------------------------------------------
 // PumpDataAnalysisFrame
@@ -37,8 +41,11 @@
 
 FramePumpDataAnalysis::FramePumpDataAnalysis( wxApp * app ): 
 		wxMDIParentFrame( nullptr, wxID_ANY, "Pump Data Analysis (c) 2014 Darrell Wright - ", wxDefaultPosition, wxSize( 800, 600 ) ),
-		m_wxapp( app ) {
+		m_wxapp( app ),
+		m_batch_render( ),
+		m_batch_render_timer( this, MDI_BATCH_RENDER_TIMER ) {
 //	SetIcon( wxICON( sample ) );
+	daw::set_trace_thread_name( "UI" );
 	SetMenuBar( create_menu_bar( ) );
 
 	auto windowMenu = GetWindowMenu( );
@@ -65,9 +72,14 @@ FramePumpDataAnalysis::FramePumpDataAnalysis( wxApp * app ):
 wxMenuBar * FramePumpDataAnalysis::create_menu_bar( ) {
 	auto menuFile = new wxMenu( );
 	menuFile->Append( wxID_OPEN, "&Open\tCtrl-O", "Open datafile" );
+	menuFile->Append( MDI_BATCH_RENDER, "Batch &Render Reports...", "Render the basal test reports of many datafiles to images" );
 	menuFile->Append( wxID_EXIT, "&Exit\tAlt-X", "Quit the program" );
 
 	auto menuHelp = new wxMenu( );
+	menuHelp->AppendCheckItem( MDI_TRACE_RECORD, "Record &Trace", "Record how long loading, analysis and drawing take" );
+	menuHelp->Append( MDI_TRACE_SAVE, "&Save Trace...", "Save the recorded trace for chrome://tracing" );
+	menuHelp->Append( MDI_MEMORY_REPORT, "&Memory Report...", "Show the memory held by each open file" );
+	menuHelp->AppendSeparator( );
 	menuHelp->Append( wxID_ABOUT, "&About\tF1" );
 
 	auto mbar = new wxMenuBar( );
@@ -87,6 +99,9 @@ void FramePumpDataAnalysis::on_close( wxCloseEvent & event ) {
 			return;
 		}
 	}
+	// The batch draws on this thread from the timer, it can not outlive the frame
+	m_batch_render_timer.Stop( );
+	m_batch_render.cancel( );
 	event.Skip( );
 }
 
@@ -117,6 +132,94 @@ void FramePumpDataAnalysis::on_close_all( wxCommandEvent & ) {
 	}
 }
 
+void FramePumpDataAnalysis::on_batch_render( wxCommandEvent & ) {
+	if( m_batch_render.valid( ) ) {
+		wxMessageBox( "Reports are still being rendered", "Batch Render Reports" );
+		return;
+	}
+	wxFileDialog open_files_dialog{ this, _( "Choose Pump Data Files" ), "", "", "Medtronic Carelink CSV Export files (*.csv)|*.csv", wxFD_OPEN | wxFD_FILE_MUST_EXIST | wxFD_MULTIPLE };
+	if( wxID_CANCEL == open_files_dialog.ShowModal( ) ) {
+		return;
+	}
+	wxDirDialog out_dir_dialog{ this, _( "Choose Output Folder" ) };
+	if( wxID_CANCEL == out_dir_dialog.ShowModal( ) ) {
+		return;
+	}
+	wxArrayString paths;
+	open_files_dialog.GetPaths( paths );
+	::std::vector<::std::string> filenames;
+	for( auto const & path : paths ) {
+		filenames.push_back( path.ToStdString( ) );
+	}
+	try {
+		m_batch_render = daw::pumpdataanalysis::batch_render_t( filenames, out_dir_dialog.GetPath( ).ToStdString( ), daw::pumpdataanalysis::batch_render_options_t( ) );
+	} catch( ::std::exception const & ex ) {
+		wxMessageBox( wxString( "Could not start rendering reports\n" ) + ex.what( ), "Batch Render Reports" );
+		return;
+	}
+	wxLogStatus( "Rendering reports..." );
+	// Often enough that the workers, which wait for their plot to be drawn, are not left idle
+	m_batch_render_timer.Start( 50 );
+}
+
+void FramePumpDataAnalysis::on_batch_render_timer( wxTimerEvent & ) {
+	// The display lists are built on the pool, wx only lets them be drawn here
+	if( !m_batch_render.valid( ) || !m_batch_render.draw_ready( ) ) {
+		return;
+	}
+	m_batch_render_timer.Stop( );
+	auto const result = m_batch_render.get( );
+	wxString msg;
+	msg.Printf( "Rendered %llu images from %llu files", static_cast<unsigned long long>(result.images_written), static_cast<unsigned long long>(result.files_loaded) );
+	wxLogStatus( msg );
+	for( auto const & error : result.errors ) {
+		msg += "\n" + error;
+	}
+	wxMessageBox( msg, "Batch Render Reports" );
+}
+
+void FramePumpDataAnalysis::on_trace_record( wxCommandEvent & ) {
+	auto const enable = !daw::trace_enabled( );
+	if( enable ) {
+		// A new recording, not the tail of the last one
+		daw::clear_trace( );
+	}
+	daw::set_trace_enabled( enable );
+	wxLogStatus( enable ? "Recording trace" : "Stopped recording trace" );
+}
+
+void FramePumpDataAnalysis::on_trace_record_update( wxUpdateUIEvent & event ) {
+	// Every window has its own menu bar, they all show the one setting
+	event.Check( daw::trace_enabled( ) );
+}
+
+void FramePumpDataAnalysis::on_trace_save( wxCommandEvent & ) {
+	wxFileDialog save_dialog{ this, _( "Save Trace" ), "", "trace.json", "Chrome trace files (*.json)|*.json", wxFD_SAVE | wxFD_OVERWRITE_PROMPT };
+	if( wxID_CANCEL == save_dialog.ShowModal( ) ) {
+		return;
+	}
+	try {
+		daw::write_chrome_trace( save_dialog.GetPath( ).ToStdString( ) );
+	} catch( ::std::exception const & ex ) {
+		wxMessageBox( wxString( "Could not save trace\n" ) + ex.what( ), "Save Trace" );
+	}
+}
+
+void FramePumpDataAnalysis::on_memory_report( wxCommandEvent & ) {
+	daw::wx::DialogMemoryReport dlg( this, wxID_ANY, "Memory Report", [this]( ) {
+		::std::vector<daw::pumpdataanalysis::memory_report_t> reports;
+		for( auto & child : GetChildren( ) ) {
+			if( auto const file_window = dynamic_cast<PanelPumpDataAnalyis const *>(child) ) {
+				reports.push_back( file_window->memory_report( ) );
+			}
+		}
+		::std::ostringstream ss;
+		daw::pumpdataanalysis::write_memory_report( ss, reports );
+		return ss.str( );
+	} );
+	dlg.ShowModal( );
+}
+
 void FramePumpDataAnalysis::on_size( wxSizeEvent& ) { }
 
 // ---------------------------------------------------------------------------
@@ -127,6 +230,12 @@ BEGIN_EVENT_TABLE( FramePumpDataAnalysis, wxMDIParentFrame )
 	EVT_MENU( wxID_OPEN, FramePumpDataAnalysis::on_file_open )
 	EVT_MENU( wxID_EXIT, FramePumpDataAnalysis::on_quit )
 	EVT_MENU( wxID_CLOSE_ALL, FramePumpDataAnalysis::on_close_all )
+	EVT_MENU( MDI_BATCH_RENDER, FramePumpDataAnalysis::on_batch_render )
+	EVT_TIMER( MDI_BATCH_RENDER_TIMER, FramePumpDataAnalysis::on_batch_render_timer )
+	EVT_MENU( MDI_TRACE_RECORD, FramePumpDataAnalysis::on_trace_record )
+	EVT_UPDATE_UI( MDI_TRACE_RECORD, FramePumpDataAnalysis::on_trace_record_update )
+	EVT_MENU( MDI_TRACE_SAVE, FramePumpDataAnalysis::on_trace_save )
+	EVT_MENU( MDI_MEMORY_REPORT, FramePumpDataAnalysis::on_memory_report )
 	EVT_CLOSE( FramePumpDataAnalysis::on_close )
 END_EVENT_TABLE( )
 
@@ -61,6 +61,20 @@ namespace daw {
 			values.push_back( value );
 		}
 
+		/// <summary>Add the values of other, as when parts of the data are aggregated in parallel.
+		/// Neither may have been processed yet</summary>
+		void merge( AggregateData const & other ) {
+			average += other.average;
+			count += other.count;
+			if( other.low < low ) {
+				low = other.low;
+			}
+			if( other.high > high ) {
+				high = other.high;
+			}
+			values.insert( values.end( ), other.values.begin( ), other.values.end( ) );
+		}
+
 		void process_values( ) {
 			if( 0 != values.size( ) ) {	// We can assume all values are all greater than zero
 				average /= static_cast<T>(count);
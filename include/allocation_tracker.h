@@ -0,0 +1,74 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "defs.h"
+
+namespace daw {
+	/// <summary>What a thread is doing, allocations are counted against it</summary>
+	enum class alloc_phase_t: uint8_t { other = 0, parse, analysis, rendering };
+	size_t const alloc_phase_count = 4;
+
+	char const * alloc_phase_name( alloc_phase_t phase );
+
+	struct phase_allocations_t {
+		uint64_t allocations;	// Calls to operator new
+		uint64_t bytes_allocated;	// Bytes ever requested
+		int64_t bytes_live;	// Bytes requested and not yet freed
+	};	// phase_allocations_t
+
+	/// <summary>True when built with TRACK_ALLOCATIONS, otherwise the counts are all 0</summary>
+	bool allocation_tracking_enabled( );
+
+	/// <summary>Counts of every phase so far, indexed by alloc_phase_t</summary>
+	::std::array<phase_allocations_t, alloc_phase_count> phase_allocations( );
+
+	/// <summary>Phase of the calling thread, for handing on to work it has another thread do</summary>
+	alloc_phase_t current_alloc_phase( );
+
+	//////////////////////////////////////////////////////////////////////////
+	/// <summary>Counts the calling thread's allocations against phase until
+	/// destroyed, then goes back to the phase before.  Memory freed by
+	/// another phase or thread is still taken off the phase that allocated
+	/// it.  Does nothing unless built with TRACK_ALLOCATIONS</summary>
+	//////////////////////////////////////////////////////////////////////////
+	class alloc_phase_scope_t final {
+#if TRACK_ALLOCATIONS
+		alloc_phase_t m_previous;
+	public:
+		explicit alloc_phase_scope_t( alloc_phase_t phase );
+		~alloc_phase_scope_t( );
+#else
+	public:
+		explicit alloc_phase_scope_t( alloc_phase_t ) { }
+#endif
+		alloc_phase_scope_t( alloc_phase_scope_t const & ) = delete;
+		alloc_phase_scope_t & operator=( alloc_phase_scope_t const & ) = delete;
+	};	// alloc_phase_scope_t
+}	// namespace daw
+
@@ -0,0 +1,90 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <boost/date_time/posix_time/ptime.hpp>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <daw/csv_helper/data_table.h>
+
+#include "aggregate_data.h"
+#include "cancellation.h"
+#include "memory_report.h"
+#include "pump_data_analysis.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		struct analysis_options_t {
+			boost::posix_time::ptime from;	// Tests starting earlier are left out, not_a_date_time for no limit
+			boost::posix_time::ptime to;	// Tests ending later are left out, not_a_date_time for no limit
+			basal_test_params_t detector;
+			bool derivatives = true;	// Include the average rate of change per 5 minute period
+			bool measure_memory = false;	// Fill file_report_t::memory
+		};	// analysis_options_t
+
+		struct basal_window_t {
+			size_t first_row;
+			size_t last_row;
+			boost::posix_time::ptime start;
+			boost::posix_time::ptime end;
+			daw::AggregateData<daw::data::real_t> glucose;	// Sensor readings in the window
+		};	// basal_window_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Everything the headless analysis finds in one export.  When
+		/// error is not empty the file could not be analysed and only filename
+		/// is meaningful</summary>
+		//////////////////////////////////////////////////////////////////////////
+		struct file_report_t {
+			::std::string filename;
+			::std::string error;
+			size_t row_count = 0;
+			boost::posix_time::ptime first_timestamp;
+			boost::posix_time::ptime last_timestamp;
+			::std::vector<basal_window_t> windows;
+			::std::vector<daw::AggregateData<daw::data::real_t>> bins;	// 288 five minute periods of a day
+			::std::vector<daw::AggregateData<daw::data::real_t>> derivative_bins;	// Empty unless asked for
+			daw::AggregateData<daw::data::real_t> glucose;	// Every reading in every window
+			double window_hours = 0.0;
+			memory_report_t memory;	// Only when asked for
+		};	// file_report_t
+
+		/// <summary>Load and analyse one export on the calling thread.  Errors are reported in the result</summary>
+		file_report_t analyse_file( ::std::string const & filename, analysis_options_t const & options, cancellation_token_t const & cancelled = cancellation_token_t( ) );
+
+		/// <summary>Analyse every export on the task pool, as many at once as memory allows.  Results are in
+		/// the order of filenames</summary>
+		::std::vector<file_report_t> analyse_files( ::std::vector<::std::string> const & filenames, analysis_options_t const & options, cancellation_token_t const & cancelled = cancellation_token_t( ) );
+
+		/// <summary>One JSON document with an array of files</summary>
+		void write_reports_json( ::std::ostream & out, ::std::vector<file_report_t> const & reports );
+
+		/// <summary>One CSV table, a row per file summary, window and bin.  The record column says which</summary>
+		void write_reports_csv( ::std::ostream & out, ::std::vector<file_report_t> const & reports );
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
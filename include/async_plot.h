@@ -0,0 +1,85 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <wx/wx.h>
+
+#include "cancellation.h"
+#include "panel_generic_plot.h"
+#include "task_pool.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Builds a display list on a worker thread.  Text is measured
+		/// with text_metrics_t as a wxDC cannot be used off the UI thread.
+		/// wx GDI objects are not thread safe either, so the graph_config_t
+		/// handed over must not be used by the UI thread afterwards.  It comes
+		/// back with the display list and both are destroyed on the UI thread,
+		/// even when the build was cancelled or threw</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class async_plot_t final {
+		public:
+			using builder_t = ::std::function<void( PanelGenericPlotter & gen_plot, graph_config_t & graph_config, cancellation_token_t const & cancelled )>;
+		private:
+			struct build_t {
+				::std::unique_ptr<graph_config_t> graph_config;
+				::std::unique_ptr<PanelGenericPlotter> plot;
+				::std::exception_ptr error;
+			};
+
+			cancellation_source_t m_cancel;
+			task_future_t<build_t> m_result;
+
+			void cancel_and_wait( );
+		public:
+			async_plot_t( );
+			/// <summary>Start building.  Must be called on the UI thread</summary>
+			/// <param name="priority">background for plots built ahead of being shown</param>
+			async_plot_t( ::std::unique_ptr<graph_config_t> graph_config, builder_t builder, task_priority_t priority = task_priority_t::interactive );
+			/// <summary>Cancels an unfinished build and waits for it to stop</summary>
+			~async_plot_t( );
+
+			async_plot_t( async_plot_t && ) = default;
+			/// <summary>Cancels and waits for an unfinished build of this one before taking rhs's</summary>
+			async_plot_t & operator=( async_plot_t && rhs );
+			async_plot_t( async_plot_t const & ) = delete;
+			async_plot_t & operator=( async_plot_t const & ) = delete;
+
+			bool valid( ) const;
+			bool is_ready( ) const;
+			/// <summary>The build is running or done, destroying it then waits for the builder</summary>
+			bool is_started( ) const;
+			/// <summary>Take the finished display list.  Rethrows anything the builder threw.  Must be called on the UI thread</summary>
+			::std::unique_ptr<PanelGenericPlotter> get( );
+		};	// async_plot_t
+
+		/// <summary>Shown in place of a plot whose display list is not ready</summary>
+		void draw_plot_placeholder( wxDC & dc, wxSize area, wxString const & text );
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
@@ -0,0 +1,88 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/wx.h>
+
+namespace daw {
+	namespace pumpdataanalysis {
+		struct batch_render_options_t {
+			wxSize size;
+			bool write_png;
+			bool write_svg;
+			size_t thread_count;	// Jobs run at once, 0 for one per task pool thread
+
+			batch_render_options_t( );
+		};	// batch_render_options_t
+
+		struct batch_render_result_t {
+			size_t files_loaded;
+			size_t images_written;
+			::std::vector<::std::string> errors;
+
+			batch_render_result_t( );
+		};	// batch_render_result_t
+
+		namespace impl {
+			class batch_t;
+		}	// namespace impl
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Render every basal test, the average basal day and the
+		/// average basal derivative of each file into out_dir without opening a
+		/// window.  Files are loaded and display lists built on the shared task
+		/// pool.  wx drawing is not thread safe, so the images are drawn and
+		/// written by draw_ready on the thread that started the batch, which must
+		/// be the UI thread or the only one using wx</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class batch_render_t final {
+			::std::shared_ptr<impl::batch_t> m_batch;
+		public:
+			batch_render_t( );
+			batch_render_t( ::std::vector<::std::string> const & filenames, ::std::string out_dir, batch_render_options_t options );
+			/// <summary>Cancels an unfinished batch</summary>
+			~batch_render_t( );
+
+			batch_render_t( batch_render_t && ) = default;
+			/// <summary>Cancels an unfinished batch of this one before taking rhs's</summary>
+			batch_render_t & operator=( batch_render_t && rhs );
+			batch_render_t( batch_render_t const & ) = delete;
+			batch_render_t & operator=( batch_render_t const & ) = delete;
+
+			bool valid( ) const;
+			/// <summary>Draw and write the plots whose display lists are ready, waiting up to timeout for one
+			/// when none are.  True once every file is done</summary>
+			bool draw_ready( ::std::chrono::milliseconds timeout = ::std::chrono::milliseconds( 0 ) );
+			/// <summary>Drop the queued work and wait for what is running to stop.  Leaves it invalid</summary>
+			void cancel( );
+			/// <summary>Counts and errors of a batch draw_ready has finished.  Leaves it invalid</summary>
+			batch_render_result_t get( );
+		};	// batch_render_t
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
@@ -0,0 +1,54 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace daw {
+	namespace bench {
+		struct sample_stats_t {
+			size_t count = 0;
+			double min = 0.0;
+			double median = 0.0;
+			double p95 = 0.0;
+			double max = 0.0;
+			double mean = 0.0;
+		};	// sample_stats_t
+
+		/// <summary>Order statistics of samples, p95 by nearest rank</summary>
+		sample_stats_t summarize( ::std::vector<double> samples );
+
+		struct run_limits_t {
+			size_t min_runs = 3;
+			size_t max_runs = 50;
+			double min_seconds = 1.0;	// Keep running until this much time was measured or max_runs
+		};	// run_limits_t
+
+		/// <summary>Seconds each run of body took.  setup runs before every run and is not timed</summary>
+		::std::vector<double> time_runs( run_limits_t const & limits, ::std::function<void( )> const & setup, ::std::function<void( )> const & body );
+	}	// namespace bench
+}	// namespace daw
+
@@ -0,0 +1,67 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+namespace daw {
+	//////////////////////////////////////////////////////////////////////////
+	/// <summary>Thrown by work that stopped because it was cancelled</summary>
+	//////////////////////////////////////////////////////////////////////////
+	struct operation_cancelled_t: public ::std::runtime_error {
+		operation_cancelled_t( );
+	};	// operation_cancelled_t
+
+	//////////////////////////////////////////////////////////////////////////
+	/// <summary>Read side of a cancellation_source_t, handed to the work.
+	/// Long running work checks it between blocks.  A default constructed
+	/// token is never cancelled</summary>
+	//////////////////////////////////////////////////////////////////////////
+	class cancellation_token_t final {
+		::std::shared_ptr<::std::atomic<bool> const> m_flag;
+	public:
+		cancellation_token_t( ) = default;
+		explicit cancellation_token_t( ::std::shared_ptr<::std::atomic<bool> const> flag );
+
+		bool is_cancelled( ) const;
+		/// <summary>Throws operation_cancelled_t once cancelled</summary>
+		void throw_if_cancelled( ) const;
+	};	// cancellation_token_t
+
+	//////////////////////////////////////////////////////////////////////////
+	/// <summary>Owned by whoever started the work and may stop it</summary>
+	//////////////////////////////////////////////////////////////////////////
+	class cancellation_source_t final {
+		::std::shared_ptr<::std::atomic<bool>> m_flag;
+	public:
+		cancellation_source_t( );
+
+		cancellation_token_t token( ) const;
+		void cancel( );
+		bool is_cancelled( ) const;
+	};	// cancellation_source_t
+}	// namespace daw
+
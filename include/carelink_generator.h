@@ -0,0 +1,60 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace daw {
+	namespace pumpdataanalysis {
+		struct carelink_generator_options_t {
+			size_t days = 30;
+			uint64_t seed = 1;	// Same seed and options give the same bytes on every platform
+			size_t meals_per_day = 3;
+			double meal_marker_chance = 0.3;	// Meals also logged as a journal entry
+			double temp_basal_chance = 0.1;	// Days with a temporary basal rate
+			double gap_chance = 0.02;	// Chance per hour of the sensor dropping out for up to two hours
+			size_t sensor_change_days = 6;	// A sensor change leaves a two hour gap
+			double empty_row_chance = 0.01;	// Rows with nothing but an index, cleaning removes them
+		};	// carelink_generator_options_t
+
+		struct carelink_generator_result_t {
+			size_t rows = 0;	// Data rows, not counting the preamble and header
+			size_t bytes = 0;
+		};	// carelink_generator_result_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Write a synthetic CareLink export: a preamble, the header on
+		/// row 11 as the loader expects, then 5 minute sensor readings with
+		/// meals, boluses, journal entries, temporary basal rates, sensor gaps
+		/// and empty rows in time order.  Deterministic, it uses its own random
+		/// number generator and no std distributions</summary>
+		//////////////////////////////////////////////////////////////////////////
+		carelink_generator_result_t generate_carelink_csv( ::std::ostream & out, carelink_generator_options_t const & options );
+		carelink_generator_result_t generate_carelink_csv( ::std::string const & filename, carelink_generator_options_t const & options );
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
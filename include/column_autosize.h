@@ -0,0 +1,65 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <daw/csv_helper/data_table.h>
+
+#include "cancellation.h"
+#include "compact_table.h"
+#include "task_pool.h"
+#include "text_metrics.h"
+
+namespace daw {
+	namespace data {
+		struct column_autosize_options_t {
+			size_t head_rows = 32;	// First rows of the file
+			size_t tail_rows = 32;	// Last rows of the file
+			size_t extreme_rows = 4;	// Longest text and smallest/largest numbers of each column
+			size_t random_rows = 256;	// One random row from each of this many even slices of the rest
+			int padding = 12;
+			int min_width = 40;
+			int max_width = 480;
+		};	// column_autosize_options_t
+
+		/// <summary>Rows measured in every column: the head and tail of the table and a stratified random
+		/// sample of the rows between.  Sorted and without duplicates</summary>
+		::std::vector<size_t> autosize_sample_rows( size_t row_count, column_autosize_options_t const & options );
+
+		using cell_to_text_t = ::std::function<::std::string( daw::data::compact_table_t::value_type::value_type const & )>;
+
+		/// <summary>Measure a sample of each column on a worker thread.  The result has one width per column,
+		/// wide enough for the header and for the widest sampled cell</summary>
+		/// <param name="keep_alive">Owner of table, held until the worker is done</param>
+		/// <param name="cancelled">Checked before each column.  Cancel it before waiting on a result that is no
+		/// longer wanted, waiting on a task that has not started runs it on the waiting thread</param>
+		task_future_t<::std::vector<int>> start_column_autosize( ::std::shared_ptr<void const> keep_alive, daw::data::compact_table_t const & table, cell_to_text_t cell_to_text, ::std::shared_ptr<daw::pumpdataanalysis::text_metrics_t const> metrics, daw::pumpdataanalysis::text_metrics_t::font_key_t cell_font, daw::pumpdataanalysis::text_metrics_t::font_key_t label_font, cancellation_token_t cancelled, column_autosize_options_t options = column_autosize_options_t( ) );
+	}	// namespace data
+}	// namespace daw
+
@@ -0,0 +1,219 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <daw/csv_helper/data_cell.h>
+#include <daw/csv_helper/data_table.h>
+
+#include "defs.h"
+#include "lazy_column.h"
+#include "packed_cell.h"
+#include "sparse_column.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>A column as it is loaded, before compact_table_t decides how to store it</summary>
+		struct dense_column_t {
+			::std::string header;
+			::std::vector<DataCell> cells;
+		};	// dense_column_t
+
+		/// <summary>Moves the cells out of a table made by the csv_helper parser</summary>
+		::std::vector<dense_column_t> to_dense_columns( DataTable & table );
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Read only view of a column of a compact_table_t, whether it
+		/// is stored densely, sparsely or lazily.  Cheap to copy, valid while
+		/// the table is</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class column_view_t final {
+			dense_column_t const * m_dense;	// Always set, holds the header and no cells when the column is sparse or packed
+			sparse_column_t const * m_sparse;
+			::std::vector<packed_cell_t> const * m_packed;
+			string_arena_t const * m_arena;
+			lazy_column_t const * m_lazy;
+		public:
+#if PACK_VARIANT
+			using value_type = cell_ref_t;
+			using reference = cell_ref_t;	// Made on each read, a packed column has no DataCell to refer to
+#else
+			using value_type = DataCell;
+			using reference = DataCell const &;
+#endif
+			using size_type = size_t;
+
+			class const_iterator final: public ::std::iterator<::std::forward_iterator_tag, value_type const, ::std::ptrdiff_t, value_type const *, reference> {
+				column_view_t const * m_column;
+				size_t m_row;
+			public:
+				const_iterator( column_view_t const * column, size_t row ):
+						m_column( column ),
+						m_row( row ) { }
+
+				reference operator*( ) const {
+					return (*m_column)[m_row];
+				}
+
+				const_iterator & operator++( ) {
+					++m_row;
+					return *this;
+				}
+
+				const_iterator operator++( int ) {
+					auto result = *this;
+					++m_row;
+					return result;
+				}
+
+				bool operator==( const_iterator const & rhs ) const {
+					return m_row == rhs.m_row;
+				}
+
+				bool operator!=( const_iterator const & rhs ) const {
+					return m_row != rhs.m_row;
+				}
+			};	// const_iterator
+
+			column_view_t( dense_column_t const & dense, sparse_column_t const * sparse, ::std::vector<packed_cell_t> const * packed, lazy_column_t const * lazy, string_arena_t const & arena );
+
+#if PACK_VARIANT
+			reference operator[]( size_t row ) const {
+				if( nullptr != m_packed ) {
+					return cell_ref_t( (*m_packed)[row], *m_arena );
+				}
+				if( nullptr != m_sparse ) {
+					return cell_ref_t( (*m_sparse)[row], *m_arena );
+				}
+				if( nullptr != m_lazy ) {
+					return (*m_lazy)[row];
+				}
+				return cell_ref_t( m_dense->cells[row] );
+			}
+#else
+			reference operator[]( size_t row ) const {
+				if( nullptr != m_lazy ) {
+					return (*m_lazy)[row];
+				}
+				return nullptr == m_sparse ? m_dense->cells[row] : (*m_sparse)[row];
+			}
+#endif
+
+			size_t size( ) const;
+			bool empty( ) const;
+			::std::string const & header( ) const;
+			bool is_sparse( ) const;
+			bool is_packed( ) const;
+			/// <summary>Parsed on first read, see lazy_column_t</summary>
+			bool is_lazy( ) const;
+			/// <summary>Reading row would not parse anything, always true unless lazy</summary>
+			bool is_decoded( size_t row ) const;
+			/// <summary>Bytes of one stored cell</summary>
+			size_t cell_size( ) const;
+			/// <summary>Bytes held by the column's cells, not counting text the cells keep on the heap or in the table's arena</summary>
+			size_t footprint( ) const;
+
+		/// <summary>Iterators refer to this view, it must outlive them</summary>
+			const_iterator begin( ) const;
+			const_iterator end( ) const;
+		};	// column_view_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>A loaded table whose mostly empty columns are kept sparse.
+		/// Carelink exports have dozens of columns that only hold a value in a
+		/// few rows, stored densely each of those empty cells costs a whole
+		/// DataCell.  Columns are read through column_view_t so whoever reads
+		/// them does not care how they are stored.  Which columns are sparse
+		/// is decided once, when the table is made.  With PACK_VARIANT the
+		/// dense columns are also packed into packed_cell_t, four to a cache
+		/// line, and the columns kept dense stay as DataCell.  Columns left
+		/// lazy by the parser are kept as lazy_column_t</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class compact_table_t final {
+			::std::vector<dense_column_t> m_dense;	// Every column, sparse and packed ones without cells
+			::std::vector<::std::unique_ptr<sparse_column_t const>> m_sparse;	// Per column, nullptr when dense
+			::std::vector<::std::vector<packed_cell_t>> m_packed;	// Per column, empty unless packed
+			string_arena_t m_arena;	// Long text of the packed and sparse cells
+			::std::vector<::std::unique_ptr<lazy_column_t const>> m_lazy;	// Per column, nullptr unless lazy
+			::std::vector<column_view_t> m_views;
+
+			void bind_views( );
+		public:
+			using value_type = column_view_t;
+			using size_type = size_t;
+			using const_iterator = ::std::vector<column_view_t>::const_iterator;
+
+			/// <summary>Columns with a smaller fraction of rows holding a value are stored sparsely</summary>
+#if USE_SPARSE_VECTOR
+			static constexpr double default_max_sparse_density = 0.5;
+#else
+			static constexpr double default_max_sparse_density = 0.0;
+#endif
+
+			compact_table_t( );
+			/// <param name="keep_dense">Columns for which it returns true stay dense, such as those still to be written</param>
+			explicit compact_table_t( ::std::vector<dense_column_t> columns, ::std::function<bool( ::std::string const & header )> keep_dense = nullptr, double max_sparse_density = default_max_sparse_density );
+			/// <param name="lazy">Per column, those set are kept as they are and their dense column has no cells</param>
+			compact_table_t( ::std::vector<dense_column_t> columns, ::std::vector<::std::unique_ptr<lazy_column_t const>> lazy, ::std::function<bool( ::std::string const & header )> keep_dense = nullptr, double max_sparse_density = default_max_sparse_density );
+			/// <summary>Moves the cells out of a table made by the csv_helper parser</summary>
+			explicit compact_table_t( DataTable table, ::std::function<bool( ::std::string const & header )> keep_dense = nullptr, double max_sparse_density = default_max_sparse_density );
+
+			~compact_table_t( ) = default;
+			compact_table_t( compact_table_t const & ) = delete;
+			compact_table_t & operator=( compact_table_t const & ) = delete;
+			compact_table_t( compact_table_t && other );
+			compact_table_t & operator=( compact_table_t && rhs );
+
+			column_view_t const & operator[]( size_t col ) const;
+			/// <summary>Throws std::out_of_range when there is no such column</summary>
+			column_view_t const & operator[]( ::std::string const & header ) const;
+			size_t size( ) const;
+			bool empty( ) const;
+			const_iterator begin( ) const;
+			const_iterator end( ) const;
+
+			/// <summary>Number of columns stored sparsely</summary>
+			size_t sparse_count( ) const;
+			/// <summary>Number of dense columns stored as packed_cell_t</summary>
+			size_t packed_count( ) const;
+			/// <summary>Bytes held by the text too long to keep in a packed cell</summary>
+			size_t arena_footprint( ) const;
+			/// <summary>Number of columns stored lazily</summary>
+			size_t lazy_count( ) const;
+			/// <summary>Bytes of the text kept for the lazy columns, 0 without any</summary>
+			size_t lazy_source_footprint( ) const;
+
+			/// <summary>Writable cells of a column kept dense, as when converting them after the table is
+			/// published.  Throws std::out_of_range when there is no such column or it is not kept dense</summary>
+			::std::vector<DataCell> & dense_cells( ::std::string const & header );
+		};	// compact_table_t
+	}	// namespace data
+}	// namespace daw
+
@@ -0,0 +1,72 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "compact_table.h"
+
+namespace daw {
+	namespace data {
+		struct csv_parse_options_t {
+			size_t header_row = 0;	// Rows before the header are skipped, such as the preamble of a Carelink export
+			::std::function<bool( ::std::string const & header )> column_filter;	// Columns it returns false for are not loaded, all are when empty
+			::std::function<bool( ::std::string const & header )> parse_now;	// Loaded columns it returns false for are left lazy, all are parsed when empty
+			bool skip_empty_rows = false;	// Rows without a value in any loaded column but the first are never stored
+			::std::function<void( size_t bytes_done, size_t bytes_total )> on_progress;	// Called every few MiB, throwing from it aborts the parse
+		};	// csv_parse_options_t
+
+		struct csv_parse_result_t {
+			::std::vector<dense_column_t> columns;	// Loaded columns in file order, lazy ones without cells
+			::std::vector<::std::unique_ptr<lazy_column_t const>> lazy;	// Per column, nullptr when parsed
+			size_t bytes = 0;	// Size of the text parsed
+			size_t rows_read = 0;	// Rows after the header
+			size_t rows_skipped = 0;
+		};	// csv_parse_result_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Parse comma separated text into columns of typed cells in
+		/// one pass.  Fields may be quoted, with "" for a quote.  A field that
+		/// is entirely a number becomes a real, an empty one an empty cell and
+		/// anything else text.  Rows are checked for values as they are read,
+		/// so with skip_empty_rows an empty row costs nothing but the read.
+		/// Columns left lazy by parse_now only have their rows' offsets kept,
+		/// text is then kept by their lazy_column_t</summary>
+		//////////////////////////////////////////////////////////////////////////
+		csv_parse_result_t parse_csv_columns( ::std::string text, csv_parse_options_t const & options );
+
+		/// <summary>Reads the whole of filename then parses it.  Throws std::runtime_error when it cannot be read</summary>
+		csv_parse_result_t parse_csv_file( ::std::string const & filename, csv_parse_options_t const & options );
+
+		/// <summary>Parse field number field of the row starting at row_offset of text into a cell, as
+		/// parse_csv_columns would have</summary>
+		DataCell decode_csv_field( boost::string_ref text, size_t row_offset, size_t field );
+	}	// namespace data
+}	// namespace daw
+
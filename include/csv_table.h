@@ -23,29 +23,45 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <wx/grid.h>
 
 #include <daw/csv_helper/data_table.h>
 
+#include "column_autosize.h"
+#include "compact_table.h"
+#include "formatted_cell_cache.h"
 #include "pump_data_analysis.h"
+#include "row_view.h"
+#include "text_search.h"
 
 namespace daw {
 	namespace data {
-		/// Provides a link to <c>daw::data::DataTable</c> from wxWidgets
+		/// <summary>Text of a cell as the grid shows it.  Safe to call off the UI thread</summary>
+		::std::string cell_to_text( daw::data::compact_table_t::value_type::value_type const & cell );
+
+		/// Provides a link to <c>daw::data::compact_table_t</c> from wxWidgets
 		class CSVTable;
 		void swap( CSVTable & lhs, CSVTable & rhs ) noexcept;
 
 		class CSVTable final: public wxGridTableBase {
-			inline void set_valid( bool valid ) {
-				m_valid = valid;
-			}
 			std::shared_ptr<daw::pumpdataanalysis::PumpDataAnalysis> m_data_analysis;
-			bool m_valid;
-
+			size_t m_row_count;	// Rows the grid has been told of
+			::std::shared_ptr<formatted_cell_cache_t> m_cell_cache;
+			::std::shared_ptr<prerendered_timestamps_t> m_timestamps;
+			int m_timestamp_col;	// -1 not looked for yet, -2 none or cancelled
+			row_view_spec_t m_view_spec;
+			::std::shared_ptr<::std::vector<size_t> const> m_view;	// Table rows in display order, nullptr shows the table as is
+			mutable ::std::shared_ptr<::std::vector<int> const> m_view_inverse;	// Grid row of each table row, built when first needed
+
+			/// <summary>Format a cell without going through the caches</summary>
+			wxString format_cell( size_t row, size_t col ) const;
+			/// <summary>Start rendering the Timestamp column in the background, once</summary>
+			void start_prerender( );
 		public:
 			CSVTable( );
-			/// <summary>Construct from a CSV Text File</summary>
-			explicit CSVTable( daw::data::parse_csv_data_param const & param );
+			/// <summary>Start loading a CSV Text File in the background</summary>
+			explicit CSVTable( ::std::string filename );
 
 			CSVTable( CSVTable const & ) = default;
 
@@ -57,7 +73,7 @@ namespace daw {
 
 			~CSVTable( );
 
-			daw::data::DataTable const & data( ) const;
+			daw::data::compact_table_t const & data( ) const;
 
 			daw::pumpdataanalysis::PumpDataAnalysis & data_analysis( );
 			daw::pumpdataanalysis::PumpDataAnalysis const & data_analysis( ) const;
@@ -68,9 +84,35 @@ namespace daw {
 			wxString GetValue( int row, int col ) override ;
 			void SetValue( int row, int col, wxString const & value ) override;
 			wxString GetColLabelValue( int col ) override;
+			wxString GetRowLabelValue( int row ) override;
 			void Clear( ) override;
 
+			/// <summary>False when the load failed</summary>
 			bool is_valid( ) const;
+			/// <summary>The columns are known and the first rows can be shown</summary>
+			bool has_table( ) const;
+			/// <summary>Every row is loaded.  Sorting, filtering and searching need this</summary>
+			bool has_data( ) const;
+			/// <summary>Stop loading and any background work on the table</summary>
+			void cancel( );
+			/// <summary>Tell the grid of rows loaded since the last call</summary>
+			/// <returns>True when rows were added</returns>
+			bool sync_rows( );
+
+			row_view_spec_t const & view_spec( ) const;
+			/// <summary>Sort and filter the rows shown.  The grid using this table is told of the new row count</summary>
+			void set_view_spec( row_view_spec_t spec );
+			/// <summary>Table row shown at grid row</summary>
+			size_t data_row( int row ) const;
+			/// <summary>Grid row showing table row data_row, -1 when it is filtered out</summary>
+			int grid_row( size_t data_row ) const;
+
+			/// <summary>Start a background search of the text cells for needle</summary>
+			::std::unique_ptr<text_search_t> start_search( ::std::string needle ) const;
+
+			/// <summary>Start measuring a sample of every column for its width on a background thread</summary>
+			/// <param name="metrics">Measured on the UI thread for cell_font and label_font</param>
+			task_future_t<::std::vector<int>> start_autosize( ::std::shared_ptr<daw::pumpdataanalysis::text_metrics_t const> metrics, wxFont const & cell_font, wxFont const & label_font, cancellation_token_t cancelled ) const;
 
 		};
 
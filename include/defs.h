@@ -22,8 +22,14 @@
 
 #pragma once
 
+// Backend of parallel.h: 0 runs ranges on the task pool, 1 uses OpenMP
 #define USE_PPL	0
-#define PACK_VARIANT 0
+// Dense columns are stored as 16 byte packed cells, see packed_cell.h.  0 keeps them as DataCell
+#define PACK_VARIANT 1
 
-#define USE_SPARSE_VECTOR 0
+// Columns mostly empty are stored sparsely, see compact_table.h.  0 keeps every column dense
+#define USE_SPARSE_VECTOR 1
+
+// Count allocations by phase, see allocation_tracker.h.  Replaces the global operator new
+#define TRACK_ALLOCATIONS 0
 
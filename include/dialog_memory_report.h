@@ -0,0 +1,56 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <wx/dialog.h>
+#include <wx/string.h>
+#include <wx/wx.h>
+
+namespace daw {
+	namespace wx {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Shows the memory report of every open file.  Refresh asks
+		/// for a new report so the effect of opening or closing views can be
+		/// watched</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class DialogMemoryReport final: public wxDialog {
+			::std::function<::std::string( )> m_make_report;
+			wxTextCtrl * m_text;
+
+			void on_refresh( wxCommandEvent & event );
+			void on_close( wxCommandEvent & event );
+		public:
+			/// <param name="make_report">Called on the UI thread for the text to show, now and on refresh</param>
+			DialogMemoryReport( wxWindow * parent, wxWindowID id, wxString const & title, ::std::function<::std::string( )> make_report, wxPoint const & pos = wxDefaultPosition );
+
+			DialogMemoryReport( ) = delete;
+			DialogMemoryReport( DialogMemoryReport const & ) = delete;
+			DialogMemoryReport & operator=( DialogMemoryReport const & ) = delete;
+			~DialogMemoryReport( );
+		};	// DialogMemoryReport
+	}
+}
+
@@ -0,0 +1,98 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <wx/wx.h>
+
+#include <daw/csv_helper/data_table.h>
+
+#include "compact_table.h"
+#include "string_helpers.h"
+#include "task_pool.h"
+
+namespace daw {
+	namespace data {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>LRU of formatted cells for the data grid.  Cells are
+		/// formatted a block of rows of one column at a time, so scrolling back
+		/// over rows already seen does not format them again.  Not thread safe,
+		/// it is only used from the UI thread</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class formatted_cell_cache_t final {
+		public:
+			static size_t const rows_per_block = 64;
+			static size_t const default_max_blocks = 1024;
+			using format_cell_t = ::std::function<wxString( size_t row, size_t col )>;
+		private:
+			struct block_t {
+				::std::vector<wxString> cells;
+				::std::list<uint64_t>::iterator lru_pos;
+			};
+			size_t m_max_blocks;
+			::std::list<uint64_t> m_lru;	// Most recently used first
+			::std::unordered_map<uint64_t, block_t> m_blocks;
+		public:
+			explicit formatted_cell_cache_t( size_t max_blocks = default_max_blocks );
+
+			/// <summary>Formatted value of a cell, formatting its block with format_cell when it is not cached</summary>
+			wxString const & get( size_t row, size_t col, size_t row_count, format_cell_t const & format_cell );
+			void clear( );
+			size_t block_count( ) const;
+		};	// formatted_cell_cache_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>A timestamp column formatted to text on a worker thread.
+		/// Rows are published in order as they are done, rows that are not
+		/// done yet are left to the caller</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class prerendered_timestamps_t final {
+			::std::vector<char> m_text;	// Per row a length byte followed by the characters
+			size_t m_stride;
+			::std::atomic<size_t> m_rows_ready;
+			::std::atomic<bool> m_cancel;
+			task_future_t<void> m_worker;
+		public:
+			/// <param name="keep_alive">Owner of column, held until the worker is done</param>
+			prerendered_timestamps_t( ::std::shared_ptr<void const> keep_alive, daw::data::compact_table_t::value_type const & column, ::std::shared_ptr<daw::string::ptime_formatter_t const> format );
+			/// <summary>Stops the worker and waits for it</summary>
+			~prerendered_timestamps_t( );
+
+			prerendered_timestamps_t( prerendered_timestamps_t const & ) = delete;
+			prerendered_timestamps_t & operator=( prerendered_timestamps_t const & ) = delete;
+
+			/// <summary>True and the text of row when it has been rendered</summary>
+			bool try_get( size_t row, wxString & out ) const;
+			size_t rows_ready( ) const;
+		};	// prerendered_timestamps_t
+	}	// namespace data
+}	// namespace daw
+
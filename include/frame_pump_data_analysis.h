@@ -25,11 +25,18 @@
 #include <memory>
 #include <wx/wx.h>
 
+#include "batch_render.h"
+
 // menu items ids
 enum {
 	MDI_REFRESH = 101,
 	MDI_CHANGE_POSITION,
-	MDI_CHANGE_SIZE
+	MDI_CHANGE_SIZE,
+	MDI_BATCH_RENDER,
+	MDI_BATCH_RENDER_TIMER,
+	MDI_TRACE_RECORD,
+	MDI_TRACE_SAVE,
+	MDI_MEMORY_REPORT
 };
 
 // Define a new frame
@@ -42,10 +49,18 @@ class FramePumpDataAnalysis: public wxMDIParentFrame {
 	void on_fullscreen( wxCommandEvent & event );
 	void on_quit( wxCommandEvent & event );
 	void on_close_all( wxCommandEvent & event );
+	void on_batch_render( wxCommandEvent & event );
+	void on_batch_render_timer( wxTimerEvent & event );
+	void on_trace_record( wxCommandEvent & event );
+	void on_trace_record_update( wxUpdateUIEvent & event );
+	void on_trace_save( wxCommandEvent & event );
+	void on_memory_report( wxCommandEvent & event );
 
 	void on_close( wxCloseEvent & event );
 
 	wxApp * m_wxapp;
+	daw::pumpdataanalysis::batch_render_t m_batch_render;
+	wxTimer m_batch_render_timer;
 
 	DECLARE_EVENT_TABLE( )
 
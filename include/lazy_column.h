@@ -0,0 +1,108 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <daw/csv_helper/data_cell.h>
+
+#include "defs.h"
+#include "packed_cell.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>Text a table was parsed from, kept for its lazy columns</summary>
+		struct csv_source_t {
+			::std::string text;
+			::std::vector<uint64_t> row_offsets;	// Where each row of the table starts in text
+		};	// csv_source_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>A column left as text when loading, for columns that the
+		/// analyses never read.  Cells are parsed from the source a block of
+		/// rows at a time, the first time a row of the block is read, and then
+		/// kept.  Safe to read from several threads, a block two threads
+		/// decode at once is kept from whichever finishes first</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class lazy_column_t final {
+		public:
+#if PACK_VARIANT
+			using value_type = packed_cell_t;
+			using reference = cell_ref_t;
+#else
+			using value_type = DataCell;
+			using reference = DataCell const &;
+#endif
+			/// <summary>Rows decoded together</summary>
+			static size_t const s_rows_per_block = 4096;
+		private:
+			struct block_t {
+				::std::vector<value_type> cells;
+				string_arena_t arena;	// Long text of the packed cells
+			};	// block_t
+
+			::std::shared_ptr<csv_source_t const> m_source;
+			size_t m_field;	// Field of the source's rows holding the column
+			::std::unique_ptr<::std::atomic<block_t const *>[]> m_blocks;
+
+			size_t block_count( ) const;
+			block_t const & block( size_t n ) const;
+		public:
+			lazy_column_t( ::std::shared_ptr<csv_source_t const> source, size_t field );
+			~lazy_column_t( );
+
+			lazy_column_t( lazy_column_t const & ) = delete;
+			lazy_column_t( lazy_column_t && ) = delete;
+			lazy_column_t & operator=( lazy_column_t const & ) = delete;
+			lazy_column_t & operator=( lazy_column_t && ) = delete;
+
+#if PACK_VARIANT
+			reference operator[]( size_t row ) const {
+				auto const & cells = block( row / s_rows_per_block );
+				return cell_ref_t( cells.cells[row % s_rows_per_block], cells.arena );
+			}
+#else
+			reference operator[]( size_t row ) const {
+				return block( row / s_rows_per_block ).cells[row % s_rows_per_block];
+			}
+#endif
+
+			size_t size( ) const;
+			/// <summary>Blocks parsed so far</summary>
+			size_t decoded_blocks( ) const;
+			/// <summary>Reading row would not parse anything</summary>
+			bool is_decoded( size_t row ) const;
+			/// <summary>Bytes held by the parsed blocks, not counting text DataCells keep on the heap</summary>
+			size_t footprint( ) const;
+			/// <summary>Bytes of the source, shared by every lazy column of a table</summary>
+			size_t source_footprint( ) const;
+		};	// lazy_column_t
+	}	// namespace data
+}	// namespace daw
+
@@ -0,0 +1,83 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	namespace pumpdataanalysis {
+		/// <summary>One bucket of a level.  At level 0 a bucket is a single sample</summary>
+		struct lod_sample_t {
+			int x_first;
+			int x_last;
+			float low;
+			float high;
+			float sum;
+			uint32_t count;
+
+			float mean( ) const;
+			int x_mid( ) const;
+		};	// lod_sample_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Min/max/mean pyramid over a series sorted by x.  Each level
+		/// halves the number of buckets of the one below it so a view can always
+		/// pick a level with about one bucket per pixel</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class lod_pyramid_t final {
+			::std::vector<::std::vector<lod_sample_t>> m_levels;
+		public:
+			lod_pyramid_t( );
+			/// <param name="xs">x values, must be sorted ascending</param>
+			/// <param name="ys">y value for each x</param>
+			lod_pyramid_t( ::std::vector<int> const & xs, ::std::vector<float> const & ys );
+
+			~lod_pyramid_t( ) = default;
+			lod_pyramid_t( lod_pyramid_t const & ) = default;
+			lod_pyramid_t( lod_pyramid_t && ) = default;
+			lod_pyramid_t & operator=( lod_pyramid_t const & ) = default;
+			lod_pyramid_t & operator=( lod_pyramid_t && ) = default;
+
+			bool empty( ) const;
+			size_t levels( ) const;
+			/// <summary>Approximate bytes held by every level</summary>
+			size_t footprint( ) const;
+			::std::vector<lod_sample_t> const & level( size_t level_no ) const;
+
+			int x_min( ) const;
+			int x_max( ) const;
+			/// <summary>Lowest and highest y over the whole series</summary>
+			::std::pair<float, float> y_minmax( ) const;
+
+			/// <summary>Index range [first, last) of the buckets in level_no overlapping [x_first, x_last]</summary>
+			::std::pair<size_t, size_t> range( size_t level_no, int x_first, int x_last ) const;
+
+			/// <summary>Finest level that has no more than max_buckets buckets within [x_first, x_last]</summary>
+			size_t level_for( int x_first, int x_last, size_t max_buckets ) const;
+		};	// lod_pyramid_t
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
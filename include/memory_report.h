@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <daw/csv_helper/data_table.h>
+
+#include "compact_table.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		struct cell_memory_t {
+			size_t cells = 0;
+			size_t bytes = 0;
+		};	// cell_memory_t
+
+		struct column_memory_t {
+			::std::string header;
+			cell_memory_t memory;	// Only the cells stored, a sparse column does not store its empty ones
+			bool sparse = false;
+			bool packed = false;
+			bool lazy = false;	// Only the blocks parsed so far are counted
+		};	// column_memory_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Bytes held by a table's cells, by column and by cell type.
+		/// A cell is its own size plus any text it keeps on the heap</summary>
+		//////////////////////////////////////////////////////////////////////////
+		struct table_memory_t {
+			static size_t const cell_type_count = 4;
+
+			::std::vector<column_memory_t> columns;
+			::std::array<cell_memory_t, cell_type_count> cell_types;	// Indexed by DataCellType
+			size_t string_arena_bytes = 0;	// Text too long to keep in a packed cell
+			size_t lazy_source_bytes = 0;	// Text kept for the lazy columns
+			size_t total_bytes = 0;
+		};	// table_memory_t
+
+		/// <summary>Walks every cell but those of lazy columns, which would parse them.  The table must not
+		/// change while it runs</summary>
+		table_memory_t measure_table_memory( daw::data::compact_table_t const & data_table );
+
+		char const * cell_type_name( daw::data::DataCellType cell_type );
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>What one loaded file costs</summary>
+		//////////////////////////////////////////////////////////////////////////
+		struct memory_report_t {
+			::std::string filename;
+			size_t file_bytes = 0;
+			size_t load_estimate = 0;	// What the task pool admitted the load with
+			table_memory_t table;
+			::std::vector<::std::pair<::std::string, size_t>> display_lists;	// Name and bytes of each view's plots
+
+			size_t display_list_bytes( ) const;
+			size_t total_bytes( ) const;
+		};	// memory_report_t
+
+		/// <summary>Report of filename, without display lists</summary>
+		memory_report_t make_memory_report( ::std::string filename, daw::data::compact_table_t const & data_table );
+
+		/// <summary>Plain text, one block per file followed by the process wide allocation counts by phase</summary>
+		void write_memory_report( ::std::ostream & os, ::std::vector<memory_report_t> const & reports );
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
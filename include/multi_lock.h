@@ -20,46 +20,149 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+
 #pragma once
 
-#include <algorithm>
 #include <mutex>
-#include <vector>
-
-#include <daw/daw_traits.h>
+#include <shared_mutex>
+#include <tuple>
+#include <utility>
 
 namespace daw {
-	template<typename MutexType = std::mutex>
-	struct multi_lock_guard {
-		multi_lock_guard( ) = delete;
-		multi_lock_guard( multi_lock_guard const & ) = delete;
-		multi_lock_guard& operator=( multi_lock_guard const & ) = delete;
-		multi_lock_guard( multi_lock_guard && ) = delete;
-		multi_lock_guard& operator=( multi_lock_guard && ) = delete;
-
-		bool operator==( multi_lock_guard const & ) const = delete;
-
-		multi_lock_guard( std::initializer_list<MutexType*> mutexes ):
-				m_mutexes{ mutexes } {
-			
-			std::sort( m_mutexes.begin( ), m_mutexes.end( ), []( MutexType const * const mutex_a, MutexType const * const mutex_b ) {
-				return mutex_a < mutex_b;
-			} );
-			for( auto m : m_mutexes ) {
-				m->lock( );
-			}
+	/// <summary>Mutex readers can hold together.  C++14 only has the timed one</summary>
+	using shared_mutex_t = ::std::shared_timed_mutex;
+
+	/// <summary>Lockable taking the exclusive side of a mutex</summary>
+	template<typename Mutex>
+	class exclusive_side_t final {
+		Mutex * m_mutex;
+	public:
+		explicit exclusive_side_t( Mutex & mutex ):
+				m_mutex( &mutex ) { }
+
+		void lock( ) {
+			m_mutex->lock( );
+		}
+
+		bool try_lock( ) {
+			return m_mutex->try_lock( );
+		}
+
+		void unlock( ) {
+			m_mutex->unlock( );
 		}
+	};	// exclusive_side_t
+
+	/// <summary>Lockable taking the shared side of a mutex, so std::lock can take it</summary>
+	template<typename SharedMutex>
+	class shared_side_t final {
+		SharedMutex * m_mutex;
+	public:
+		explicit shared_side_t( SharedMutex & mutex ):
+				m_mutex( &mutex ) { }
+
+		void lock( ) {
+			m_mutex->lock_shared( );
+		}
+
+		bool try_lock( ) {
+			return m_mutex->try_lock_shared( );
+		}
+
+		void unlock( ) {
+			m_mutex->unlock_shared( );
+		}
+	};	// shared_side_t
+
+	template<typename Mutex>
+	exclusive_side_t<Mutex> exclusive_side( Mutex & mutex ) {
+		return exclusive_side_t<Mutex>( mutex );
+	}
+
+	template<typename SharedMutex>
+	shared_side_t<SharedMutex> shared_side( SharedMutex & mutex ) {
+		return shared_side_t<SharedMutex>( mutex );
+	}
 
-		~multi_lock_guard( ) {
-			for( auto m = std::rbegin( m_mutexes ); m != std::rend( m_mutexes ); ++m ) {
-				(*m)->unlock( );
+	namespace impl {
+		template<typename Lockable>
+		void lock_all( Lockable & lockable ) {
+			lockable.lock( );
+		}
+
+		template<typename Lockable1, typename Lockable2, typename... Lockables>
+		void lock_all( Lockable1 & lockable1, Lockable2 & lockable2, Lockables & ... lockables ) {
+			::std::lock( lockable1, lockable2, lockables... );
+		}
+
+		template<typename Tuple, size_t... Is>
+		void lock_tuple( Tuple & lockables, ::std::index_sequence<Is...> ) {
+			lock_all( ::std::get<Is>( lockables )... );
+		}
+
+		template<typename Tuple, size_t... Is>
+		void unlock_tuple( Tuple & lockables, ::std::index_sequence<Is...> ) {
+			// Last locked first released, std::lock may have taken them in any order
+			using expand_t = int[];
+			(void)expand_t{ 0, (::std::get<sizeof...(Is) - 1 - Is>( lockables ).unlock( ), 0)... };
+		}
+	}	// namespace impl
+
+	//////////////////////////////////////////////////////////////////////////
+	/// <summary>Holds every Lockable locked for its lifetime.  They are taken
+	/// together with std::lock's deadlock avoidance, so two threads locking
+	/// the same mutexes in different orders cannot deadlock.  Lives on the
+	/// stack, nothing is allocated or sorted</summary>
+	//////////////////////////////////////////////////////////////////////////
+	template<typename... Lockables>
+	class multi_lock_t final {
+		static_assert( sizeof...(Lockables) > 0, "Nothing to lock" );
+		::std::tuple<Lockables...> m_lockables;
+		bool m_owns;
+	public:
+		explicit multi_lock_t( Lockables... lockables ):
+				m_lockables( ::std::move( lockables )... ),
+				m_owns( true ) {
+
+			impl::lock_tuple( m_lockables, ::std::index_sequence_for<Lockables...>( ) );
+		}
+
+		~multi_lock_t( ) {
+			if( m_owns ) {
+				impl::unlock_tuple( m_lockables, ::std::index_sequence_for<Lockables...>( ) );
 			}
 		}
-	
-	private:
-		std::vector<MutexType*> m_mutexes;
-	};
 
-	using multi_lock_guard_t = multi_lock_guard<>;
-}
+		/// <summary>Only so it can be returned from the make_ functions, C++14 cannot elide the copy</summary>
+		multi_lock_t( multi_lock_t && other ):
+				m_lockables( ::std::move( other.m_lockables ) ),
+				m_owns( other.m_owns ) {
+
+			other.m_owns = false;
+		}
+
+		multi_lock_t( multi_lock_t const & ) = delete;
+		multi_lock_t & operator=( multi_lock_t const & ) = delete;
+		multi_lock_t & operator=( multi_lock_t && ) = delete;
+	};	// multi_lock_t
+
+	/// <summary>Exclusive locks on every mutex.  auto const lock = daw::make_multi_lock( a, b );</summary>
+	template<typename... Mutexes>
+	multi_lock_t<exclusive_side_t<Mutexes>...> make_multi_lock( Mutexes & ... mutexes ) {
+		return multi_lock_t<exclusive_side_t<Mutexes>...>( exclusive_side( mutexes )... );
+	}
+
+	/// <summary>Shared locks on every mutex, readers of the same data do not wait on each other</summary>
+	template<typename... SharedMutexes>
+	multi_lock_t<shared_side_t<SharedMutexes>...> make_shared_multi_lock( SharedMutexes & ... mutexes ) {
+		return multi_lock_t<shared_side_t<SharedMutexes>...>( shared_side( mutexes )... );
+	}
+
+	/// <summary>Any mix of sides, e.g. reading one table while writing another:
+	/// auto const lock = daw::make_mixed_multi_lock( daw::shared_side( src ), daw::exclusive_side( dst ) );</summary>
+	template<typename... Lockables>
+	multi_lock_t<Lockables...> make_mixed_multi_lock( Lockables... lockables ) {
+		return multi_lock_t<Lockables...>( ::std::move( lockables )... );
+	}
+}	// namespace daw
 
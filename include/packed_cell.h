@@ -0,0 +1,150 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <daw/csv_helper/data_cell.h>
+
+namespace daw {
+	namespace data {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Text of a table's cells that is too long to keep inside a
+		/// packed_cell_t, stored end to end.  Only added to while the table is
+		/// made, readers then share it without a lock</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class string_arena_t final {
+			::std::vector<char> m_text;
+		public:
+			string_arena_t( );
+
+			/// <summary>Copy text to the end of the arena.  Returns the offset of the copy</summary>
+			uint32_t add( boost::string_ref text );
+
+			boost::string_ref get( uint32_t offset, uint32_t size ) const {
+				return boost::string_ref( m_text.data( ) + offset, size );
+			}
+
+			size_t size( ) const;
+			/// <summary>Bytes held, including any capacity not yet used</summary>
+			size_t footprint( ) const;
+			void shrink_to_fit( );
+		};	// string_arena_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>A cell in 16 bytes, a quarter of a cache line.  Text of up
+		/// to inline_capacity characters is kept in the cell, longer text in
+		/// the table's string_arena_t.  Reals and timestamps take the first 8
+		/// bytes.  The text of a cell can only be read with the arena it was
+		/// packed with</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class packed_cell_t final {
+		public:
+			static size_t const inline_capacity = 14;
+		private:
+			enum class tag_t: uint8_t { empty = 0, inline_string, arena_string, real, timestamp };
+
+			char m_bytes[inline_capacity];	// Values are copied in and out, so need no alignment
+			tag_t m_tag;
+			uint8_t m_size;	// Length of inline text, or 1 for a timestamp that is not a date time
+		public:
+			packed_cell_t( );
+			/// <summary>Text longer than inline_capacity is copied to arena</summary>
+			packed_cell_t( DataCell const & cell, string_arena_t & arena );
+
+			~packed_cell_t( ) = default;
+			packed_cell_t( packed_cell_t const & ) = default;
+			packed_cell_t( packed_cell_t && ) = default;
+			packed_cell_t & operator=( packed_cell_t const & ) = default;
+			packed_cell_t & operator=( packed_cell_t && ) = default;
+
+			DataCellType type( ) const;
+
+			bool empty( ) const {
+				return tag_t::empty == m_tag;
+			}
+
+			real_t real( ) const;
+			timestamp_t timestamp( ) const;
+			/// <summary>Refers to the cell or to arena, valid while both are</summary>
+			boost::string_ref string( string_arena_t const & arena ) const;
+		};	// packed_cell_t
+
+		static_assert( sizeof( packed_cell_t ) == 16, "packed_cell_t must stay a quarter of a cache line" );
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>A cell as read from a compact_table_t when it is built with
+		/// PACK_VARIANT.  It has the read interface of a DataCell whether the
+		/// column is packed or not, but the text is a string_ref into the
+		/// table.  Made by value on each read and valid while the table is</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class cell_ref_t final {
+			DataCell const * m_cell;	// Set when the column is not packed
+			packed_cell_t const * m_packed;
+			string_arena_t const * m_arena;
+		public:
+			explicit cell_ref_t( DataCell const & cell ):
+					m_cell( &cell ),
+					m_packed( nullptr ),
+					m_arena( nullptr ) { }
+
+			cell_ref_t( packed_cell_t const & cell, string_arena_t const & arena ):
+					m_cell( nullptr ),
+					m_packed( &cell ),
+					m_arena( &arena ) { }
+
+			DataCellType type( ) const {
+				return nullptr != m_cell ? m_cell->type( ) : m_packed->type( );
+			}
+
+			bool empty( ) const {
+				return nullptr != m_cell ? m_cell->empty( ) : m_packed->empty( );
+			}
+
+			explicit operator bool( ) const {
+				return !empty( );
+			}
+
+			real_t real( ) const {
+				return nullptr != m_cell ? m_cell->real( ) : m_packed->real( );
+			}
+
+			timestamp_t timestamp( ) const {
+				return nullptr != m_cell ? m_cell->timestamp( ) : m_packed->timestamp( );
+			}
+
+			boost::string_ref string( ) const {
+				return nullptr != m_cell ? boost::string_ref( m_cell->string( ) ) : m_packed->string( *m_arena );
+			}
+
+			/// <summary>Formatted as DataCell::to_string formats it</summary>
+			::std::string to_string( ) const;
+		};	// cell_ref_t
+	}	// namespace data
+}	// namespace daw
+
@@ -0,0 +1,59 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <memory>
+#include <wx/wx.h>
+
+#include "async_plot.h"
+#include "panel_generic_plot.h"
+
+//////////////////////////////////////////////////////////////////////////
+/// <summary>Panel whose display list is built on a worker thread.  A
+/// placeholder is painted until the list is ready</summary>
+//////////////////////////////////////////////////////////////////////////
+class PanelAsyncPlot: public wxPanel {
+	daw::pumpdataanalysis::async_plot_t m_pending;
+	::std::unique_ptr<daw::pumpdataanalysis::PanelGenericPlotter> m_gen_plot;
+	wxString m_status;
+	wxTimer m_timer;
+public:
+	PanelAsyncPlot( wxWindow *parent, wxPoint position = wxDefaultPosition, wxSize sz = wxDefaultSize );
+	virtual ~PanelAsyncPlot( );
+
+	bool is_plot_ready( ) const;
+	/// <summary>Bytes held by the display list, 0 until it is built</summary>
+	size_t display_list_bytes( ) const;
+
+protected:
+	/// <summary>Start building the display list, replacing any previous one</summary>
+	void build_plot( ::std::unique_ptr<daw::pumpdataanalysis::graph_config_t> graph_config, daw::pumpdataanalysis::async_plot_t::builder_t builder );
+
+private:
+	void on_paint( wxPaintEvent& event );
+	void on_timer( wxTimerEvent& event );
+
+	DECLARE_EVENT_TABLE( )
+};
+
@@ -33,27 +33,26 @@
 #include <daw/csv_helper/data_common.h>
 
 #include "aggregate_data.h"
+#include "compact_table.h"
+#include "panel_async_plot.h"
 #include "panel_generic_plot.h"
 
+namespace daw {
+	namespace pumpdataanalysis {
+		/// <summary>Add the average, range and standard deviation of aggregate_data over a day to gen_plot</summary>
+		void build_average_basal_plot( PanelGenericPlotter& gen_plot, const ::std::vector<daw::AggregateData<daw::data::real_t>>& aggregate_data, graph_config_t graph_config );
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
 //////////////////////////////////////////////////////////////////////////
 /// <summary>Display an aggregate of all basal tests over a 24hr period</summary>
 //////////////////////////////////////////////////////////////////////////
 
-class PanelAverageBasal: public wxPanel {
-	const daw::data::DataTable& m_data;
+class PanelAverageBasal: public PanelAsyncPlot {
+	const daw::data::compact_table_t& m_data;
 	const ::std::vector<std::pair<size_t, size_t>> m_basal_positions;
-	daw::data::real_t m_bg_min;
-	daw::data::real_t m_bg_max;
-	const int32_t m_points_x = 24 * 12;
-	std::unique_ptr<daw::AggregateDataVector<daw::data::real_t>> m_aggregate_vec;
 	const ::std::function<void( wxMenuBar* menu )> m_addmenu_cb;
 public:
-	PanelAverageBasal( wxWindow *parent, ::std::function<void( wxMenuBar* menu )> addmenu_cb, const daw::data::DataTable& dt, const ::std::vector<std::pair<daw::data::DataTable::size_type, daw::data::DataTable::size_type>> positions );
-
-private:
-	daw::pumpdataanalysis::PanelGenericPlotter m_gen_plot;
-	void on_paint( wxPaintEvent& event );
-	void plot( wxDC& dc, wxSize bounds );
-	DECLARE_EVENT_TABLE( )
+	PanelAverageBasal( wxWindow *parent, ::std::function<void( wxMenuBar* menu )> addmenu_cb, const daw::data::compact_table_t& dt, const ::std::vector<std::pair<daw::data::compact_table_t::size_type, daw::data::compact_table_t::size_type>> positions );
 };
 
@@ -33,27 +33,19 @@
 #include <daw/daw_math.h>
 
 #include "aggregate_data.h"
+#include "compact_table.h"
+#include "panel_async_plot.h"
 #include "panel_generic_plot.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /// <summary>Display an aggregate of all basal test derivatives(slope over a 24hr period</summary>
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class PanelAverageBasalDerivative: public wxPanel {
-	const daw::data::DataTable& m_data;
+class PanelAverageBasalDerivative: public PanelAsyncPlot {
+	const daw::data::compact_table_t& m_data;
 	const ::std::vector<std::pair<size_t, size_t>> m_basal_positions;
-	daw::data::real_t m_bg_min;
-	daw::data::real_t m_bg_max;
-	const int32_t m_points_x = 24 * 12;
-	std::unique_ptr<daw::AggregateDataVector<daw::data::real_t>> m_aggregate_vec;
 	const ::std::function<void( wxMenuBar* menu )> m_addmenu_cb;
 public:
-	PanelAverageBasalDerivative( wxWindow *parent, ::std::function<void( wxMenuBar* menu )> addmenu_cb, const daw::data::DataTable& dt, const ::std::vector<std::pair<daw::data::DataTable::size_type, daw::data::DataTable::size_type>> positions );
-
-private:
-	daw::pumpdataanalysis::PanelGenericPlotter m_gen_plot;
-	void on_paint( wxPaintEvent& event );
-	void plot( wxDC& dc, wxSize bounds );
-	DECLARE_EVENT_TABLE( )
+	PanelAverageBasalDerivative( wxWindow *parent, ::std::function<void( wxMenuBar* menu )> addmenu_cb, const daw::data::compact_table_t& dt, const ::std::vector<std::pair<daw::data::compact_table_t::size_type, daw::data::compact_table_t::size_type>> positions );
 };
 
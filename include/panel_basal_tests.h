@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <wx/listbox.h>
+#include <wx/wx.h>
+
+#include <daw/csv_helper/data_common.h>
+
+#include "async_plot.h"
+#include "compact_table.h"
+#include "panel_generic_plot.h"
+
+//////////////////////////////////////////////////////////////////////////
+/// <summary>List of basal tests with a single plot area.  Display lists are
+/// only built for the test being viewed and its neighbours, in parallel on
+/// worker threads, and are kept in a LRU cache that is trimmed to a memory
+/// budget</summary>
+//////////////////////////////////////////////////////////////////////////
+class PanelBasalTests: public wxPanel {
+	struct cached_plot_t {
+		::std::unique_ptr<daw::pumpdataanalysis::PanelGenericPlotter> plot;
+		size_t bytes;
+		::std::list<size_t>::iterator lru_pos;
+	};
+
+	struct pending_plot_t {
+		daw::pumpdataanalysis::async_plot_t plot;
+		daw::task_priority_t priority;
+	};
+
+	const daw::data::compact_table_t& m_data;
+	const ::std::vector<std::pair<size_t, size_t>> m_basal_positions;
+	const ::std::function<void( wxMenuBar* menu )> m_addmenu_cb;
+	wxListBox * m_list;
+	wxPanel * m_plot_area;
+	size_t const m_cache_budget;
+	size_t m_cache_bytes;
+	::std::list<size_t> m_lru;	// Most recently viewed first
+	::std::unordered_map<size_t, cached_plot_t> m_cache;
+	::std::unordered_map<size_t, pending_plot_t> m_pending;
+	::std::unordered_map<size_t, wxString> m_failed;
+	wxTimer m_timer;
+public:
+	static size_t const default_cache_budget = 32 * 1024 * 1024;
+	/// <summary>Tests either side of the selection that are built ahead of being viewed</summary>
+	static size_t const prefetch_radius = 2;
+
+	PanelBasalTests( wxWindow *parent, ::std::function<void( wxMenuBar* menu )> addmenu_cb, const daw::data::compact_table_t& dt, const ::std::vector<std::pair<daw::data::compact_table_t::size_type, daw::data::compact_table_t::size_type>> positions, size_t cache_budget = default_cache_budget );
+
+	/// <summary>Bytes currently held by cached display lists</summary>
+	size_t cache_bytes( ) const;
+
+private:
+	/// <summary>The cached display list for test_no or nullptr when it is not built yet</summary>
+	daw::pumpdataanalysis::PanelGenericPlotter * get_plot( size_t test_no );
+	void request_plot( size_t test_no );
+	void request_selection( );
+	/// <summary>Drop prefetches that have not started and are no longer near the selection</summary>
+	void cancel_prefetches( size_t selection );
+	void trim_cache( size_t keep_test_no );
+	void on_select( wxCommandEvent& event );
+	void on_paint_plot( wxPaintEvent& event );
+	void on_timer( wxTimerEvent& event );
+};
+
@@ -22,29 +22,17 @@
 
 #pragma once
 
-#include <functional>
 #include <wx/wx.h>
 
 #include <daw/csv_helper/data_common.h>
 
+#include "compact_table.h"
 #include "panel_generic_plot.h"
 
-//////////////////////////////////////////////////////////////////////////
-/// <summary>Display a Basal Test graphically</summary>
-//////////////////////////////////////////////////////////////////////////
-class PanelDataPlot: public wxPanel {
-	const daw::data::DataTable& m_data;
-	const daw::data::DataTable::size_type m_data_first;
-	const daw::data::DataTable::size_type m_data_last;
-	const ::std::function<void( wxMenuBar* menu )> m_addmenu_cb;
-public:
-	PanelDataPlot( wxWindow *parent, ::std::function<void( wxMenuBar* menu )> addmenu_cb, const daw::data::DataTable& dt, const daw::data::DataTable::size_type first, const daw::data::DataTable::size_type last, wxPoint position = wxDefaultPosition, wxSize sz = wxDefaultSize );
-
-private:	
-	daw::pumpdataanalysis::PanelGenericPlotter m_gen_plot;
-	void on_paint( wxPaintEvent& event );
-	void plot( wxDC& dc, wxSize bounds );
-
-	DECLARE_EVENT_TABLE( )
-};
+namespace daw {
+	namespace pumpdataanalysis {
+		/// <summary>Add the sensor readings from rows [first, last] and their axes to gen_plot</summary>
+		void build_basal_test_plot( PanelGenericPlotter& gen_plot, const daw::data::compact_table_t& data, size_t first, size_t last, graph_config_t graph_config );
+	}	// namespace pumpdataanalysis
+}	// namespace daw
 
@@ -30,7 +30,10 @@
 
 #include <daw/csv_helper/data_table.h>
 
+#include "compact_table.h"
 #include "panel_generic_plot.h"
+#include "point_array.h"
+#include "text_metrics.h"
 
 namespace daw {
 	namespace pumpdataanalysis {
@@ -140,7 +143,9 @@ namespace daw {
 				mapping_cb_t mf_map_y;
 			public:
 				virtual ~PanelGenericPlotAction( );
-				virtual void do_plot( wxDC &, translation_t & ) = 0;
+				virtual void do_plot( wxDC &, translation_t &, ::std::vector<wxPoint> & point_buffer ) = 0;
+				/// <summary>Approximate bytes held by the action, including what it owns on the heap</summary>
+				virtual size_t footprint( ) const = 0;
 
 				wxPoint map_point( point_t point, translation_t& translate_data ) const;
 			};	// PanelGenericPlotAction
@@ -158,29 +163,44 @@ namespace daw {
 			void set_pen( wxPen pen );
 			void set_font( wxFont font );
 			void set_brush( wxBrush brush );
+			/// <summary>Measure text with metrics instead of a wxMemoryDC.  Required when building the display list off the UI thread</summary>
+			void set_text_metrics( ::std::shared_ptr<text_metrics_t const> metrics );
 
 			void draw_text( wxString text, point_t point );
 			void draw_rotated_text( wxString text, point_t point, double angle );
 			void draw_line( point_t p1, point_t p2 );
 			void draw_lines( ::std::vector<point_t> points );
+			void draw_lines( point_array_t points );
 			void draw_polygon( ::std::vector<point_t> points );
+			void draw_polygon( point_array_t points );
 			void update_scale( wxSize bounds );
 			void plot( wxDC& dc, wxSize bounds );
 			void clear( );
+			/// <summary>Approximate bytes held by the display list</summary>
+			size_t footprint( ) const;
+			/// <summary>Number of actions in the display list, each is one or more wxDC calls per plot</summary>
+			size_t action_count( ) const;
 			int get_mapped_x( int x ) const;
 			int get_mapped_y( int y ) const;
+			int get_unmapped_x( int x ) const;
+			int get_unmapped_y( int y ) const;
 			point_t get_text_size( const wxString& text ) const;
 			box_t get_rotated_text_size( const wxString& text, double angle ) const;			
 			void check_minmax( point_t point );
 			void check_minmax( box_t points );
+			void check_minmax( point_array_t const & points );
 		private:
 			translation_t m_coord_data;
 			::std::vector<::std::unique_ptr<impl::PanelGenericPlotAction>> m_actions;
+			::std::vector<wxPoint> m_point_buffer;	// Reused by every action that maps a run of points
 			wxFont m_last_font;
+			::std::shared_ptr<text_metrics_t const> m_text_metrics;
 		};
 		void draw_mmol_y_axis( PanelGenericPlotter& gen_plot, graph_config_t graph_config, float at_least_y_values = 10.0f );
-		void draw_ts_x_axis( PanelGenericPlotter& gen_plot, const daw::data::DataTable::value_type& ts_col, size_t start, size_t finish, graph_config_t graph_config, float at_least_y_values = 10.0f );
+		void draw_ts_x_axis( PanelGenericPlotter& gen_plot, const daw::data::compact_table_t::value_type& ts_col, size_t start, size_t finish, graph_config_t graph_config, float at_least_y_values = 10.0f );
 		void draw_24hr_x_axis( PanelGenericPlotter& gen_plot, int increment_size, graph_config_t graph_config, float at_least_y_values = 10.0f );
+		/// <summary>Draw an x-axis over minutes since the epoch, picking a tick spacing that gives at most max_ticks labels</summary>
+		void draw_time_range_x_axis( PanelGenericPlotter& gen_plot, int first_minute, int last_minute, int max_ticks, graph_config_t graph_config, float at_least_y_values = 10.0f );
 	}	// namespace pumpdataanalysis
 } // namespace daw
 
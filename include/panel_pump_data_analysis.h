@@ -22,14 +22,19 @@
 
 #pragma once
 
+#include <memory>
 #include <thread>
 #include <vector>
+#include <wx/grid.h>
 #include <wx/notebook.h>
+#include <wx/timer.h>
 #include <wx/wx.h>
 
 #include <daw/csv_helper/data_common.h>
 
 #include "csv_table.h"
+#include "memory_report.h"
+#include "text_search.h"
 
 //////////////////////////////////////////////////////////////////////////
 /// <summary>Pump Data Grid Child Window</summary>
@@ -41,18 +46,9 @@ struct PanelPumpDataAnalyis: public wxMDIChildFrame {
 
 	static size_t GetChildrenCount( ) { return ms_number_children; }
 
-	void add_basal_test_page( wxWindow * child, wxString const & title, bool const bring_to_front = false );
 	void add_top_page( wxWindow * child, wxString const & title, bool const bring_to_front = false );
 	void add_menu_bar( wxMenuBar* menu );
 	
-	inline wxWindow* GetBasalTestWindow( ) {
-		if( nullptr == m_notebook_basal_tests ) {
-			m_notebook_basal_tests = new wxNotebook( GetTopPageWindow( ), wxID_ANY, wxDefaultPosition, wxDefaultSize, wxNB_BOTTOM );
-			add_top_page( m_notebook_basal_tests, wxT( "Basal Tests" ) );
-		}
-		return m_notebook_basal_tests;
-	}
-	
 	inline wxWindow* GetTopPageWindow( ) {
 		if( nullptr == m_notebook_main ) {
 			m_notebook_main = new wxNotebook( this, wxID_ANY, wxPoint( 0, 0 ), GetClientSize( ), wxNB_TOP );
@@ -70,22 +66,47 @@ struct PanelPumpDataAnalyis: public wxMDIChildFrame {
 	void on_close_window( wxCloseEvent& event );
 	void on_do_basal_tests( wxCommandEvent& event );
 	void on_do_correction_tests( wxCommandEvent& event );
+	void on_grid_label_click( wxGridEvent& event );
+	void on_filter_range( wxCommandEvent& event );
+	void on_filter_has_value( wxCommandEvent& event );
+	void on_clear_view( wxCommandEvent& event );
+	void on_find( wxCommandEvent& event );
+	void on_find_next( wxCommandEvent& event );
+	void on_search_timer( wxTimerEvent& event );
+	void on_autosize_timer( wxTimerEvent& event );
 	void on_finished_loading_csv_data_error( );
 	void on_finished_loading_csv_data( );
-	void on_finished_do_basal_tests( const ::std::vector<std::pair<daw::data::DataTable::size_type, daw::data::DataTable::size_type>> positions, const ::std::pair<size_t, size_t> date_range );
-	void on_finished_do_correction_tests( const ::std::vector<std::pair<daw::data::DataTable::size_type, daw::data::DataTable::size_type>> positions, const ::std::pair<size_t, size_t> date_range );
+	void on_table_available( );
+	void on_load_timer( wxTimerEvent& event );
+	void on_update_needs_data( wxUpdateUIEvent& event );
+	void on_update_needs_basal_tests( wxUpdateUIEvent& event );
+	void show_load_progress( ) const;
+	void on_finished_do_basal_tests( const ::std::vector<std::pair<daw::data::compact_table_t::size_type, daw::data::compact_table_t::size_type>> positions, const ::std::pair<size_t, size_t> date_range );
+	void on_finished_do_correction_tests( const ::std::vector<std::pair<daw::data::compact_table_t::size_type, daw::data::compact_table_t::size_type>> positions, const ::std::pair<size_t, size_t> date_range );
 	void update_status( ::std::string status ) const;
-	void update_status_callback( ::std::string status, wxApp* app );
+	/// <summary>Memory held by the file's table and by the display lists of its views</summary>
+	daw::pumpdataanalysis::memory_report_t memory_report( ) const;
 
 private:
 	static size_t ms_number_children;
 	wxNotebook * m_notebook_main;
-	wxNotebook * m_notebook_basal_tests;
 	wxGrid * m_grid;
 	wxApp * m_app;
 	daw::data::CSVTable m_table_data;
 	::std::string const m_filename;
 	std::thread m_backgroundthread;
+	::std::unique_ptr<daw::data::text_search_t> m_search;
+	size_t m_search_pos;	// Match shown last, npos before the first
+	bool m_search_jump_pending;	// Find Next is waiting for the search to find more
+	wxTimer m_search_timer;
+	daw::task_future_t<::std::vector<int>> m_column_widths;
+	daw::cancellation_source_t m_autosize_cancel;
+	wxTimer m_autosize_timer;
+	wxTimer m_load_timer;
+	bool m_data_loaded;	// on_finished_loading_csv_data has run
+
+	/// <summary>Move the grid cursor to the match after the one shown, waiting for the search when there is none yet</summary>
+	void show_next_match( );
 
 	DECLARE_EVENT_TABLE( )
 };
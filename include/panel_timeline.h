@@ -0,0 +1,78 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <functional>
+#include <wx/wx.h>
+
+#include <daw/csv_helper/data_common.h>
+
+#include "cancellation.h"
+#include "compact_table.h"
+#include "lod_pyramid.h"
+#include "panel_generic_plot.h"
+#include "task_pool.h"
+
+//////////////////////////////////////////////////////////////////////////
+/// <summary>Zoomable/pannable view of the sensor readings over the whole file.
+/// The pyramid is built on the task pool, a placeholder is painted until it
+/// is ready</summary>
+//////////////////////////////////////////////////////////////////////////
+class PanelTimeline: public wxPanel {
+	daw::pumpdataanalysis::lod_pyramid_t m_pyramid;
+	daw::cancellation_source_t m_cancel;
+	daw::task_future_t<daw::pumpdataanalysis::lod_pyramid_t> m_pending;
+	wxString m_status;
+	wxTimer m_timer;
+	int m_view_first;	// minutes since epoch
+	int m_view_last;
+	int m_built_width;
+	bool m_dirty;
+	bool m_dragging;
+	int m_drag_start_x;
+	int m_drag_view_first;
+	const ::std::function<void( wxMenuBar* menu )> m_addmenu_cb;
+public:
+	PanelTimeline( wxWindow *parent, ::std::function<void( wxMenuBar* menu )> addmenu_cb, const daw::data::compact_table_t& dt );
+	/// <summary>Cancels an unfinished build of the pyramid and waits for it to stop</summary>
+	virtual ~PanelTimeline( );
+
+	/// <summary>Bytes held by the display list and the pyramid it is built from</summary>
+	size_t display_list_bytes( ) const;
+
+private:
+	daw::pumpdataanalysis::PanelGenericPlotter m_gen_plot;
+	void build_view( int width );
+	void set_view( int first, int last );
+	void on_paint( wxPaintEvent& event );
+	void on_timer( wxTimerEvent& event );
+	void on_size( wxSizeEvent& event );
+	void on_mouse_wheel( wxMouseEvent& event );
+	void on_left_down( wxMouseEvent& event );
+	void on_left_up( wxMouseEvent& event );
+	void on_motion( wxMouseEvent& event );
+	void on_capture_lost( wxMouseCaptureLostEvent& event );
+
+	DECLARE_EVENT_TABLE( )
+};
+
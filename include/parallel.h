@@ -0,0 +1,218 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "allocation_tracker.h"
+#include "defs.h"
+#include "task_pool.h"
+
+/// Parallel primitives over row ranges.  USE_PPL in defs.h picks the backend:
+/// 0 runs the ranges as tasks of the task pool, whose workers are std::threads,
+/// 1 runs them with OpenMP.  Either way the calling thread takes part and any
+/// exception thrown by an action is rethrown to the caller once every range
+/// has finished.  Results do not depend on the backend, only on the number of
+/// ranges.  With OpenMP, calls made from a task pool worker or from inside
+/// another parallel region run their ranges on the calling thread alone, as
+/// OpenMP teams started from every busy pool worker would oversubscribe the
+/// machine
+
+namespace daw {
+	namespace impl {
+		/// Below this many rows a single thread is faster than starting more
+		size_t const s_min_rows_per_range = 16384;
+
+#if USE_PPL
+		/// OpenMP threads to run a parallel region with on the calling thread
+		int omp_team_size( );
+#endif
+
+		/// Run action( n ) for every n in [0, count)
+		template<typename Action>
+		void parallel_indices( size_t count, Action & caller_action ) {
+			if( 1 == count ) {
+				caller_action( static_cast<size_t>(0) );
+				return;
+			}
+			// The phase is per thread, ranges count against the caller's whichever thread runs them
+			auto const phase = current_alloc_phase( );
+			auto action = [&caller_action, phase]( size_t n ) {
+				alloc_phase_scope_t const phase_scope( phase );
+				caller_action( n );
+			};
+#if USE_PPL
+			::std::exception_ptr error;
+			#pragma omp parallel for schedule( static ) num_threads( omp_team_size( ) )
+			for( ptrdiff_t n = 0; n < static_cast<ptrdiff_t>(count); ++n ) {
+				try {
+					action( static_cast<size_t>(n) );
+				} catch( ... ) {
+					#pragma omp critical( daw_parallel_error )
+					if( !error ) {
+						error = ::std::current_exception( );
+					}
+				}
+			}
+			if( error ) {
+				::std::rethrow_exception( error );
+			}
+#else
+			// Ranges run at the priority of the caller's task, interactive when the caller is not one, and
+			// ranges no worker has started yet are run by the caller while it waits
+			auto const priority = task_pool_t::current_priority( );
+			::std::vector<task_future_t<void>> workers;
+			workers.reserve( count - 1 );
+			for( size_t n = 1; n < count; ++n ) {
+				workers.push_back( task_pool_t::get( ).submit( priority, [&action, n]( ) {
+					action( n );
+				} ) );
+			}
+			::std::exception_ptr error;
+			try {
+				action( static_cast<size_t>(0) );
+			} catch( ... ) {
+				error = ::std::current_exception( );
+			}
+			for( auto & worker : workers ) {
+				try {
+					worker.get( );
+				} catch( ... ) {
+					if( !error ) {
+						error = ::std::current_exception( );
+					}
+				}
+			}
+			if( error ) {
+				::std::rethrow_exception( error );
+			}
+#endif
+		}
+	}	// namespace impl
+
+	/// <summary>Most ranges the primitives split their work into</summary>
+	size_t parallel_thread_count( );
+
+	/// <summary>Number of ranges parallel_for splits size rows into, at least 1</summary>
+	size_t parallel_range_count( size_t size, size_t min_per_range = impl::s_min_rows_per_range );
+
+	/// <summary>Run action( range, first, last ) over [0, size) split into contiguous ranges of at
+	/// least min_per_range rows.  range numbers them in row order from 0 to
+	/// parallel_range_count( size, min_per_range ), for results kept per range</summary>
+	template<typename Action>
+	void parallel_for_ranges( size_t size, Action action, size_t min_per_range = impl::s_min_rows_per_range ) {
+		auto const ranges = parallel_range_count( size, min_per_range );
+		auto const chunk = (size + ranges - 1) / ranges;
+		auto range_action = [&]( size_t n ) {
+			auto const first = ::std::min( n * chunk, size );
+			action( n, first, ::std::min( first + chunk, size ) );
+		};
+		impl::parallel_indices( ranges, range_action );
+	}
+
+	/// <summary>Run action( first, last ) over [0, size) split into contiguous ranges of at
+	/// least min_per_range rows</summary>
+	template<typename Action>
+	void parallel_for( size_t size, Action action, size_t min_per_range = impl::s_min_rows_per_range ) {
+		parallel_for_ranges( size, [&]( size_t, size_t first, size_t last ) {
+			action( first, last );
+		}, min_per_range );
+	}
+
+	/// <summary>Reduce [0, size) in parallel.  Each range starts from a copy of identity and
+	/// action( first, last, accumulator ) adds its rows.  The accumulators are then combined in
+	/// row order with merge( into, from ), so merge need not commute</summary>
+	template<typename Accumulator, typename Action, typename Merge>
+	Accumulator parallel_reduce( size_t size, Accumulator const & identity, Action action, Merge merge, size_t min_per_range = impl::s_min_rows_per_range ) {
+		auto const ranges = parallel_range_count( size, min_per_range );
+		::std::vector<Accumulator> partials( ranges, identity );
+		parallel_for_ranges( size, [&]( size_t n, size_t first, size_t last ) {
+			action( first, last, partials[n] );
+		}, min_per_range );
+		auto result = ::std::move( partials[0] );
+		for( size_t n = 1; n < ranges; ++n ) {
+			merge( result, partials[n] );
+		}
+		return result;
+	}
+
+	/// <summary>Stable sort of [first, last).  Ranges are sorted in parallel and then merged
+	/// pairwise, left range first, which keeps equal elements in order</summary>
+	template<typename RandomIterator, typename Less>
+	void parallel_stable_sort( RandomIterator first, RandomIterator last, Less less ) {
+		auto const size = static_cast<size_t>(::std::distance( first, last ));
+		auto const ranges = parallel_range_count( size, impl::s_min_rows_per_range );
+		auto const chunk = (size + ranges - 1) / ranges;
+		parallel_for( size, [&]( size_t range_first, size_t range_last ) {
+			::std::stable_sort( first + static_cast<ptrdiff_t>(range_first), first + static_cast<ptrdiff_t>(range_last), less );
+		} );
+		for( auto width = chunk; width < size; width *= 2 ) {
+			for( size_t left = 0; left + width < size; left += 2 * width ) {
+				auto const middle = left + width;
+				auto const right = ::std::min( middle + width, size );
+				::std::inplace_merge( first + static_cast<ptrdiff_t>(left), first + static_cast<ptrdiff_t>(middle), first + static_cast<ptrdiff_t>(right), less );
+			}
+		}
+	}
+
+	/// <summary>Replace each element of values by the sum of those before it.  Returns the sum of
+	/// them all.  Ranges are summed in parallel, their offsets found in order and then each range
+	/// is scanned in parallel</summary>
+	template<typename T>
+	T parallel_exclusive_scan( ::std::vector<T> & values, size_t min_per_range = impl::s_min_rows_per_range ) {
+		auto const size = values.size( );
+		if( 0 == size ) {
+			return T( );
+		}
+		::std::vector<T> offsets( parallel_range_count( size, min_per_range ), T( ) );
+		parallel_for_ranges( size, [&]( size_t range, size_t first, size_t last ) {
+			T sum = T( );
+			for( auto n = first; n < last; ++n ) {
+				sum += values[n];
+			}
+			offsets[range] = sum;
+		}, min_per_range );
+		T total = T( );
+		for( auto & offset : offsets ) {
+			auto const sum = offset;
+			offset = total;
+			total += sum;
+		}
+		parallel_for_ranges( size, [&]( size_t range, size_t first, size_t last ) {
+			auto sum = offsets[range];
+			for( auto n = first; n < last; ++n ) {
+				auto const value = values[n];
+				values[n] = sum;
+				sum += value;
+			}
+		}, min_per_range );
+		return total;
+	}
+}	// namespace daw
+
@@ -0,0 +1,41 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <wx/wx.h>
+
+#include "panel_generic_plot.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		/// <summary>Draw gen_plot on a white background without a window.  wx drawing is not thread safe,
+		/// these must be called on the UI thread like any other drawing</summary>
+		wxImage render_to_image( PanelGenericPlotter & gen_plot, wxSize size );
+
+		void render_to_png( PanelGenericPlotter & gen_plot, wxSize size, wxString const & filename );
+
+		void render_to_svg( PanelGenericPlotter & gen_plot, wxSize size, wxString const & filename );
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
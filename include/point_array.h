@@ -0,0 +1,75 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <wx/wx.h>
+
+namespace daw {
+	namespace pumpdataanalysis {
+		class point_t;
+		struct translation_t;
+
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		/// <summary>Structure of arrays storage for a run of points.  The whole run is mapped to
+		/// panel coordinates in one pass instead of calling <c>point_t::mapped_point</c> per point</summary>
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		class point_array_t final {
+			::std::vector<int> m_x;
+			::std::vector<int> m_y;
+			::std::vector<int> m_offset_x;
+			::std::vector<int> m_offset_y;
+			::std::vector<uint8_t> m_flags;
+		public:
+			enum : uint8_t {
+				flag_unmapped_x = 0x01,
+				flag_unmapped_y = 0x02
+			};
+
+			point_array_t( );
+			explicit point_array_t( ::std::vector<point_t> const & points );
+			~point_array_t( ) = default;
+			point_array_t( point_array_t const & ) = default;
+			point_array_t( point_array_t && ) = default;
+			point_array_t & operator=( point_array_t const & ) = default;
+			point_array_t & operator=( point_array_t && ) = default;
+
+			void reserve( size_t count );
+			void push_back( point_t const & point );
+			size_t size( ) const;
+			bool empty( ) const;
+			point_t operator[]( size_t pos ) const;
+			size_t footprint( ) const;
+
+			::std::vector<int> const & x( ) const;
+			::std::vector<int> const & y( ) const;
+
+			/// <summary>Map every point to panel coordinates, writing into out.  out is resized but its
+			/// capacity is kept so the same buffer can be reused every paint</summary>
+			void map_points( translation_t const & coord_data, ::std::vector<wxPoint> & out ) const;
+		};	// point_array_t
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
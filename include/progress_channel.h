@@ -0,0 +1,83 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace daw {
+	namespace pumpdataanalysis {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Progress of a background job, written by the job and read by
+		/// the UI when it wants to.  Updates and reads are a few relaxed atomic
+		/// stores and loads and never wait.  Only the latest values are kept</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class progress_channel_t final {
+			using clock_t = ::std::chrono::steady_clock;
+
+			clock_t::time_point const m_start;
+			::std::atomic<int> m_stage;
+			::std::atomic<int64_t> m_stage_start_ns;	// Since m_start
+			::std::atomic<uint64_t> m_rows_done;
+			::std::atomic<uint64_t> m_rows_total;
+			::std::atomic<uint64_t> m_bytes_done;
+			::std::atomic<uint64_t> m_bytes_total;
+
+			int64_t now_ns( ) const;
+		public:
+			struct snapshot_t {
+				int stage;
+				uint64_t rows_done;
+				uint64_t rows_total;	// 0 when not known
+				uint64_t bytes_done;
+				uint64_t bytes_total;	// 0 when not known
+				double stage_seconds;	// Time spent in the current stage
+				double total_seconds;
+
+				double rows_per_second( ) const;
+				double bytes_per_second( ) const;
+				/// <summary>Seconds left in the current stage at the rate so far, negative when not known.  From the
+				/// rows when their total is known, otherwise from the bytes while they are still being read</summary>
+				double eta_seconds( ) const;
+			};	// snapshot_t
+
+			progress_channel_t( );
+			progress_channel_t( progress_channel_t const & ) = delete;
+			progress_channel_t & operator=( progress_channel_t const & ) = delete;
+
+			/// <summary>Start a stage.  Row counts are reset as rates are per stage</summary>
+			void set_stage( int stage );
+			void set_rows( uint64_t done, uint64_t total );
+			void set_bytes( uint64_t done, uint64_t total );
+
+			snapshot_t snapshot( ) const;
+		};	// progress_channel_t
+
+		/// <summary>Text like "1.2 M" for counts shown to the user</summary>
+		::std::string format_count( double value );
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
@@ -22,44 +22,160 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/date_time/posix_time/ptime.hpp>
-#include <future>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <daw/csv_helper/data_table.h>
 
+#include "aggregate_data.h"
+#include "cancellation.h"
+#include "compact_table.h"
+#include "multi_lock.h"
+#include "progress_channel.h"
+#include "task_pool.h"
+
 namespace daw {
 // 	namespace data {
 // 		class DataTable;
 // 	}
 
 	namespace pumpdataanalysis {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>A Carelink export loaded on a background thread.  The load
+		/// runs through the stages below in order.  Rows are usable as soon as
+		/// their timestamps are converted, so a view can show the first rows while
+		/// the rest are still being converted.  Nothing is published while the
+		/// file is parsed: the table is built from the whole parse, so until then
+		/// only the byte progress shows and a large file's first rows appear
+		/// once parsing is done.
+		///
+		/// Locking scheme:
+		/// - Everything the loader produces is published by a release store of
+		///   the stage or of rows_ready.  Readers check stage( ) / rows_ready( )
+		///   and then read without a lock.  Nothing published is written again
+		///   by the load, so readers never wait on it or on each other.
+		/// - While converting, rows at or past rows_ready belong to the loader.
+		/// - The table mutex guards the table's shape: replacing it, removing
+		///   or adding rows or columns.  Such writers hold write_lock( ).  A
+		///   reader that walks many rows, such as a whole column, holds
+		///   read_lock( ) so it never sees the shape change midway.  Readers
+		///   share the lock.
+		/// - The table mutex is taken before any other lock.  When more than
+		///   one table is locked at once use daw::make_multi_lock or
+		///   daw::make_shared_multi_lock so the order does not matter.
+		/// - Progress and cancellation are atomics and need no lock</summary>
+		//////////////////////////////////////////////////////////////////////////
 		struct PumpDataAnalysis final {
 			using basal_tests_t = std::vector<::std::pair<size_t, size_t>>;
+			enum class load_stage_t: int { parsing, cleaning, converting, detecting, ready, failed };
 		private:
-			daw::data::DataTable parse_csv( daw::data::parse_csv_data_param const & param, ::std::function<void( )> on_completed );
+			/// Rows converted between publishing rows_ready
+			static size_t const s_rows_per_block = 4096;
+
+			void load( ::std::string const & filename );
+			::std::unique_lock<shared_mutex_t> write_lock( );
 
-			std::shared_future<daw::data::DataTable> m_data_table_fut;
-			std::shared_future<basal_tests_t> m_basal_tests_fut;
+			mutable shared_mutex_t m_table_mutex;
+			::std::unique_ptr<daw::data::compact_table_t> m_data_table;
+			basal_tests_t m_basal_tests;
+			::std::string m_error;
+			::std::atomic<load_stage_t> m_stage;
+			::std::atomic<size_t> m_rows_ready;
+			progress_channel_t m_progress;
+			cancellation_source_t m_cancel;
+			task_future_t<void> m_loader;
 		public:
-			PumpDataAnalysis( daw::data::parse_csv_data_param const & param, ::std::function<void( )> on_completed );
+			/// <summary>Start loading a Carelink CSV export.  Returns without waiting</summary>
+			explicit PumpDataAnalysis( ::std::string filename );
+			/// <summary>Cancels the load and waits for it to stop</summary>
+			~PumpDataAnalysis( );
 
 			PumpDataAnalysis( ) = delete;
-			~PumpDataAnalysis( ) = default;
 			PumpDataAnalysis( PumpDataAnalysis const & ) = delete;
-			PumpDataAnalysis( PumpDataAnalysis && other ) noexcept;
-
-			PumpDataAnalysis & operator=( PumpDataAnalysis && rhs) noexcept;
+			PumpDataAnalysis( PumpDataAnalysis && other ) = delete;
+			PumpDataAnalysis & operator=( PumpDataAnalysis && rhs) = delete;
 			PumpDataAnalysis& operator=( PumpDataAnalysis const & ) = delete;
 
-			friend void swap( PumpDataAnalysis & lhs, PumpDataAnalysis & rhs ) noexcept;
+			load_stage_t stage( ) const;
+			/// <summary>The table's columns can be read, rows below rows_ready hold their final values</summary>
+			bool has_table( ) const;
+			/// <summary>Every row is final and the table will not change again</summary>
+			bool has_data( ) const;
+			/// <summary>Basal tests have been found</summary>
+			bool is_ready( ) const;
+			bool has_failed( ) const;
+			/// <summary>Why the load failed</summary>
+			::std::string const & error( ) const;
+			size_t rows_ready( ) const;
+			/// <summary>Progress of the load, the stage is a load_stage_t</summary>
+			progress_channel_t const & progress( ) const;
+			/// <summary>Block until the load has finished or failed</summary>
+			void wait( ) const;
+			/// <summary>Stop the load at the next block boundary.  It then fails with operation_cancelled_t's message</summary>
+			void cancel( );
 
-			daw::data::DataTable const & data_table( ) const;
+			/// <summary>The loaded table.  Only valid once has_table is true</summary>
+			daw::data::compact_table_t const & data_table( ) const;
+			/// <summary>Hold while reading many rows of the table, see the locking scheme above</summary>
+			::std::shared_lock<shared_mutex_t> read_lock( ) const;
 
+			/// <summary>Only valid once is_ready is true</summary>
 			basal_tests_t const & basal_tests( ) const;
-			basal_tests_t basal_tests_in_range( ::std::pair<boost::posix_time::ptime, boost::posix_time::ptime> date_range );
+			basal_tests_t basal_tests_in_range( ::std::pair<boost::posix_time::ptime, boost::posix_time::ptime> date_range ) const;
 		};	// PumpDataAnalysis
+
+		/// <summary>Name of a load stage to show the user</summary>
+		char const * load_stage_name( PumpDataAnalysis::load_stage_t stage );
+
+		/// <summary>Columns of a Carelink export that are loaded</summary>
+		bool pump_column_filter( ::std::string const & header );
+
+		/// <summary>Loaded columns the analyses read, parsed when loading.  The others are parsed when first read</summary>
+		bool pump_column_is_hot( ::std::string const & header );
+
+		/// <summary>Remove rows without data and convert the Timestamp column from text</summary>
+		void clean_pump_data( daw::data::DataTable & data_table );
+
+		/// <summary>Remove rows that have no data in any column but the first.  Loading skips them while parsing,
+		/// this is for tables parsed by csv_helper</summary>
+		void remove_empty_rows( daw::data::DataTable & data_table );
+
+		/// <summary>Convert the Timestamp column of rows [first_row, last_row) from text</summary>
+		void convert_timestamps( daw::data::DataTable & data_table, size_t first_row, size_t last_row );
+		void convert_timestamps( ::std::vector<daw::data::DataCell> & timestamps, size_t first_row, size_t last_row );
+
+		/// <summary>Store the mostly empty columns of a cleaned export sparsely.  The Timestamp column stays
+		/// dense so it can be converted in place through dense_cells( )</summary>
+		daw::data::compact_table_t compact_pump_data( daw::data::DataTable data_table );
+		daw::data::compact_table_t compact_pump_data( ::std::vector<daw::data::dense_column_t> columns, ::std::vector<::std::unique_ptr<daw::data::lazy_column_t const>> lazy = { } );
+
+		/// <summary>Load, clean and compact a Carelink CSV export on the calling thread.  Rows without data are
+		/// dropped as they are parsed</summary>
+		daw::data::compact_table_t load_pump_data( ::std::string const & filename, ::std::function<void( ::std::string )> on_status );
+
+		/// <summary>Bytes loading filename is expected to need, for task pool admission.  0 when unknown</summary>
+		size_t load_memory_estimate( ::std::string const & filename );
+
+		struct basal_test_params_t {
+			int settle_hours = 4;	// Hours skipped after food or insulin, and at the start of the file
+			int min_minutes = 30;	// Shortest test kept
+			int max_hours = 24;	// Tests this long or longer are dropped
+			daw::data::real_t max_rise = 1.0;	// Largest change in mmol/L per hour over a test
+		};	// basal_test_params_t
+
+		/// <summary>Periods of sensor readings without food, bolus insulin or temporary basal rates</summary>
+		PumpDataAnalysis::basal_tests_t find_basal_tests( daw::data::compact_table_t const & data_table, cancellation_token_t const & cancelled = cancellation_token_t( ) );
+		PumpDataAnalysis::basal_tests_t find_basal_tests( daw::data::compact_table_t const & data_table, basal_test_params_t const & params, cancellation_token_t const & cancelled = cancellation_token_t( ) );
+
+		/// <summary>Aggregate the sensor readings of every basal test into the 5 minute periods of a day</summary>
+		::std::vector<daw::AggregateData<daw::data::real_t>> aggregate_basal_tests( daw::data::compact_table_t const & data_table, PumpDataAnalysis::basal_tests_t const & positions, cancellation_token_t const & cancelled = cancellation_token_t( ) );
+
+		/// <summary>Aggregate the change in sensor readings per hour of every basal test over a day</summary>
+		::std::vector<daw::AggregateData<daw::data::real_t>> aggregate_basal_test_derivatives( daw::data::compact_table_t const & data_table, PumpDataAnalysis::basal_tests_t const & positions, cancellation_token_t const & cancelled = cancellation_token_t( ) );
 	}
 }
 
@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <daw/csv_helper/data_table.h>
+
+#include "compact_table.h"
+
+namespace daw {
+	namespace data {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Keep rows of a compact_table_t that match a predicate on one column</summary>
+		//////////////////////////////////////////////////////////////////////////
+		struct row_filter_t {
+			enum class kind_t { has_value, in_range };
+			size_t col;
+			kind_t kind;
+			/// <summary>Inclusive bounds for in_range.  Timestamps compare as seconds since 1970-01-01</summary>
+			double low;
+			double high;
+		};	// row_filter_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Sort and filters shown by a view of a DataTable.  A view is
+		/// only a permutation of row numbers, the table itself is never copied</summary>
+		//////////////////////////////////////////////////////////////////////////
+		struct row_view_spec_t {
+			static size_t const no_sort = static_cast<size_t>(-1);
+			size_t sort_col = no_sort;
+			bool ascending = true;
+			::std::vector<row_filter_t> filters;
+
+			bool is_identity( ) const;
+		};	// row_view_spec_t
+
+		/// <summary>Numeric key of a cell.  Reals are themselves, timestamps are seconds since 1970-01-01 and
+		/// anything else is NaN</summary>
+		double numeric_key( daw::data::compact_table_t::value_type::value_type const & cell );
+
+		/// <summary>Rows of table matching every filter, in table order</summary>
+		::std::vector<size_t> filter_rows( daw::data::compact_table_t const & table, ::std::vector<row_filter_t> const & filters );
+
+		/// <summary>Stable sort of rows by the values of column col.  Numbers sort before text and empty
+		/// cells are always last.  Runs in parallel for large inputs</summary>
+		void sort_rows( daw::data::compact_table_t const & table, size_t col, bool ascending, ::std::vector<size_t> & rows );
+
+		/// <summary>Rows of table in the order spec shows them, nullptr when spec shows the table as is</summary>
+		::std::shared_ptr<::std::vector<size_t> const> make_row_view( daw::data::compact_table_t const & table, row_view_spec_t const & spec );
+	}	// namespace data
+}	// namespace daw
+
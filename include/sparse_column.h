@@ -0,0 +1,82 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <daw/csv_helper/data_cell.h>
+
+#include "defs.h"
+#include "packed_cell.h"
+
+namespace daw {
+	namespace data {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>A column that only stores its non-empty cells.  A bitmap
+		/// has a bit per row, set when the row has a value, and a rank index
+		/// holds the number of values before each 64 row word.  The value of a
+		/// row is then found with one popcount.  Rows without a value read as
+		/// an empty cell.  With PACK_VARIANT the values are packed_cell_t
+		/// whose long text is in the table's string_arena_t</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class sparse_column_t final {
+		public:
+#if PACK_VARIANT
+			using value_type = packed_cell_t;
+#else
+			using value_type = DataCell;
+#endif
+		private:
+			size_t m_size;
+			::std::vector<uint64_t> m_present;	// Bit n of word w is row w*64 + n
+			::std::vector<uint32_t> m_ranks;	// Values before each word of m_present
+			::std::vector<value_type> m_values;	// In row order
+		public:
+			sparse_column_t( );
+			/// <summary>Moves the non-empty cells out of cells, which is left holding empty cells.  Packed
+			/// cells keep long text in arena</summary>
+			sparse_column_t( ::std::vector<DataCell> & cells, string_arena_t & arena );
+
+			~sparse_column_t( ) = default;
+			sparse_column_t( sparse_column_t const & ) = default;
+			sparse_column_t( sparse_column_t && ) = default;
+			sparse_column_t & operator=( sparse_column_t const & ) = default;
+			sparse_column_t & operator=( sparse_column_t && ) = default;
+
+			value_type const & operator[]( size_t row ) const;
+			size_t size( ) const;
+			bool empty( ) const;
+			/// <summary>Rows that have a value</summary>
+			size_t value_count( ) const;
+			/// <summary>Bytes held by the bitmap, the rank index and the cells, not counting text the cells keep on the heap</summary>
+			size_t footprint( ) const;
+
+			/// <summary>Fraction of cells that have a value</summary>
+			static double density( ::std::vector<DataCell> const & cells );
+		};	// sparse_column_t
+	}	// namespace data
+}	// namespace daw
+
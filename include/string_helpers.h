@@ -23,11 +23,50 @@
 #pragma once
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace daw { namespace string {
-	/// See http://www.boost.org/doc/libs/1_55_0/doc/html/date_time/date_time_io.html for formatting info
+	//////////////////////////////////////////////////////////////////////////
+	/// <summary>A ptime format string compiled once into a list of steps.
+	/// Formatting uses no streams or locales and does not allocate, so a
+	/// const formatter can be shared between threads.  Supports %Y %y %m %d
+	/// %j %b %B %a %A %H %I %M %S %f %F %p %T %R %D and %% with boost's
+	/// meanings.  %Z and %z produce nothing as a ptime has no zone, other
+	/// codes are copied as is.
+	/// Month and day names are English</summary>
+	//////////////////////////////////////////////////////////////////////////
+	class ptime_formatter_t final {
+		enum class op_t: uint8_t { literal, year, year_2digit, month, month_abbr, month_name, day, day_of_year, weekday_abbr, weekday_name, hour, hour_12, minute, second, fractional_seconds, fractional_seconds_if_any, am_pm };
+		struct step_t {
+			op_t op;
+			uint16_t literal_first;
+			uint16_t literal_size;
+		};
+		::std::vector<step_t> m_steps;
+		::std::string m_literals;
+		size_t m_max_size;
+
+		void add_literal( char const * first, size_t size );
+		void add_op( op_t op );
+	public:
+		explicit ptime_formatter_t( ::std::string const & format );
+
+		/// <summary>Most characters format can write</summary>
+		size_t max_size( ) const;
+
+		/// <summary>Write value into out, truncating at out_size.  No terminating zero is written</summary>
+		/// <returns>Number of characters written</returns>
+		size_t format( boost::posix_time::ptime const & value, char * out, size_t out_size ) const;
+
+		::std::string to_string( boost::posix_time::ptime const & value ) const;
+	};	// ptime_formatter_t
+
+	/// See http://www.boost.org/doc/libs/1_55_0/doc/html/date_time/date_time_io.html for formatting info.  Without a locale
+	/// this compiles format on every call, keep a ptime_formatter_t around where it is called often
 	std::string ptime_to_string( const boost::posix_time::ptime& value, const std::string& format = "%Y-%m-%d %H:%M:%S %Z", const std::string locale_str = "" );
 	std::string ptime_to_string( const boost::posix_time::time_duration& value, bool show_seconds = true );
 }}
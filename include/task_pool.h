@@ -0,0 +1,221 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	/// <summary>Order tasks are started in when more are queued than there are threads</summary>
+	enum class task_priority_t: uint8_t {
+		interactive = 0,	// Someone is waiting to see the result
+		background,	// Loading and indexing
+		cache	// Work whose result is only kept in case it is needed
+	};
+
+	namespace impl {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>A queued task.  Whoever claims it first runs it, a worker
+		/// or a thread waiting on its result</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class pool_job_t final {
+			struct callable_base_t {
+				virtual ~callable_base_t( );
+				virtual void run( ) = 0;
+			};
+
+			template<typename Function>
+			struct callable_t final: public callable_base_t {
+				Function function;
+
+				explicit callable_t( Function && f ):
+						function( ::std::move( f ) ) { }
+
+				void run( ) override {
+					function( );
+				}
+			};
+
+			::std::atomic<bool> m_claimed;
+			::std::unique_ptr<callable_base_t> m_callable;
+		public:
+			task_priority_t const priority;
+			size_t const memory;	// Bytes the task is expected to need while it runs
+
+			template<typename Function>
+			pool_job_t( Function function, task_priority_t task_priority, size_t memory_estimate ):
+					m_claimed( false ),
+					m_callable( new callable_t<Function>( ::std::move( function ) ) ),
+					priority( task_priority ),
+					memory( memory_estimate ) { }
+
+			pool_job_t( pool_job_t const & ) = delete;
+			pool_job_t & operator=( pool_job_t const & ) = delete;
+
+			bool is_claimed( ) const;
+			/// <summary>True for exactly one caller, who must then run it</summary>
+			bool try_claim( );
+			void run( );
+		};	// pool_job_t
+	}	// namespace impl
+
+	//////////////////////////////////////////////////////////////////////////
+	/// <summary>Result of a task submitted to a task_pool_t.  Waiting on a
+	/// task that has not started yet runs it on the waiting thread, outside
+	/// the pool's limits, so waiting can never deadlock on a busy pool.
+	/// Destroying it neither waits nor cancels</summary>
+	//////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	class task_future_t final {
+		::std::shared_ptr<impl::pool_job_t> m_job;
+		::std::future<T> m_future;
+	public:
+		task_future_t( ) = default;
+		task_future_t( ::std::shared_ptr<impl::pool_job_t> job, ::std::future<T> future ):
+				m_job( ::std::move( job ) ),
+				m_future( ::std::move( future ) ) { }
+
+		task_future_t( task_future_t && ) = default;
+		task_future_t & operator=( task_future_t && ) = default;
+		task_future_t( task_future_t const & ) = delete;
+		task_future_t & operator=( task_future_t const & ) = delete;
+
+		bool valid( ) const {
+			return m_future.valid( );
+		}
+
+		bool is_ready( ) const {
+			return m_future.valid( ) && ::std::future_status::ready == m_future.wait_for( ::std::chrono::seconds( 0 ) );
+		}
+
+		/// <summary>A thread has claimed the task, it is running or done</summary>
+		bool is_started( ) const {
+			return !m_job || m_job->is_claimed( );
+		}
+
+		void wait( ) const {
+			if( m_job && m_job->try_claim( ) ) {
+				m_job->run( );
+			}
+			m_future.wait( );
+		}
+
+		/// <summary>Wait and take the result, rethrowing anything the task threw</summary>
+		T get( ) {
+			wait( );
+			return m_future.get( );
+		}
+	};	// task_future_t
+
+	//////////////////////////////////////////////////////////////////////////
+	/// <summary>Work stealing thread pool shared by all background work.
+	/// Each worker has its own queue per priority; tasks submitted from a
+	/// worker go on its own queue and idle workers steal from the others.
+	/// At most one fewer than the thread count of non interactive tasks run
+	/// at once so there is always a thread for interactive work, and tasks
+	/// with a memory estimate only start while the estimates of running
+	/// tasks fit the memory budget.  A task bigger than the whole budget
+	/// still runs, alone</summary>
+	//////////////////////////////////////////////////////////////////////////
+	class task_pool_t final {
+		static size_t const s_priority_count = 3;
+		using job_ptr_t = ::std::shared_ptr<impl::pool_job_t>;
+
+		struct queue_t {
+			::std::mutex mutex;
+			::std::deque<job_ptr_t> jobs[s_priority_count];
+		};
+
+		::std::atomic<size_t> m_memory_budget;
+		size_t const m_low_priority_limit;
+		::std::atomic<size_t> m_memory_in_use;
+		::std::atomic<size_t> m_low_priority_running;
+		::std::atomic<bool> m_held_back;	// A queued task was not admitted since a finished task last woke every worker
+		queue_t m_injected;	// Tasks submitted from outside the pool
+		::std::vector<::std::unique_ptr<queue_t>> m_queues;	// One per worker
+		::std::mutex m_wake_mutex;
+		::std::condition_variable m_wake;
+		uint64_t m_wake_count;	// Bumped whenever a task may have become runnable
+		bool m_stopping;
+		::std::vector<::std::thread> m_threads;
+
+		void enqueue( job_ptr_t job );
+		void signal( bool all );
+		bool try_admit( impl::pool_job_t const & job );
+		void release( impl::pool_job_t const & job );
+		/// <summary>Claim and admit a queued job of priority from queue.  LIFO for a worker's own queue, FIFO when stealing</summary>
+		job_ptr_t take( queue_t & queue, size_t priority, bool lifo );
+		job_ptr_t find_job( size_t worker_index );
+		void worker_loop( size_t worker_index );
+	public:
+		static size_t const default_memory_budget = static_cast<size_t>(1) << 30;
+
+		task_pool_t( size_t thread_count, size_t memory_budget );
+		/// <summary>Runs what is queued and joins the workers</summary>
+		~task_pool_t( );
+
+		task_pool_t( task_pool_t const & ) = delete;
+		task_pool_t & operator=( task_pool_t const & ) = delete;
+
+		/// <summary>The pool shared by the whole process, one thread per hardware thread</summary>
+		static task_pool_t & get( );
+
+		/// <summary>Priority of the task running on the calling thread, interactive outside of any task.  Work a
+		/// task splits off is submitted at this so it does not jump ahead of other work</summary>
+		static task_priority_t current_priority( );
+		/// <summary>The calling thread is one of this pool's workers</summary>
+		bool is_worker_thread( ) const;
+
+		size_t thread_count( ) const;
+		size_t memory_in_use( ) const;
+		size_t memory_budget( ) const;
+		/// <summary>Tasks already running keep going, queued ones are admitted against the new budget</summary>
+		void set_memory_budget( size_t memory_budget );
+
+		/// <param name="memory_estimate">Bytes the task needs while running, 0 when it is small</param>
+		template<typename Function>
+		auto submit( task_priority_t priority, Function function, size_t memory_estimate = 0 ) -> task_future_t<decltype( function( ) )> {
+			using result_t = decltype( function( ) );
+			::std::packaged_task<result_t( )> task( ::std::move( function ) );
+			auto future = task.get_future( );
+			auto job = ::std::make_shared<impl::pool_job_t>( [task = ::std::move( task )]( ) mutable {
+				task( );
+			}, priority, memory_estimate );
+			enqueue( job );
+			return task_future_t<result_t>( ::std::move( job ), ::std::move( future ) );
+		}
+	};	// task_pool_t
+}	// namespace daw
+
@@ -0,0 +1,88 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/wx.h>
+
+namespace daw {
+	namespace pumpdataanalysis {
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Text measurement that can be used off the UI thread.  Glyph
+		/// advances are measured once, on the UI thread, for a fixed set of fonts.
+		/// Measuring a string afterwards only reads those tables</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class text_metrics_t final {
+		public:
+			struct font_key_t {
+				int point_size;
+				int family;
+				int style;
+				int weight;
+				bool operator==( font_key_t const & rhs ) const;
+			};	// font_key_t
+		private:
+			static size_t const s_first_glyph = 32;
+			static size_t const s_last_glyph = 126;
+
+			struct font_metrics_t {
+				bool is_default;	// Measured with the DC's own font
+				font_key_t key;
+				::std::array<int, s_last_glyph - s_first_glyph + 1> advances;
+				int fallback_advance;
+				int height;
+			};	// font_metrics_t
+
+			::std::vector<font_metrics_t> m_fonts;
+
+			font_metrics_t const & find( wxFont const & font ) const;
+			font_metrics_t const & find( font_key_t const & key ) const;
+		public:
+			/// <summary>Measure fonts.  Must be called on the UI thread</summary>
+			explicit text_metrics_t( ::std::vector<wxFont> const & fonts );
+
+			~text_metrics_t( ) = default;
+			text_metrics_t( text_metrics_t const & ) = default;
+			text_metrics_t( text_metrics_t && ) = default;
+			text_metrics_t & operator=( text_metrics_t const & ) = default;
+			text_metrics_t & operator=( text_metrics_t && ) = default;
+
+			/// <summary>Size of text drawn in font.  Fonts that were not measured use the DC default font's metrics</summary>
+			wxSize get_text_extent( wxFont const & font, wxString const & text ) const;
+
+			/// <summary>Width of UTF-8 text drawn in the font with key.  Does not touch any wx object so it can be
+			/// used where wxFont and wxString can not</summary>
+			int get_text_width( font_key_t const & key, ::std::string const & text ) const;
+
+			static font_key_t key_of( wxFont const & font );
+
+			/// <summary>Metrics for the fonts in graph_config_t.  The first call must be made on the UI thread</summary>
+			static ::std::shared_ptr<text_metrics_t const> for_graphs( );
+		};	// text_metrics_t
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
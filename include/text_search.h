@@ -0,0 +1,82 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <daw/csv_helper/data_table.h>
+
+#include "compact_table.h"
+#include "multi_lock.h"
+#include "task_pool.h"
+
+namespace daw {
+	namespace data {
+		/// <summary>Position of needle in haystack or npos.  Candidates are found 16 bytes at a time by
+		/// comparing the first and last characters of needle with SSE2</summary>
+		size_t find_substring( char const * haystack, size_t haystack_size, char const * needle, size_t needle_size );
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Case insensitive search of the text cells of a compact_table_t on a
+		/// worker thread.  Matches are published in table row order as blocks of
+		/// rows are finished, so they can be used before the search is done</summary>
+		//////////////////////////////////////////////////////////////////////////
+		class text_search_t final {
+		public:
+			struct match_t {
+				size_t row;
+				size_t col;
+			};
+		private:
+			mutable shared_mutex_t m_mutex;	// Guards m_matches, readers share it
+			::std::vector<match_t> m_matches;
+			::std::atomic<size_t> m_match_count;
+			::std::atomic<bool> m_done;
+			::std::atomic<bool> m_cancel;
+			::std::string const m_needle;
+			task_future_t<void> m_worker;
+		public:
+			/// <param name="keep_alive">Owner of table, held until the worker is done</param>
+			text_search_t( ::std::shared_ptr<void const> keep_alive, daw::data::compact_table_t const & table, ::std::string needle );
+			/// <summary>Stops the worker and waits for it</summary>
+			~text_search_t( );
+
+			text_search_t( text_search_t const & ) = delete;
+			text_search_t & operator=( text_search_t const & ) = delete;
+
+			::std::string const & needle( ) const;
+			/// <summary>Matches found so far</summary>
+			size_t match_count( ) const;
+			/// <summary>A match found so far, pos must be less than match_count</summary>
+			match_t match( size_t pos ) const;
+			bool is_done( ) const;
+			void cancel( );
+		};	// text_search_t
+	}	// namespace data
+}	// namespace daw
+
@@ -0,0 +1,115 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace daw {
+	namespace impl {
+		extern ::std::atomic<bool> g_trace_enabled;
+	}	// namespace impl
+
+	using trace_clock_t = ::std::chrono::steady_clock;
+
+	/// <summary>Spans are only recorded while enabled.  Off by default</summary>
+	inline bool trace_enabled( ) {
+		return impl::g_trace_enabled.load( ::std::memory_order_relaxed );
+	}
+	void set_trace_enabled( bool enabled );
+
+	/// <summary>Name shown for the calling thread's spans</summary>
+	void set_trace_thread_name( ::std::string name );
+
+	/// <summary>Forget every span recorded so far</summary>
+	void clear_trace( );
+
+	/// <summary>Write the recorded spans as Chrome trace_event JSON, for chrome://tracing or Perfetto</summary>
+	void write_chrome_trace( ::std::ostream & os );
+	void write_chrome_trace( ::std::string const & filename );
+
+	//////////////////////////////////////////////////////////////////////////
+	/// <summary>Records the time from construction to destruction on the
+	/// calling thread's ring buffer.  Each thread keeps its most recent
+	/// spans, older ones are overwritten.  Names are not copied and must be
+	/// string literals.  While tracing is disabled a span is a flag check
+	/// and nothing more</summary>
+	//////////////////////////////////////////////////////////////////////////
+	class trace_span_t final {
+	public:
+		static size_t const max_counters = 4;	// Spans such as parse_csv record three
+		struct counter_t {
+			char const * name;
+			int64_t value;
+		};	// counter_t
+	private:
+		char const * m_name;
+		trace_clock_t::time_point m_begin;
+		::std::array<counter_t, max_counters> m_counters;
+		size_t m_counter_count;
+
+		void record( );
+	public:
+		explicit trace_span_t( char const * name ):
+				m_name( nullptr ),
+				m_begin( ),
+				m_counters( ),
+				m_counter_count( 0 ) {
+
+			if( trace_enabled( ) ) {
+				m_name = name;
+				m_begin = trace_clock_t::now( );
+			}
+		}
+
+		~trace_span_t( ) {
+			end( );
+		}
+
+		trace_span_t( trace_span_t const & ) = delete;
+		trace_span_t( trace_span_t && ) = delete;
+		trace_span_t & operator=( trace_span_t const & ) = delete;
+		trace_span_t & operator=( trace_span_t && ) = delete;
+
+		/// <summary>Record the span now rather than at destruction</summary>
+		void end( ) {
+			if( nullptr != m_name ) {
+				record( );
+				m_name = nullptr;
+			}
+		}
+
+		/// <summary>Attach a value such as rows or bytes, shown with the span.  Extra counters are dropped</summary>
+		void counter( char const * name, int64_t value ) {
+			if( nullptr != m_name && m_counter_count < max_counters ) {
+				m_counters[m_counter_count++] = counter_t{ name, value };
+			}
+		}
+	};	// trace_span_t
+}	// namespace daw
+
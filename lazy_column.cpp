@@ -0,0 +1,115 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+
+#include "csv_parser.h"
+#include "lazy_column.h"
+
+namespace daw {
+	namespace data {
+		lazy_column_t::lazy_column_t( ::std::shared_ptr<csv_source_t const> source, size_t field ):
+				m_source( ::std::move( source ) ),
+				m_field( field ),
+				m_blocks( ) {
+
+			auto const count = block_count( );
+			m_blocks.reset( new ::std::atomic<block_t const *>[count] );
+			for( size_t n = 0; n < count; ++n ) {
+				m_blocks[n].store( nullptr, ::std::memory_order_relaxed );
+			}
+		}
+
+		lazy_column_t::~lazy_column_t( ) {
+			auto const count = block_count( );
+			for( size_t n = 0; n < count; ++n ) {
+				delete m_blocks[n].load( ::std::memory_order_relaxed );
+			}
+		}
+
+		size_t lazy_column_t::block_count( ) const {
+			return (size( ) + s_rows_per_block - 1) / s_rows_per_block;
+		}
+
+		lazy_column_t::block_t const & lazy_column_t::block( size_t n ) const {
+			auto result = m_blocks[n].load( ::std::memory_order_acquire );
+			if( nullptr != result ) {
+				return *result;
+			}
+			auto const first = n * s_rows_per_block;
+			auto const last = ::std::min( first + s_rows_per_block, size( ) );
+			::std::unique_ptr<block_t> decoded( new block_t( ) );
+			decoded->cells.reserve( last - first );
+			for( auto row = first; row < last; ++row ) {
+				auto cell = decode_csv_field( m_source->text, static_cast<size_t>(m_source->row_offsets[row]), m_field );
+#if PACK_VARIANT
+				decoded->cells.emplace_back( cell, decoded->arena );
+#else
+				decoded->cells.push_back( ::std::move( cell ) );
+#endif
+			}
+			decoded->arena.shrink_to_fit( );
+			// Another reader may have decoded the block meanwhile, theirs is kept as it may already be in use
+			if( m_blocks[n].compare_exchange_strong( result, decoded.get( ), ::std::memory_order_acq_rel, ::std::memory_order_acquire ) ) {
+				return *decoded.release( );
+			}
+			return *result;
+		}
+
+		size_t lazy_column_t::size( ) const {
+			return m_source->row_offsets.size( );
+		}
+
+		size_t lazy_column_t::decoded_blocks( ) const {
+			size_t result = 0;
+			auto const count = block_count( );
+			for( size_t n = 0; n < count; ++n ) {
+				if( nullptr != m_blocks[n].load( ::std::memory_order_acquire ) ) {
+					++result;
+				}
+			}
+			return result;
+		}
+
+		bool lazy_column_t::is_decoded( size_t row ) const {
+			return nullptr != m_blocks[row / s_rows_per_block].load( ::std::memory_order_acquire );
+		}
+
+		size_t lazy_column_t::footprint( ) const {
+			auto const count = block_count( );
+			size_t result = count * sizeof( ::std::atomic<block_t const *> );
+			for( size_t n = 0; n < count; ++n ) {
+				auto const decoded = m_blocks[n].load( ::std::memory_order_acquire );
+				if( nullptr != decoded ) {
+					result += sizeof( block_t ) + decoded->cells.capacity( ) * sizeof( value_type ) + decoded->arena.footprint( );
+				}
+			}
+			return result;
+		}
+
+		size_t lazy_column_t::source_footprint( ) const {
+			return m_source->text.capacity( ) + m_source->row_offsets.capacity( ) * sizeof( uint64_t );
+		}
+	}	// namespace data
+}	// namespace daw
+
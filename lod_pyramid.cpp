@@ -0,0 +1,137 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <daw/daw_exception.h>
+
+#include "lod_pyramid.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		float lod_sample_t::mean( ) const {
+			return 0 == count ? 0.0f : sum / static_cast<float>(count);
+		}
+
+		int lod_sample_t::x_mid( ) const {
+			return x_first + (x_last - x_first) / 2;
+		}
+
+		namespace {
+			lod_sample_t merge( lod_sample_t const & a, lod_sample_t const & b ) {
+				return lod_sample_t{ a.x_first, b.x_last, ::std::min( a.low, b.low ), ::std::max( a.high, b.high ), a.sum + b.sum, a.count + b.count };
+			}
+		}	// namespace anonymous
+
+		lod_pyramid_t::lod_pyramid_t( ):
+				m_levels{ } { }
+
+		lod_pyramid_t::lod_pyramid_t( ::std::vector<int> const & xs, ::std::vector<float> const & ys ):
+				m_levels{ } {
+
+			daw::exception::dbg_throw_on_false( xs.size( ) == ys.size( ), ": Each x value must have a y value" );
+			if( xs.empty( ) ) {
+				return;
+			}
+			{
+				::std::vector<lod_sample_t> base;
+				base.reserve( xs.size( ) );
+				for( size_t n = 0; n < xs.size( ); ++n ) {
+					base.push_back( lod_sample_t{ xs[n], xs[n], ys[n], ys[n], ys[n], 1 } );
+				}
+				m_levels.push_back( ::std::move( base ) );
+			}
+			while( m_levels.back( ).size( ) > 1 ) {
+				auto const & prev = m_levels.back( );
+				::std::vector<lod_sample_t> next;
+				next.reserve( (prev.size( ) + 1) / 2 );
+				size_t n = 0;
+				for( ; n + 1 < prev.size( ); n += 2 ) {
+					next.push_back( merge( prev[n], prev[n + 1] ) );
+				}
+				if( n < prev.size( ) ) {
+					next.push_back( prev[n] );
+				}
+				m_levels.push_back( ::std::move( next ) );
+			}
+		}
+
+		bool lod_pyramid_t::empty( ) const {
+			return m_levels.empty( );
+		}
+
+		size_t lod_pyramid_t::levels( ) const {
+			return m_levels.size( );
+		}
+
+		size_t lod_pyramid_t::footprint( ) const {
+			auto result = m_levels.capacity( ) * sizeof( m_levels[0] );
+			for( auto const & level : m_levels ) {
+				result += level.capacity( ) * sizeof( lod_sample_t );
+			}
+			return result;
+		}
+
+		::std::vector<lod_sample_t> const & lod_pyramid_t::level( size_t level_no ) const {
+			return m_levels[level_no];
+		}
+
+		int lod_pyramid_t::x_min( ) const {
+			return m_levels.back( ).front( ).x_first;
+		}
+
+		int lod_pyramid_t::x_max( ) const {
+			return m_levels.back( ).back( ).x_last;
+		}
+
+		::std::pair<float, float> lod_pyramid_t::y_minmax( ) const {
+			auto const & top = m_levels.back( ).front( );
+			return{ top.low, top.high };
+		}
+
+		::std::pair<size_t, size_t> lod_pyramid_t::range( size_t level_no, int x_first, int x_last ) const {
+			auto const & lvl = m_levels[level_no];
+			auto const first = ::std::lower_bound( lvl.begin( ), lvl.end( ), x_first, []( lod_sample_t const & sample, int x ) {
+				return sample.x_last < x;
+			} );
+			auto const last = ::std::upper_bound( first, lvl.end( ), x_last, []( int x, lod_sample_t const & sample ) {
+				return x < sample.x_first;
+			} );
+			return{ static_cast<size_t>(first - lvl.begin( )), static_cast<size_t>(last - lvl.begin( )) };
+		}
+
+		size_t lod_pyramid_t::level_for( int x_first, int x_last, size_t max_buckets ) const {
+			if( m_levels.empty( ) ) {
+				throw ::std::runtime_error( ": Cannot choose a level of an empty pyramid" );
+			}
+			for( size_t level_no = 0; level_no < m_levels.size( ); ++level_no ) {
+				auto const rng = range( level_no, x_first, x_last );
+				if( rng.second - rng.first <= max_buckets ) {
+					return level_no;
+				}
+			}
+			return m_levels.size( ) - 1;
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
@@ -0,0 +1,205 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <utility>
+
+#include <daw/csv_helper/data_cell.h>
+
+#include "allocation_tracker.h"
+#include "memory_report.h"
+#include "pump_data_analysis.h"
+#include "task_pool.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		namespace {
+#if PACK_VARIANT
+			size_t cell_heap_bytes( daw::data::cell_ref_t const & ) {
+				// Long text is in the table's string arena, counted once for the table
+				return 0;
+			}
+#else
+			size_t cell_heap_bytes( daw::data::DataCell const & cell ) {
+				// Text that fits the string's own buffer costs nothing extra
+				static size_t const s_inline_capacity = ::std::string( ).capacity( );
+				if( daw::data::DataCellType::string == cell.type( ) ) {
+					auto const capacity = cell.string( ).capacity( );
+					if( capacity > s_inline_capacity ) {
+						return capacity + 1;
+					}
+				}
+				return 0;
+			}
+#endif
+
+			::std::string format_bytes( double bytes ) {
+				char buff[32];
+				if( bytes >= 1024.0 * 1024.0 ) {
+					snprintf( buff, sizeof( buff ), "%.1f MiB", bytes / (1024.0 * 1024.0) );
+				} else if( bytes >= 1024.0 ) {
+					snprintf( buff, sizeof( buff ), "%.1f KiB", bytes / 1024.0 );
+				} else {
+					snprintf( buff, sizeof( buff ), "%.0f B", bytes );
+				}
+				return buff;
+			}
+
+			void write_line( ::std::ostream & os, ::std::string const & name, size_t count, double bytes ) {
+				char buff[160];
+				snprintf( buff, sizeof( buff ), "    %-36s %12llu %12s\n", name.c_str( ), static_cast<unsigned long long>(count), format_bytes( bytes ).c_str( ) );
+				os << buff;
+			}
+		}	// namespace anonymous
+
+		char const * cell_type_name( daw::data::DataCellType cell_type ) {
+			switch( cell_type ) {
+			case daw::data::DataCellType::empty_string:
+				return "empty";
+			case daw::data::DataCellType::string:
+				return "text";
+			case daw::data::DataCellType::real:
+				return "real";
+			case daw::data::DataCellType::timestamp:
+				return "timestamp";
+			}
+			return "unknown";
+		}
+
+		table_memory_t measure_table_memory( daw::data::compact_table_t const & data_table ) {
+			table_memory_t result;
+			result.columns.reserve( data_table.size( ) );
+			for( auto const & column : data_table ) {
+				column_memory_t column_memory;
+				column_memory.header = column.header( );
+				column_memory.sparse = column.is_sparse( );
+				column_memory.packed = column.is_packed( );
+				column_memory.lazy = column.is_lazy( );
+				// The column's own storage, which for a sparse column includes its row bitmap
+				column_memory.memory.bytes = column.footprint( );
+				if( column_memory.lazy ) {
+					result.total_bytes += column_memory.memory.bytes;
+					result.columns.push_back( ::std::move( column_memory ) );
+					continue;
+				}
+				for( auto const & cell : column ) {
+					if( column_memory.sparse && cell.empty( ) ) {
+						continue;	// Not stored
+					}
+					auto const heap_bytes = cell_heap_bytes( cell );
+					auto & cell_type = result.cell_types[static_cast<size_t>(cell.type( ))];
+					++cell_type.cells;
+					cell_type.bytes += column.cell_size( ) + heap_bytes;
+					++column_memory.memory.cells;
+					column_memory.memory.bytes += heap_bytes;
+				}
+				result.total_bytes += column_memory.memory.bytes;
+				result.columns.push_back( ::std::move( column_memory ) );
+			}
+			result.string_arena_bytes = data_table.arena_footprint( );
+			result.total_bytes += result.string_arena_bytes;
+			result.lazy_source_bytes = data_table.lazy_source_footprint( );
+			result.total_bytes += result.lazy_source_bytes;
+			return result;
+		}
+
+		size_t memory_report_t::display_list_bytes( ) const {
+			size_t result = 0;
+			for( auto const & display_list : display_lists ) {
+				result += display_list.second;
+			}
+			return result;
+		}
+
+		size_t memory_report_t::total_bytes( ) const {
+			return table.total_bytes + display_list_bytes( );
+		}
+
+		memory_report_t make_memory_report( ::std::string filename, daw::data::compact_table_t const & data_table ) {
+			memory_report_t result;
+			boost::system::error_code ec;
+			auto const file_size = boost::filesystem::file_size( filename, ec );
+			result.file_bytes = ec ? 0 : static_cast<size_t>(file_size);
+			result.load_estimate = load_memory_estimate( filename );
+			result.table = measure_table_memory( data_table );
+			result.filename = ::std::move( filename );
+			return result;
+		}
+
+		void write_memory_report( ::std::ostream & os, ::std::vector<memory_report_t> const & reports ) {
+			char buff[160];
+			size_t total = 0;
+			for( auto const & report : reports ) {
+				os << report.filename << '\n';
+				snprintf( buff, sizeof( buff ), "  %s, %s file, %s estimated at load, %.1f bytes per file byte\n", format_bytes( static_cast<double>(report.total_bytes( )) ).c_str( ),
+					format_bytes( static_cast<double>(report.file_bytes) ).c_str( ), format_bytes( static_cast<double>(report.load_estimate) ).c_str( ),
+					0 == report.file_bytes ? 0.0 : static_cast<double>(report.table.total_bytes) / static_cast<double>(report.file_bytes) );
+				os << buff;
+				os << "  Columns\n";
+				for( auto const & column : report.table.columns ) {
+					auto const name = column.sparse ? column.header + " (sparse)" : column.packed ? column.header + " (packed)" : column.lazy ? column.header + " (lazy)" : column.header;
+					write_line( os, name, column.memory.cells, static_cast<double>(column.memory.bytes) );
+				}
+				if( 0 != report.table.string_arena_bytes ) {
+					write_line( os, "String arena", 1, static_cast<double>(report.table.string_arena_bytes) );
+				}
+				if( 0 != report.table.lazy_source_bytes ) {
+					write_line( os, "Lazy column text", 1, static_cast<double>(report.table.lazy_source_bytes) );
+				}
+				os << "  Cell types\n";
+				for( size_t n = 0; n < report.table.cell_types.size( ); ++n ) {
+					auto const & cell_type = report.table.cell_types[n];
+					write_line( os, cell_type_name( static_cast<daw::data::DataCellType>(n) ), cell_type.cells, static_cast<double>(cell_type.bytes) );
+				}
+				if( !report.display_lists.empty( ) ) {
+					os << "  Display lists\n";
+					for( auto const & display_list : report.display_lists ) {
+						write_line( os, display_list.first, 1, static_cast<double>(display_list.second) );
+					}
+				}
+				os << '\n';
+				total += report.total_bytes( );
+			}
+
+			auto & pool = task_pool_t::get( );
+			snprintf( buff, sizeof( buff ), "All files: %s.  Task pool: %s of a %s budget in use\n", format_bytes( static_cast<double>(total) ).c_str( ),
+				format_bytes( static_cast<double>(pool.memory_in_use( )) ).c_str( ), format_bytes( static_cast<double>(pool.memory_budget( )) ).c_str( ) );
+			os << buff;
+			if( !allocation_tracking_enabled( ) ) {
+				os << "Allocations by phase are only counted when built with TRACK_ALLOCATIONS\n";
+				return;
+			}
+			os << "Allocations by phase\n";
+			snprintf( buff, sizeof( buff ), "    %-16s %12s %14s %14s\n", "phase", "allocations", "allocated", "live" );
+			os << buff;
+			auto const phases = phase_allocations( );
+			for( size_t n = 0; n < phases.size( ); ++n ) {
+				snprintf( buff, sizeof( buff ), "    %-16s %12llu %14s %14s\n", alloc_phase_name( static_cast<alloc_phase_t>(n) ), static_cast<unsigned long long>(phases[n].allocations),
+					format_bytes( static_cast<double>(phases[n].bytes_allocated) ).c_str( ), format_bytes( static_cast<double>(phases[n].bytes_live) ).c_str( ) );
+				os << buff;
+			}
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
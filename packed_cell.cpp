@@ -0,0 +1,183 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "packed_cell.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			timestamp_t const & epoch( ) {
+				static timestamp_t const s_epoch( boost::gregorian::date( 1970, 1, 1 ) );
+				return s_epoch;
+			}
+		}	// namespace anonymous
+
+		string_arena_t::string_arena_t( ):
+				m_text( ) { }
+
+		uint32_t string_arena_t::add( boost::string_ref text ) {
+			if( m_text.size( ) + text.size( ) > ::std::numeric_limits<uint32_t>::max( ) ) {
+				throw ::std::length_error( ": String arena is full" );
+			}
+			auto const result = static_cast<uint32_t>(m_text.size( ));
+			m_text.insert( m_text.end( ), text.begin( ), text.end( ) );
+			return result;
+		}
+
+		size_t string_arena_t::size( ) const {
+			return m_text.size( );
+		}
+
+		size_t string_arena_t::footprint( ) const {
+			return m_text.capacity( );
+		}
+
+		void string_arena_t::shrink_to_fit( ) {
+			m_text.shrink_to_fit( );
+		}
+
+		packed_cell_t::packed_cell_t( ):
+				m_bytes( ),
+				m_tag( tag_t::empty ),
+				m_size( 0 ) { }
+
+		packed_cell_t::packed_cell_t( DataCell const & cell, string_arena_t & arena ):
+				packed_cell_t( ) {
+
+			if( cell.empty( ) ) {
+				return;
+			}
+			switch( cell.type( ) ) {
+			case DataCellType::string: {
+				auto const & text = cell.string( );
+				if( text.size( ) <= inline_capacity ) {
+					::std::memcpy( m_bytes, text.data( ), text.size( ) );
+					m_size = static_cast<uint8_t>(text.size( ));
+					m_tag = tag_t::inline_string;
+				} else {
+					if( text.size( ) > ::std::numeric_limits<uint32_t>::max( ) ) {
+						throw ::std::length_error( ": Cell text is too long to pack" );
+					}
+					uint32_t const location[2] = { arena.add( text ), static_cast<uint32_t>(text.size( )) };
+					::std::memcpy( m_bytes, location, sizeof( location ) );
+					m_tag = tag_t::arena_string;
+				}
+				break;
+			}
+			case DataCellType::real: {
+				auto const value = cell.real( );
+				static_assert( sizeof( value ) <= inline_capacity, "A real must fit a packed cell" );
+				::std::memcpy( m_bytes, &value, sizeof( value ) );
+				m_tag = tag_t::real;
+				break;
+			}
+			case DataCellType::timestamp: {
+				auto const value = cell.timestamp( );
+				int64_t ticks = 0;
+				if( value.is_not_a_date_time( ) ) {
+					m_size = 1;
+				} else {
+					ticks = (value - epoch( )).ticks( );
+				}
+				::std::memcpy( m_bytes, &ticks, sizeof( ticks ) );
+				m_tag = tag_t::timestamp;
+				break;
+			}
+			case DataCellType::empty_string:
+				break;
+			}
+		}
+
+		DataCellType packed_cell_t::type( ) const {
+			switch( m_tag ) {
+			case tag_t::inline_string:
+			case tag_t::arena_string:
+				return DataCellType::string;
+			case tag_t::real:
+				return DataCellType::real;
+			case tag_t::timestamp:
+				return DataCellType::timestamp;
+			case tag_t::empty:
+				break;
+			}
+			return DataCellType::empty_string;
+		}
+
+		real_t packed_cell_t::real( ) const {
+			if( tag_t::real != m_tag ) {
+				throw ::std::logic_error( ": Cell does not hold a real" );
+			}
+			real_t result;
+			::std::memcpy( &result, m_bytes, sizeof( result ) );
+			return result;
+		}
+
+		timestamp_t packed_cell_t::timestamp( ) const {
+			if( tag_t::timestamp != m_tag ) {
+				throw ::std::logic_error( ": Cell does not hold a timestamp" );
+			}
+			if( 1 == m_size ) {
+				return timestamp_t( boost::date_time::not_a_date_time );
+			}
+			int64_t ticks;
+			::std::memcpy( &ticks, m_bytes, sizeof( ticks ) );
+			return epoch( ) + boost::posix_time::time_duration( 0, 0, 0, ticks );
+		}
+
+		boost::string_ref packed_cell_t::string( string_arena_t const & arena ) const {
+			switch( m_tag ) {
+			case tag_t::inline_string:
+				return boost::string_ref( m_bytes, m_size );
+			case tag_t::arena_string: {
+				uint32_t location[2];
+				::std::memcpy( location, m_bytes, sizeof( location ) );
+				return arena.get( location[0], location[1] );
+			}
+			default:
+				return boost::string_ref( );
+			}
+		}
+
+		::std::string cell_ref_t::to_string( ) const {
+			if( nullptr != m_cell ) {
+				return m_cell->to_string( );
+			}
+			switch( m_packed->type( ) ) {
+			case DataCellType::string:
+				return m_packed->string( *m_arena ).to_string( );
+			case DataCellType::real:
+				return DataCell( m_packed->real( ) ).to_string( );
+			case DataCellType::timestamp:
+				return DataCell( m_packed->timestamp( ) ).to_string( );
+			case DataCellType::empty_string:
+				break;
+			}
+			return ::std::string( );
+		}
+	}	// namespace data
+}	// namespace daw
+
@@ -0,0 +1,91 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <exception>
+
+#include "panel_async_plot.h"
+
+namespace {
+	int const s_poll_ms = 50;
+	int const s_timer_id = wxID_HIGHEST + 1;
+}	// namespace anonymous
+
+PanelAsyncPlot::PanelAsyncPlot( wxWindow *parent, wxPoint position, wxSize sz ): 
+		wxPanel( parent, wxID_ANY, position, sz ), 
+		m_pending( ), 
+		m_gen_plot( ), 
+		m_status( "Building plot..." ), 
+		m_timer( this, s_timer_id ) { }
+
+PanelAsyncPlot::~PanelAsyncPlot( ) {
+	m_timer.Stop( );
+}
+
+bool PanelAsyncPlot::is_plot_ready( ) const {
+	return static_cast<bool>(m_gen_plot);
+}
+
+size_t PanelAsyncPlot::display_list_bytes( ) const {
+	return m_gen_plot ? m_gen_plot->footprint( ) : 0;
+}
+
+void PanelAsyncPlot::build_plot( ::std::unique_ptr<daw::pumpdataanalysis::graph_config_t> graph_config, daw::pumpdataanalysis::async_plot_t::builder_t builder ) {
+	m_gen_plot.reset( );
+	m_status = "Building plot...";
+	m_pending = daw::pumpdataanalysis::async_plot_t( ::std::move( graph_config ), ::std::move( builder ) );
+	m_timer.Start( s_poll_ms );
+	Refresh( );
+}
+
+void PanelAsyncPlot::on_timer( wxTimerEvent& ) {
+	if( !m_pending.is_ready( ) ) {
+		return;
+	}
+	m_timer.Stop( );
+	try {
+		m_gen_plot = m_pending.get( );
+	} catch( ::std::exception const & ex ) {
+		m_status = wxString( "Could not build plot: " ) + ex.what( );
+	}
+	m_pending = daw::pumpdataanalysis::async_plot_t( );
+	Refresh( );
+}
+
+void PanelAsyncPlot::on_paint( wxPaintEvent& ) {
+	wxPaintDC dc( this );
+	wxSize area( GetClientSize( ) );
+	if( area.GetWidth( ) <= 0 || area.GetHeight( ) <= 0 ) {
+		return;
+	}
+	if( m_gen_plot ) {
+		m_gen_plot->plot( dc, ::std::move( area ) );
+	} else {
+		daw::pumpdataanalysis::draw_plot_placeholder( dc, ::std::move( area ), m_status );
+	}
+}
+
+BEGIN_EVENT_TABLE( PanelAsyncPlot, wxPanel )
+EVT_PAINT( PanelAsyncPlot::on_paint )
+EVT_TIMER( s_timer_id, PanelAsyncPlot::on_timer )
+END_EVENT_TABLE( )
+
@@ -0,0 +1,216 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <exception>
+#include <iterator>
+#include <string>
+
+#include "frame_pump_data_analysis.h"
+#include "panel_basal_tests.h"
+#include "panel_data_plot.h"
+#include "string_helpers.h"
+
+PanelBasalTests::PanelBasalTests( wxWindow *parent, ::std::function<void( wxMenuBar* menu )> addmenu_cb, const daw::data::compact_table_t& dt, const ::std::vector<std::pair<daw::data::compact_table_t::size_type, daw::data::compact_table_t::size_type>> positions, size_t cache_budget ): 
+		wxPanel( parent, wxID_ANY ), 
+		m_data( dt ), 
+		m_basal_positions( positions ), 
+		m_addmenu_cb( addmenu_cb ),
+		m_list( nullptr ),
+		m_plot_area( nullptr ),
+		m_cache_budget( cache_budget ),
+		m_cache_bytes( 0 ),
+		m_lru( ),
+		m_cache( ),
+		m_pending( ),
+		m_failed( ),
+		m_timer( this ) {
+
+	m_list = new wxListBox( this, wxID_ANY, wxDefaultPosition, wxSize( 260, -1 ), 0, nullptr, wxLB_SINGLE );
+	m_plot_area = new wxPanel( this, wxID_ANY );
+
+	// Titles are cheap, plots are not.  Only the titles are made up front
+	auto const& col_ts = m_data["Timestamp"];
+	daw::string::ptime_formatter_t const title_format( "%Y-%m-%d %H:%M" );
+	for( auto const& period : m_basal_positions ) {
+		std::string const title = title_format.to_string( col_ts[period.first].timestamp( ) ) + " -> " + title_format.to_string( col_ts[period.second].timestamp( ) );
+		m_list->Append( title );
+	}
+
+	auto sizer = new wxBoxSizer( wxHORIZONTAL );
+	sizer->Add( m_list, 0, wxEXPAND );
+	sizer->Add( m_plot_area, 1, wxEXPAND );
+	SetSizer( sizer );
+
+	m_list->Bind( wxEVT_LISTBOX, &PanelBasalTests::on_select, this );
+	m_plot_area->Bind( wxEVT_PAINT, &PanelBasalTests::on_paint_plot, this );
+	Bind( wxEVT_TIMER, &PanelBasalTests::on_timer, this );
+
+	if( !m_basal_positions.empty( ) ) {
+		m_list->SetSelection( 0 );
+		request_selection( );
+	}
+
+	// create our menu bar: it will be shown instead of the main frame one when
+	// we're active
+	auto mbar = FramePumpDataAnalysis::create_menu_bar( );
+	mbar->GetMenu( 0 )->Insert( 1, wxID_CLOSE, "&Close child\tCtrl-W", "Close this window" );
+
+	// Associate the menu bar with the frame
+	addmenu_cb( mbar );
+}
+
+size_t PanelBasalTests::cache_bytes( ) const {
+	return m_cache_bytes;
+}
+
+daw::pumpdataanalysis::PanelGenericPlotter * PanelBasalTests::get_plot( size_t test_no ) {
+	auto pos = m_cache.find( test_no );
+	if( m_cache.end( ) == pos ) {
+		return nullptr;
+	}
+	m_lru.splice( m_lru.begin( ), m_lru, pos->second.lru_pos );
+	return pos->second.plot.get( );
+}
+
+void PanelBasalTests::request_plot( size_t test_no ) {
+	if( test_no >= m_basal_positions.size( ) || 0 != m_cache.count( test_no ) || 0 != m_failed.count( test_no ) ) {
+		return;
+	}
+	// Neighbours of the selection are built ahead of time, behind anything the user is waiting for
+	auto const priority = m_list->GetSelection( ) == static_cast<int>(test_no) ? daw::task_priority_t::interactive : daw::task_priority_t::background;
+	auto const pending = m_pending.find( test_no );
+	if( m_pending.end( ) != pending ) {
+		// A prefetch the user has now selected is queued again ahead of other background work, unless it is
+		// already running.  Dropping one not started is quick, it is cancelled before the builder runs
+		if( priority >= pending->second.priority || pending->second.plot.is_started( ) ) {
+			return;
+		}
+		m_pending.erase( pending );
+	}
+	::std::unique_ptr<daw::pumpdataanalysis::graph_config_t> graph_config( new daw::pumpdataanalysis::graph_config_t( ) );
+	graph_config->axis_title_y = "mmol/L";
+	auto const period = m_basal_positions[test_no];
+	m_pending.emplace( test_no, pending_plot_t{ daw::pumpdataanalysis::async_plot_t( ::std::move( graph_config ), [&data = m_data, period]( daw::pumpdataanalysis::PanelGenericPlotter& gen_plot, daw::pumpdataanalysis::graph_config_t& graph_config, daw::cancellation_token_t const & ) {
+		daw::pumpdataanalysis::build_basal_test_plot( gen_plot, data, period.first, period.second, graph_config );
+	}, priority ), priority } );
+	if( !m_timer.IsRunning( ) ) {
+		m_timer.Start( 50 );
+	}
+}
+
+void PanelBasalTests::request_selection( ) {
+	auto const selection = m_list->GetSelection( );
+	if( selection < 0 ) {
+		return;
+	}
+	auto const test_no = static_cast<size_t>(selection);
+	cancel_prefetches( test_no );
+	request_plot( test_no );
+	for( size_t n = 1; n <= prefetch_radius; ++n ) {
+		request_plot( test_no + n );
+		if( test_no >= n ) {
+			request_plot( test_no - n );
+		}
+	}
+}
+
+void PanelBasalTests::cancel_prefetches( size_t selection ) {
+	for( auto it = m_pending.begin( ); it != m_pending.end( ); ) {
+		auto const distance = it->first > selection ? it->first - selection : selection - it->first;
+		// Destroying a started build would wait for it on the UI thread, it finishes and is cached instead
+		if( distance > prefetch_radius && !it->second.plot.is_started( ) ) {
+			it = m_pending.erase( it );
+		} else {
+			++it;
+		}
+	}
+}
+
+void PanelBasalTests::trim_cache( size_t keep_test_no ) {
+	while( m_cache_bytes > m_cache_budget && !m_lru.empty( ) && m_lru.back( ) != keep_test_no ) {
+		auto const pos = m_cache.find( m_lru.back( ) );
+		m_cache_bytes -= pos->second.bytes;
+		m_cache.erase( pos );
+		m_lru.pop_back( );
+	}
+}
+
+void PanelBasalTests::on_timer( wxTimerEvent& ) {
+	auto const selection = m_list->GetSelection( );
+	bool selection_done = false;
+	for( auto it = m_pending.begin( ); it != m_pending.end( ); ) {
+		if( !it->second.plot.is_ready( ) ) {
+			++it;
+			continue;
+		}
+		auto const test_no = it->first;
+		try {
+			auto plot = it->second.plot.get( );
+			auto const bytes = plot->footprint( );
+			// Finished prefetches are the least recently viewed, the selection the most
+			if( static_cast<size_t>(selection) == test_no ) {
+				m_lru.push_front( test_no );
+			} else {
+				m_lru.push_back( test_no );
+			}
+			auto const lru_pos = static_cast<size_t>(selection) == test_no ? m_lru.begin( ) : ::std::prev( m_lru.end( ) );
+			m_cache.emplace( test_no, cached_plot_t{ ::std::move( plot ), bytes, lru_pos } );
+			m_cache_bytes += bytes;
+		} catch( ::std::exception const & ex ) {
+			m_failed.emplace( test_no, wxString( "Could not build plot: " ) + ex.what( ) );
+		}
+		selection_done |= static_cast<size_t>(selection) == test_no;
+		it = m_pending.erase( it );
+	}
+	if( selection >= 0 ) {
+		trim_cache( static_cast<size_t>(selection) );
+	}
+	if( m_pending.empty( ) ) {
+		m_timer.Stop( );
+	}
+	if( selection_done ) {
+		m_plot_area->Refresh( );
+	}
+}
+
+void PanelBasalTests::on_select( wxCommandEvent& ) {
+	request_selection( );
+	m_plot_area->Refresh( );
+}
+
+void PanelBasalTests::on_paint_plot( wxPaintEvent& ) {
+	wxPaintDC dc( m_plot_area );
+	auto const selection = m_list->GetSelection( );
+	wxSize area( m_plot_area->GetClientSize( ) );
+	if( selection < 0 || static_cast<size_t>(selection) >= m_basal_positions.size( ) || area.GetWidth( ) <= 0 || area.GetHeight( ) <= 0 ) {
+		return;
+	}
+	auto const test_no = static_cast<size_t>(selection);
+	auto const plot = get_plot( test_no );
+	if( nullptr != plot ) {
+		plot->plot( dc, ::std::move( area ) );
+		return;
+	}
+	auto const failed = m_failed.find( test_no );
+	daw::pumpdataanalysis::draw_plot_placeholder( dc, ::std::move( area ), m_failed.end( ) != failed ? failed->second : wxString( "Building plot..." ) );
+}
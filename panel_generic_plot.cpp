@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <string>
 
 #include <daw/csv_helper/data_table.h>
@@ -29,9 +30,12 @@
 #include <daw/daw_math.h>
 #include <daw/daw_string.h>
 
+#include "allocation_tracker.h"
 #include "defs.h"
 #include "panel_generic_plot.h"
+#include "point_array.h"
 #include "string_helpers.h"
+#include "trace.h"
 
 namespace daw {
 	namespace pumpdataanalysis {
@@ -39,15 +43,15 @@ namespace daw {
 		using namespace daw::exception;
 
 		graph_config_t::graph_config_t( ): 
-				pen_line_average{ *wxBLUE, 3, wxSOLID }, 
+				pen_line_average{ { 0, 0, 255 }/*blue*/, 3, wxSOLID }, 
 				pen_line_high{ { 255, 140, 0 }/*orange*/, 3, wxSOLID }, 
-				pen_line_low{ *wxGREEN, 3, wxSOLID }, 
+				pen_line_low{ { 0, 255, 0 }/*green*/, 3, wxSOLID }, 
 				pen_line_count{ { 49, 0, 98 }/*purple*/, 2, wxSOLID }, 
 				pen_area_std_dev{ { 192, 192, 255 }/*light blue*/, 1, wxPENSTYLE_SOLID }, 
-				pen_axis_x{ *wxRED, 2, wxSOLID }, 
-				pen_axis_y{ *wxRED, 2, wxSOLID }, 
-				pen_axis_dotted{ *wxRED, 1, wxDOT }, 
-				pen_axis_count{ *wxBLUE, 2, wxSOLID }, 
+				pen_axis_x{ { 255, 0, 0 }/*red*/, 2, wxSOLID }, 
+				pen_axis_y{ { 255, 0, 0 }/*red*/, 2, wxSOLID }, 
+				pen_axis_dotted{ { 255, 0, 0 }/*red*/, 1, wxDOT }, 
+				pen_axis_count{ { 0, 0, 255 }/*blue*/, 2, wxSOLID }, 
 				fnt_axis_title{ 10, wxFONTFAMILY_MODERN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL }, 
 				fnt_axis_title_bold{ 10, wxFONTFAMILY_MODERN, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD }, 
 				brush_area_std_dev{ { 192, 192, 255 }/*light blue*/, wxSOLID }, 
@@ -56,6 +60,23 @@ namespace daw {
 				axis_title_count( ), 
 				coord_data( ) { }
 
+		namespace {
+			daw::string::ptime_formatter_t const & label_format_time( ) {
+				static daw::string::ptime_formatter_t const s_format( "%H:%M" );
+				return s_format;
+			}
+
+			daw::string::ptime_formatter_t const & label_format_time_date( ) {
+				static daw::string::ptime_formatter_t const s_format( "%H:%M %b %d" );
+				return s_format;
+			}
+
+			daw::string::ptime_formatter_t const & label_format_date( ) {
+				static daw::string::ptime_formatter_t const s_format( "%Y-%m-%d" );
+				return s_format;
+			}
+		}	// namespace anonymous
+
 		namespace impl {
 			namespace {
 				auto get_mapped_x = []( int x, const translation_t& coord_data ) {
@@ -64,13 +85,11 @@ namespace daw {
 					return static_cast<int>((x - min_point.pos( ).x)*scale.x + coord_data.margins.left);
 				};
 
-				#if 0
 				auto get_unmapped_x = []( int x, const translation_t& coord_data ) {
 					auto const& min_point = coord_data.item_bounds.point1;
 					auto const& scale = coord_data.scale;
-					return static_cast<int>( static_cast<daw::data::real_t>(x - coord_data.margins.left) / scale.x) + min_point.pos( ).x;
+					return static_cast<int>( static_cast<daw::data::real_t>(x - static_cast<int>(coord_data.margins.left)) / scale.x) + min_point.pos( ).x;
 				};
-				#endif
 				
 				auto get_mapped_y = []( int y, const translation_t& coord_data ) {
 					auto const& min_point = coord_data.item_bounds.point1;
@@ -78,13 +97,11 @@ namespace daw {
 					return coord_data.panel_bounds.GetHeight( ) - static_cast<int>((y - min_point.pos( ).y)*scale.y + coord_data.margins.bottom);
 				};
 
-				#if 0
 				auto get_unmapped_y = []( int y, const translation_t& coord_data ) {
 					auto const& min_point = coord_data.item_bounds.point1;
 					auto const& scale = coord_data.scale;
-					return static_cast<int>(static_cast<daw::data::real_t>((coord_data.panel_bounds.GetHeight( )-y) - coord_data.margins.bottom) / scale.y) + min_point.pos( ).y;
+					return static_cast<int>(static_cast<daw::data::real_t>((coord_data.panel_bounds.GetHeight( )-y) - static_cast<int>(coord_data.margins.bottom)) / scale.y) + min_point.pos( ).y;
 				};
-				#endif
 
 			}	//namespace anonymous
 		}	//namespace impl
@@ -199,9 +216,13 @@ namespace daw {
 				PanelGenericPlotActionPen( PanelGenericPlotActionPen const & ) = delete;
 				PanelGenericPlotActionPen & operator=( PanelGenericPlotActionPen const & ) = delete;
 
-				void do_plot( wxDC & dc, translation_t & ) override {
+				void do_plot( wxDC & dc, translation_t &, ::std::vector<wxPoint> & ) override {
 					dc.SetPen( m_pen );
 				}
+
+				size_t footprint( ) const override {
+					return sizeof( *this );
+				}
 			};	// PanelGenericPlotActionPen
 
 			PanelGenericPlotActionPen::~PanelGenericPlotActionPen( ) { }
@@ -221,9 +242,13 @@ namespace daw {
 				PanelGenericPlotActionFont( PanelGenericPlotActionFont const & ) = delete;
 				PanelGenericPlotActionFont & operator=( PanelGenericPlotActionFont const & ) = delete;
 
-				void do_plot( wxDC & dc, translation_t & ) override {
+				void do_plot( wxDC & dc, translation_t &, ::std::vector<wxPoint> & ) override {
 					dc.SetFont( m_font );
 				}
+
+				size_t footprint( ) const override {
+					return sizeof( *this );
+				}
 			};	// PanelGenericPlotActionFont
 
 			PanelGenericPlotActionFont::~PanelGenericPlotActionFont( ) { }
@@ -243,9 +268,13 @@ namespace daw {
 				PanelGenericPlotActionBrush( PanelGenericPlotActionBrush const & ) = delete;
 				PanelGenericPlotActionBrush & operator=( PanelGenericPlotActionBrush const & ) = delete;
 
-				void do_plot( wxDC & dc, translation_t & ) override {
+				void do_plot( wxDC & dc, translation_t &, ::std::vector<wxPoint> & ) override {
 					dc.SetBrush( m_brush );
 				}
+
+				size_t footprint( ) const override {
+					return sizeof( *this );
+				}
 			};	// PanelGenericPlotActionBrush
 
 			PanelGenericPlotActionBrush::~PanelGenericPlotActionBrush( ) { }
@@ -267,9 +296,13 @@ namespace daw {
 				PanelGenericPlotActionDrawText( PanelGenericPlotActionDrawText const & ) = delete;
 				PanelGenericPlotActionDrawText & operator=( PanelGenericPlotActionDrawText const & ) = delete;
 
-				void do_plot( wxDC & dc, translation_t & coord_data ) override {
+				void do_plot( wxDC & dc, translation_t & coord_data, ::std::vector<wxPoint> & ) override {
 					dc.DrawText( m_text, m_point.mapped_point( coord_data ) );
 				}
+
+				size_t footprint( ) const override {
+					return sizeof( *this ) + m_text.length( ) * sizeof( wchar_t );
+				}
 			};	// PanelGenericPlotActionDrawText
 
 			PanelGenericPlotActionDrawText::~PanelGenericPlotActionDrawText( ) { }
@@ -292,9 +325,13 @@ namespace daw {
 				PanelGenericPlotActionDrawRotatedText( PanelGenericPlotActionDrawRotatedText const & ) = delete;
 				PanelGenericPlotActionDrawRotatedText & operator=( PanelGenericPlotActionDrawRotatedText const & ) = delete;
 
-				void do_plot( wxDC & dc, translation_t & coord_data ) override {
+				void do_plot( wxDC & dc, translation_t & coord_data, ::std::vector<wxPoint> & ) override {
 					dc.DrawRotatedText( m_text, m_point.mapped_point( coord_data ), m_angle );
 				}
+
+				size_t footprint( ) const override {
+					return sizeof( *this ) + m_text.length( ) * sizeof( wchar_t );
+				}
 			};	// PanelGenericPlotActionDrawRotatedText
 
 			PanelGenericPlotActionDrawRotatedText::~PanelGenericPlotActionDrawRotatedText( ) { }
@@ -316,17 +353,21 @@ namespace daw {
 				PanelGenericPlotActionDrawLine( PanelGenericPlotActionDrawLine const & ) = delete;
 				PanelGenericPlotActionDrawLine & operator=( PanelGenericPlotActionDrawLine const & ) = delete;
 
-				void do_plot( wxDC & dc, translation_t & coord_data ) override {
+				void do_plot( wxDC & dc, translation_t & coord_data, ::std::vector<wxPoint> & ) override {
 					dc.DrawLine( m_point1.mapped_point( coord_data ), m_point2.mapped_point( coord_data ) );
 				}
+
+				size_t footprint( ) const override {
+					return sizeof( *this );
+				}
 			};	// PanelGenericPlotActionDrawLine
 
 			PanelGenericPlotActionDrawLine::~PanelGenericPlotActionDrawLine( ) { }
 
 			class PanelGenericPlotActionDrawLines final: public PanelGenericPlotAction {
-				::std::vector<point_t> m_points;
+				point_array_t m_points;
 			public:
-				PanelGenericPlotActionDrawLines( ::std::vector<point_t> points ):
+				PanelGenericPlotActionDrawLines( point_array_t points ):
 						PanelGenericPlotAction{ }, 
 						m_points{ ::std::move( points ) } { }
 
@@ -337,13 +378,13 @@ namespace daw {
 				PanelGenericPlotActionDrawLines( PanelGenericPlotActionDrawLines && ) = default;
 				PanelGenericPlotActionDrawLines & operator=( PanelGenericPlotActionDrawLines && ) = default;
 
-				void do_plot( wxDC & dc, translation_t & coord_data ) override {
-					::std::vector<wxPoint> points;
-					points.reserve( m_points.size( ) );
-					for( auto const & point : m_points ) {
-						points.emplace_back( point.mapped_point( coord_data ) );
-					}
-					dc.DrawLines( points.size( ), daw::algorithm::to_array( points ) );
+				void do_plot( wxDC & dc, translation_t & coord_data, ::std::vector<wxPoint> & point_buffer ) override {
+					m_points.map_points( coord_data, point_buffer );
+					dc.DrawLines( static_cast<int>(point_buffer.size( )), point_buffer.data( ) );
+				}
+
+				size_t footprint( ) const override {
+					return sizeof( *this ) - sizeof( m_points ) + m_points.footprint( );
 				}
 			};	// PanelGenericPlotActionDrawLines
 
@@ -351,10 +392,10 @@ namespace daw {
 
 
 			class PanelGenericPlotActionDrawPolygon final: public PanelGenericPlotAction {
-				::std::vector<point_t> const m_points;
+				point_array_t const m_points;
 
 			public:
-				PanelGenericPlotActionDrawPolygon( ::std::vector<point_t> points ):
+				PanelGenericPlotActionDrawPolygon( point_array_t points ):
 						PanelGenericPlotAction{ }, 
 						m_points{ ::std::move( points ) } { }
 
@@ -365,15 +406,13 @@ namespace daw {
 				PanelGenericPlotActionDrawPolygon & operator=( PanelGenericPlotActionDrawPolygon && ) = default;
 				~PanelGenericPlotActionDrawPolygon( ) override; 
 
-				void do_plot( wxDC & dc, translation_t & coord_data ) override {
-					::std::vector<wxPoint> points;
-					points.reserve( m_points.size( ) );
-
-					std::transform( m_points.begin( ), m_points.end( ), std::back_inserter( points ), [&coord_data]( auto const & point ) {
-						return point.mapped_point( coord_data );
-					} );
+				void do_plot( wxDC & dc, translation_t & coord_data, ::std::vector<wxPoint> & point_buffer ) override {
+					m_points.map_points( coord_data, point_buffer );
+					dc.DrawPolygon( static_cast<int>(point_buffer.size( )), point_buffer.data( ) );
+				}
 
-					dc.DrawPolygon( points.size( ), daw::algorithm::to_array( points ) );
+				size_t footprint( ) const override {
+					return sizeof( *this ) - sizeof( m_points ) + m_points.footprint( );
 				}
 			};	// PanelGenericPlotActionDrawPolygon
 
@@ -382,7 +421,10 @@ namespace daw {
 
 		PanelGenericPlotter::PanelGenericPlotter( ): 
 				m_coord_data( ), 
-				m_actions( ) { }
+				m_actions( ),
+				m_point_buffer( ),
+				m_last_font( ),
+				m_text_metrics( ) { }
 
 		translation_t& PanelGenericPlotter::coord_data( ) {
 			return m_coord_data;
@@ -405,8 +447,17 @@ namespace daw {
 			m_actions.emplace_back( ::std::unique_ptr<impl::PanelGenericPlotAction>( new impl::PanelGenericPlotActionBrush( ::std::move( brush ) ) ) );
 		}
 
+		void PanelGenericPlotter::set_text_metrics( ::std::shared_ptr<text_metrics_t const> metrics ) {
+			m_text_metrics = ::std::move( metrics );
+		}
+
 		point_t PanelGenericPlotter::get_text_size( wxString const & text ) const {
 			point_t bounds;
+			if( m_text_metrics ) {
+				auto const sz = m_text_metrics->get_text_extent( m_last_font, text );
+				bounds.pos( ) = wxPoint( sz.GetWidth( ), sz.GetHeight( ) );
+				return bounds;
+			}
 			wxMemoryDC dc;
 			wxCoord zero{ 0 };
 			dc.GetTextExtent( text, &bounds.pos( ).x, &bounds.pos( ).y, &zero, &zero, &m_last_font );
@@ -415,6 +466,11 @@ namespace daw {
 
 		box_t PanelGenericPlotter::get_rotated_text_size( wxString const & text, double angle ) const {
 			point_t point2;
+			if( m_text_metrics ) {
+				auto const sz = m_text_metrics->get_text_extent( m_last_font, text );
+				point2.pos( ) = wxPoint( sz.GetWidth( ), sz.GetHeight( ) );
+				return rotate_by( box_t{ point2 }, angle );
+			}
 			wxMemoryDC dc;
 			wxCoord zero{ 0 };
 			dc.GetTextExtent( text, &point2.pos( ).x, &point2.pos( ).y, &zero, &zero, &m_last_font );
@@ -437,17 +493,21 @@ namespace daw {
 		}
 
 		void PanelGenericPlotter::draw_lines( ::std::vector<point_t> points ) {
+			draw_lines( point_array_t{ points } );
+		}
+
+		void PanelGenericPlotter::draw_lines( point_array_t points ) {
 			daw::exception::dbg_throw_on_false( 2 <= points.size( ), ": Must specify at least two points" );
-			for( auto const& point : points ) {
-				check_minmax( point );
-			}
+			check_minmax( points );
 			m_actions.emplace_back( ::std::unique_ptr<impl::PanelGenericPlotAction>( new impl::PanelGenericPlotActionDrawLines( ::std::move( points ) ) ) );
 		}
 
 		void PanelGenericPlotter::draw_polygon( ::std::vector<point_t> points ) {
-			for( auto const& point : points ) {
-				check_minmax( point );
-			}
+			draw_polygon( point_array_t{ points } );
+		}
+
+		void PanelGenericPlotter::draw_polygon( point_array_t points ) {
+			check_minmax( points );
 			m_actions.emplace_back( ::std::unique_ptr<impl::PanelGenericPlotAction>( new impl::PanelGenericPlotActionDrawPolygon( ::std::move( points ) ) ) );
 		}
 
@@ -474,6 +534,16 @@ namespace daw {
 			check_minmax( points.point2 );
 		}
 
+		void PanelGenericPlotter::check_minmax( point_array_t const & points ) {
+			if( points.empty( ) ) {
+				return;
+			}
+			auto const x_minmax = ::std::minmax_element( points.x( ).begin( ), points.x( ).end( ) );
+			auto const y_minmax = ::std::minmax_element( points.y( ).begin( ), points.y( ).end( ) );
+			check_minmax( point_t{ *x_minmax.first, *y_minmax.first } );
+			check_minmax( point_t{ *x_minmax.second, *y_minmax.second } );
+		}
+
 		void PanelGenericPlotter::update_scale( wxSize bounds ) {
 			m_coord_data.panel_bounds = std::move( bounds );
 			m_coord_data.scale.x = static_cast<float>(bounds.GetWidth( ) - coord_data( ).margins.width( )) / static_cast<float>(m_coord_data.item_bounds.width( ));
@@ -481,13 +551,16 @@ namespace daw {
 		}
 
 		void PanelGenericPlotter::plot( wxDC & dc, wxSize bounds ) {
+			trace_span_t span( "paint" );
+			alloc_phase_scope_t phase( alloc_phase_t::rendering );
+			span.counter( "actions", static_cast<int64_t>(m_actions.size( )) );
 			dc.SetAxisOrientation( true, false );
 			dc.SetLogicalOrigin( 0, 0 );
 			dc.SetMapMode( wxMM_TEXT );
 			dc.SetBackgroundMode( wxTRANSPARENT );
 			update_scale( std::move( bounds ) );
 			for( auto& action : m_actions ) {
-				action->do_plot( dc, m_coord_data );
+				action->do_plot( dc, m_coord_data, m_point_buffer );
 			}
 			dc.SetPen( wxNullPen );
 			dc.SetBrush( wxNullBrush );
@@ -498,6 +571,34 @@ namespace daw {
 			m_actions.clear( );
 		}
 
+		size_t PanelGenericPlotter::footprint( ) const {
+			auto result = sizeof( *this ) + m_actions.capacity( ) * sizeof( m_actions[0] ) + m_point_buffer.capacity( ) * sizeof( wxPoint );
+			for( auto const & action : m_actions ) {
+				result += action->footprint( );
+			}
+			return result;
+		}
+
+		size_t PanelGenericPlotter::action_count( ) const {
+			return m_actions.size( );
+		}
+
+		int PanelGenericPlotter::get_mapped_x( int x ) const {
+			return impl::get_mapped_x( x, m_coord_data );
+		}
+
+		int PanelGenericPlotter::get_mapped_y( int y ) const {
+			return impl::get_mapped_y( y, m_coord_data );
+		}
+
+		int PanelGenericPlotter::get_unmapped_x( int x ) const {
+			return impl::get_unmapped_x( x, m_coord_data );
+		}
+
+		int PanelGenericPlotter::get_unmapped_y( int y ) const {
+			return impl::get_unmapped_y( y, m_coord_data );
+		}
+
 		void draw_mmol_y_axis( PanelGenericPlotter & gen_plot, graph_config_t graph_config, float at_least_y_values ) {
 			// Y-Axis
 			auto const & min_point( graph_config.coord_data.item_bounds.point1 );
@@ -577,7 +678,7 @@ namespace daw {
 				} else {
 					gen_plot.set_font( graph_config.fnt_axis_title );
 				}
-				const ::std::string cur_label( daw::string::ptime_to_string( ts, "%H:%M" ) );
+				const ::std::string cur_label( label_format_time( ).to_string( ts ) );
 				auto const y_off = gen_plot.get_text_size( cur_label ).pos( ).y;
 				point_t const p_text( x, min_y, 0 - (y_off / 2), 6 + y_off / 2 );
 
@@ -585,7 +686,7 @@ namespace daw {
 			}
 		}
 
-		void draw_ts_x_axis( PanelGenericPlotter& gen_plot, const daw::data::DataTable::value_type& ts_col, size_t start, size_t finish, graph_config_t graph_config, float at_least_y_values ) {
+		void draw_ts_x_axis( PanelGenericPlotter& gen_plot, const daw::data::compact_table_t::value_type& ts_col, size_t start, size_t finish, graph_config_t graph_config, float at_least_y_values ) {
 			auto const& min_point( graph_config.coord_data.item_bounds.point1 );
 			point_t const max_point{ daw::math::value_or_min( graph_config.coord_data.item_bounds.point2.pos( ).x, 100 ), daw::math::value_or_min( graph_config.coord_data.item_bounds.point2.pos( ).y, static_cast<int>(at_least_y_values*10.0) ) };
 			auto const min_y( static_cast<int>(daw::math::floor_by( min_point.pos( ).y - 10, 10.0 )) );
@@ -613,7 +714,7 @@ namespace daw {
 					if( 0 == ts.time_of_day( ).hours( ) && 0 == ts.time_of_day( ).minutes( ) ) {
 						is_first = false;
 						gen_plot.set_font( graph_config.fnt_axis_title_bold );
-						cur_label = daw::string::ptime_to_string( ts, "%H:%M %b %d" );
+						cur_label = label_format_time_date( ).to_string( ts );
 					}
 					if( 0 == x % 60 ) {						
 						gen_plot.set_pen( graph_config.pen_axis_dotted );
@@ -624,9 +725,9 @@ namespace daw {
 						if( 0 == cur_label.size( ) ) {
 							if( is_first ) {
 								is_first = false;
-								cur_label = daw::string::ptime_to_string( ts, "%H:%M %b %d" );
+								cur_label = label_format_time_date( ).to_string( ts );
 							} else {
-								cur_label = daw::string::ptime_to_string( ts, "%H:%M" );
+								cur_label = label_format_time( ).to_string( ts );
 							}
 						}
 					} else if( 30 == x % 60 ) {
@@ -635,9 +736,9 @@ namespace daw {
 						gen_plot.set_font( graph_config.fnt_axis_title );
 						if( is_first ) {
 							is_first = false;
-							cur_label = daw::string::ptime_to_string( ts, "%H:%M %b %d" );
+							cur_label = label_format_time_date( ).to_string( ts );
 						} else {
-							cur_label = daw::string::ptime_to_string( ts, "%H:%M" );
+							cur_label = label_format_time( ).to_string( ts );
 						}
 					}
 
@@ -650,6 +751,41 @@ namespace daw {
 			}
 		}
 
+		void draw_time_range_x_axis( PanelGenericPlotter & gen_plot, int first_minute, int last_minute, int max_ticks, graph_config_t graph_config, float at_least_y_values ) {
+			auto const & min_point( graph_config.coord_data.item_bounds.point1 );
+			point_t const max_point{ daw::math::value_or_min( graph_config.coord_data.item_bounds.point2.pos( ).x, 100 ), daw::math::value_or_min( graph_config.coord_data.item_bounds.point2.pos( ).y, static_cast<int>(at_least_y_values*10.0) ) };
+			auto const min_y( static_cast<int>(daw::math::floor_by( min_point.pos( ).y - 10, 10.0 )) );
+			auto const max_y( static_cast<int>(daw::math::ceil_by( max_point.pos( ).y + 10, 10.0 )) );
+
+			gen_plot.set_pen( graph_config.pen_axis_x );
+			gen_plot.draw_line( point_t( first_minute, min_y ), point_t( last_minute, min_y ) );	// X-axis
+
+			static int const steps[] = { 15, 30, 60, 3*60, 6*60, 12*60, 24*60, 2*24*60, 7*24*60, 14*24*60, 30*24*60, 91*24*60, 365*24*60 };
+			auto const step = [&]( ) {
+				for( auto const cur_step : steps ) {
+					if( (last_minute - first_minute) / cur_step <= max_ticks ) {
+						return cur_step;
+					}
+				}
+				return *::std::rbegin( steps );
+			}();
+			auto const & label_format = step < 24*60 ? label_format_time_date( ) : label_format_date( );
+
+			gen_plot.set_font( graph_config.fnt_axis_title );
+			for( auto x = static_cast<int>(daw::math::ceil_by( first_minute, static_cast<double>(step) )); x <= last_minute; x += step ) {
+				gen_plot.set_pen( graph_config.pen_axis_dotted );
+				gen_plot.draw_line( point_t( x, min_y ), point_t( x, max_y ) );
+				gen_plot.set_pen( graph_config.pen_axis_x );
+				gen_plot.draw_line( point_t( x, min_y, 0, -2 ), point_t( x, min_y, 0, 2 ) );
+
+				auto const ts = s_epoch + boost::posix_time::minutes( x );
+				::std::string const cur_label( label_format.to_string( ts ) );
+				auto const y_off = gen_plot.get_text_size( cur_label ).pos( ).y;
+				point_t const p_text( x, min_y, 0 - (y_off / 2), 6 + y_off / 2 );
+				gen_plot.draw_rotated_text( wxString( cur_label ), p_text, 45.0 );
+			}
+		}
+
 		box_t::box_t( ):
 				point1{ 0, 0 },
 				point2{ 0, 0 } { }
@@ -20,8 +20,14 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/utility/string_ref.hpp>
 #include <functional>
+#include <limits>
+#include <string>
+#include <wx/choicdlg.h>
+#include <wx/grid.h>
+#include <wx/textdlg.h>
 
 #include <daw/daw_algorithm.h>
 #include <daw/daw_range_algorithm.h>
@@ -32,10 +38,13 @@
 #include "dialog_date_range_chooser.h"
 #include "frame_pump_data_analysis.h"
 #include "panel_average_basal.h"
+#include "panel_async_plot.h"
 #include "panel_average_basal_derivative.h"
-#include "panel_data_plot.h"
+#include "panel_basal_tests.h"
 #include "panel_pump_data_analysis.h"
+#include "panel_timeline.h"
 #include "string_helpers.h"
+#include "text_metrics.h"
 
 // ---------------------------------------------------------------------------
 // Pump Data Grid Child Window
@@ -43,7 +52,7 @@
 namespace {
 	#if 0
 	using namespace daw::data;
-	bool should_stop_basal_test( const DataTable& table, const size_t row ) {
+	bool should_stop_basal_test( const compact_table_t& table, const size_t row ) {
 		// Columns of impact
 		auto const& col_bolus = table["Bolus Volume Delivered (U)"];
 		auto const& col_carb = table["BWZ Carb Input (grams)"];
@@ -59,20 +68,21 @@ namespace {
 }
 
 enum {
-	CWDATAGRID_BASALTESTS = 300
+	CWDATAGRID_BASALTESTS = 300,
+	CWDATAGRID_FILTER_RANGE,
+	CWDATAGRID_FILTER_HAS_VALUE,
+	CWDATAGRID_CLEAR_VIEW,
+	CWDATAGRID_FIND,
+	CWDATAGRID_FIND_NEXT,
+	CWDATAGRID_SEARCH_TIMER,
+	CWDATAGRID_AUTOSIZE_TIMER,
+	CWDATAGRID_LOAD_TIMER
 };
 
 size_t PanelPumpDataAnalyis::ms_number_children = 0;
 
 using namespace daw::data;
 
-void PanelPumpDataAnalyis::add_basal_test_page( wxWindow * child, wxString const & title, bool const bring_to_front ) { 
-	if( nullptr == m_notebook_basal_tests ) {
-		GetBasalTestWindow( );
-	}
-	m_notebook_basal_tests->AddPage( child, title, bring_to_front );
-}
-
 void PanelPumpDataAnalyis::add_top_page( wxWindow * child, wxString const & title, bool const bring_to_front ) { 
 	if( nullptr == m_notebook_main ) {
 		GetTopPageWindow( );
@@ -80,112 +90,199 @@ void PanelPumpDataAnalyis::add_top_page( wxWindow * child, wxString const & titl
 	m_notebook_main->AddPage( child, title, bring_to_front );
 }
 
-void PanelPumpDataAnalyis::add_menu_bar( wxMenuBar* menu ) {
-	SetMenuBar( menu );
+daw::pumpdataanalysis::memory_report_t PanelPumpDataAnalyis::memory_report( ) const {
+	daw::pumpdataanalysis::memory_report_t result;
+	if( m_table_data.has_data( ) ) {
+		// Cells are only read once the loader is done writing them
+		auto const lock = m_table_data.data_analysis( ).read_lock( );
+		result = daw::pumpdataanalysis::make_memory_report( m_filename, m_table_data.data( ) );
+	} else {
+		result.filename = m_filename;
+	}
+	if( nullptr == m_notebook_main ) {
+		return result;
+	}
+	for( size_t n = 0; n < m_notebook_main->GetPageCount( ); ++n ) {
+		auto const page = m_notebook_main->GetPage( n );
+		size_t bytes = 0;
+		if( auto const tests = dynamic_cast<PanelBasalTests const *>(page) ) {
+			bytes = tests->cache_bytes( );
+		} else if( auto const plot = dynamic_cast<PanelAsyncPlot const *>(page) ) {
+			bytes = plot->display_list_bytes( );
+		} else if( auto const timeline = dynamic_cast<PanelTimeline const *>(page) ) {
+			bytes = timeline->display_list_bytes( );
+		} else {
+			continue;
+		}
+		result.display_lists.emplace_back( m_notebook_main->GetPageText( n ).ToStdString( ), bytes );
+	}
+	return result;
 }
 
-void PanelPumpDataAnalyis::update_status_callback( ::std::string status, wxApp * app ) {
-	assert( app );
-	app->GetTopWindow( )->GetEventHandler( )->CallAfter( [&]( ) {
-//		update_status( status );
-		wxLogStatus( wxString( status ) );
-	});
+void PanelPumpDataAnalyis::add_menu_bar( wxMenuBar* menu ) {
+	SetMenuBar( menu );
 }
 
 void PanelPumpDataAnalyis::update_status( ::std::string status ) const {
 	wxLogStatus( wxString( status ) );
 }
-namespace {
-	bool column_filter( std::string const & header ) {
-		using daw::algorithm::contains;
-		static std::vector<std::string> const disallowed_headers = { "Index", "Time", "Date", "Raw-ID", "Raw-Upload ID", "Raw-Seq Num", "Raw-Device Type" };
-		const bool is_disallowed = contains( disallowed_headers, header );
-		return !is_disallowed;
-	}
-
-}	// namespace anonymous
-
 PanelPumpDataAnalyis::PanelPumpDataAnalyis( wxMDIParentFrame * parent, wxApp * app, ::std::string filename ):
 		wxMDIChildFrame{ parent, wxID_ANY, wxString::Format( "Child %llu", ++ms_number_children ) },
 		m_notebook_main{ nullptr }, 
-		m_notebook_basal_tests{ nullptr },
 		m_grid{ nullptr },
 		m_app{ app }, 
 		m_table_data{ },
 		m_filename{ std::move( filename ) }, 
-		m_backgroundthread{ } {
+		m_backgroundthread{ },
+		m_search{ nullptr },
+		m_search_pos{ ::std::string::npos },
+		m_search_jump_pending{ false },
+		m_search_timer{ this, CWDATAGRID_SEARCH_TIMER },
+		m_column_widths{ },
+		m_autosize_cancel{ },
+		m_autosize_timer{ this, CWDATAGRID_AUTOSIZE_TIMER },
+		m_load_timer{ this, CWDATAGRID_LOAD_TIMER },
+		m_data_loaded{ false } {
 
 	update_status( "Loading CSV Data..." );
-	auto self = this;
-	daw::data::parse_csv_data_param params( m_filename, 11, column_filter, [self, app]( std::string status ) mutable {
-			assert( app );
-			self->update_status_callback( status, app );
-	} );
-
-	auto worker = [&, p=std::move( params ), app]( ) {
-		m_table_data = CSVTable( p );
-
-		auto handler = app->GetTopWindow( )->GetEventHandler( );
-
-		if( !m_table_data.is_valid( )) {
-			// Call Error Handler
-			handler->CallAfter( std::bind( &PanelPumpDataAnalyis::on_finished_loading_csv_data_error, this ) );
-			return;
-		}
-		handler->CallAfter(  std::bind( &PanelPumpDataAnalyis::on_finished_loading_csv_data, this ) );
-	};
-	worker( );
-	//m_backgroundthread = std::thread( worker );
-	//m_backgroundthread.detach( );
+	// Returns at once, the load is polled by on_load_timer and the frame is shown when the first rows are ready
+	m_table_data = CSVTable( m_filename );
+	m_load_timer.Start( 100 );
 
 	const wxString title = "Data: " + m_filename;
 	SetTitle( title );
 	Show( false );
 }
 
+void PanelPumpDataAnalyis::on_load_timer( wxTimerEvent& ) {
+	if( !m_table_data.is_valid( ) ) {
+		m_load_timer.Stop( );
+		on_finished_loading_csv_data_error( );
+		return;
+	}
+	if( !m_table_data.has_table( ) ) {
+		show_load_progress( );
+		return;
+	}
+	if( nullptr == m_grid ) {
+		on_table_available( );
+	}
+	m_table_data.sync_rows( );
+	if( !m_data_loaded && m_table_data.has_data( ) ) {
+		m_data_loaded = true;
+		on_finished_loading_csv_data( );
+	}
+	if( m_table_data.data_analysis( ).is_ready( ) ) {
+		m_load_timer.Stop( );
+		update_status( ::std::string( "Loaded " + m_filename ) );
+	} else {
+		show_load_progress( );
+	}
+}
+
+void PanelPumpDataAnalyis::show_load_progress( ) const {
+	using daw::pumpdataanalysis::format_count;
+	using daw::pumpdataanalysis::PumpDataAnalysis;
+	auto const progress = m_table_data.data_analysis( ).progress( ).snapshot( );
+	::std::string status = daw::pumpdataanalysis::load_stage_name( static_cast<PumpDataAnalysis::load_stage_t>(progress.stage) );
+	if( 0 != progress.rows_total ) {
+		status += ": " + format_count( static_cast<double>(progress.rows_done) ) + "of " + format_count( static_cast<double>(progress.rows_total) ) + "rows, " + format_count( progress.rows_per_second( ) ) + "rows/s";
+	} else if( 0 != progress.bytes_done ) {
+		status += ": " + format_count( static_cast<double>(progress.bytes_done) ) + "B, " + format_count( progress.bytes_per_second( ) ) + "B/s";
+	} else {
+		status += "...";
+	}
+	auto const eta = progress.eta_seconds( );
+	if( eta >= 0.0 ) {
+		status += ", " + ::std::to_string( static_cast<int>(eta + 0.5) ) + " s left";
+	}
+	update_status( status );
+}
+
 void PanelPumpDataAnalyis::on_finished_loading_csv_data_error( ) {
-	update_status( "Error opening file" );
+	update_status( "Error opening file: " + m_table_data.data_analysis( ).error( ) );
 	Close( true );
 }
 
-void PanelPumpDataAnalyis::on_finished_loading_csv_data( ) {	
+void PanelPumpDataAnalyis::on_table_available( ) {
 	m_grid = new wxGrid( GetTopPageWindow( ), -1, wxPoint( 0, 0 ), GetClientSize( ) );
 	add_top_page( m_grid, wxT( "Raw Data" ) );
 
+	// Called once parsing is done.  The grid starts with the rows converted so far and is grown by sync_rows as
+	// more are
 	m_grid->SetTable( &m_table_data );	
 	m_grid->EnableEditing( false );
-	//m_grid->AutoSizeColumns( false );
+	m_grid->Bind( wxEVT_GRID_LABEL_LEFT_CLICK, &PanelPumpDataAnalyis::on_grid_label_click, this );
 	//SetIcon( wxICON( chart ) );		//TODO: Get icons
 
 	// create our menu bar: it will be shown instead of the main frame one when
-	// we're active
+	// we're active.  Items that need the whole file are enabled by the update UI handlers once it is loaded
 	auto mbar = FramePumpDataAnalysis::create_menu_bar( );
 	mbar->GetMenu( 0 )->Insert( 1, wxID_CLOSE, "&Close child\tCtrl-W", "Close this window" );
 
 	auto menuChild = new wxMenu( );
 
 	menuChild->Append( CWDATAGRID_BASALTESTS, "Do Basal Tests" );
+	menuChild->AppendSeparator( );
+	menuChild->Append( CWDATAGRID_FILTER_RANGE, "Filter Rows by &Value Range...", "Only show rows where a column is within a range" );
+	menuChild->Append( CWDATAGRID_FILTER_HAS_VALUE, "Filter Rows with a Value &In...", "Only show rows where a column is not empty" );
+	menuChild->Append( CWDATAGRID_CLEAR_VIEW, "&Clear Sort and Filters", "Show every row in file order" );
+	menuChild->AppendSeparator( );
+	menuChild->Append( CWDATAGRID_FIND, "&Find...\tCtrl-F", "Search the text in every column" );
+	menuChild->Append( CWDATAGRID_FIND_NEXT, "Find &Next\tF3", "Go to the next match" );
 
 	mbar->Insert( 1, menuChild, "&Data Operations" );
 
 	// Associate the menu bar with the frame
 	SetMenuBar( mbar );
-	update_status( ::std::string( "Loaded " + m_filename ) );
 	Maximize( );
 	Show( );
 }
 
+void PanelPumpDataAnalyis::on_finished_loading_csv_data( ) {	
+	// AutoSizeColumns measures every cell, far too slow on a large file.  A sample of each column is measured in the
+	// background instead and the widths are applied when ready
+	auto const cell_font = m_grid->GetDefaultCellFont( );
+	auto const label_font = m_grid->GetLabelFont( );
+	auto metrics = ::std::make_shared<daw::pumpdataanalysis::text_metrics_t const>( ::std::vector<wxFont>{ cell_font, label_font } );
+	m_column_widths = m_table_data.start_autosize( ::std::move( metrics ), cell_font, label_font, m_autosize_cancel.token( ) );
+	m_autosize_timer.Start( 50 );
+
+	auto const cb = ::std::bind( &PanelPumpDataAnalyis::add_menu_bar, this, ::std::placeholders::_1 );
+	add_top_page( new PanelTimeline( GetTopPageWindow( ), cb, m_table_data.data( ) ), wxT( "Sensor Timeline" ) );
+}
+
+void PanelPumpDataAnalyis::on_update_needs_data( wxUpdateUIEvent& event ) {
+	event.Enable( m_table_data.has_data( ) );
+}
+
+void PanelPumpDataAnalyis::on_update_needs_basal_tests( wxUpdateUIEvent& event ) {
+	event.Enable( m_table_data.is_valid( ) && m_table_data.has_table( ) && m_table_data.data_analysis( ).is_ready( ) );
+}
+
 PanelPumpDataAnalyis::~PanelPumpDataAnalyis( ) {
+	m_load_timer.Stop( );
+	m_search_timer.Stop( );
+	m_search.reset( );
+	m_autosize_timer.Stop( );
+	// Waiting on an autosize that has not started would run all of it here
+	m_autosize_cancel.cancel( );
+	if( m_column_widths.valid( ) ) {
+		m_column_widths.wait( );
+	}
 	if( nullptr != m_grid ) {
 		m_grid->SetTable( nullptr );
 	}
+	// Plot pages may still be building from the table data on worker threads and wait for that when destroyed
+	DestroyChildren( );
+	m_grid = nullptr;
+	m_notebook_main = nullptr;
 	m_table_data.Clear( );
 	ms_number_children--;
 }
 
 void PanelPumpDataAnalyis::on_close( wxCommandEvent& ) {
-	m_grid->SetTable( nullptr );
-	m_table_data.Clear( );	
+	// The table data is released in the destructor, after the pages using it are gone
 	Close( true );
 }
 
@@ -210,12 +307,21 @@ void PanelPumpDataAnalyis::on_size( wxSizeEvent& event ) {
 }
 
 void PanelPumpDataAnalyis::on_close_window( wxCloseEvent& event ) {
+	// Stop the background work now rather than when the frame is finally destroyed
+	m_load_timer.Stop( );
+	m_search_timer.Stop( );
+	if( m_search ) {
+		m_search->cancel( );
+	}
+	m_autosize_timer.Stop( );
+	m_autosize_cancel.cancel( );
+	m_table_data.cancel( );
 	event.Skip( );
 }
 
 namespace {
 	#if 0
-	size_t skip_hrs( size_t row, const daw::data::DataTable::value_type& ts_col, const int32_t hours ) {
+	size_t skip_hrs( size_t row, const daw::data::compact_table_t::value_type& ts_col, const int32_t hours ) {
 		auto const time_start = ts_col[row++].timestamp( );
 		for( ; row < ts_col.size( ); ++row ) {
 			auto const time_now = ts_col[row].timestamp( );
@@ -238,7 +344,7 @@ namespace {
 		return end_exclusive;
 	}
 
-	size_t row_from_date( boost::posix_time::ptime dte, const DataTable::value_type& column_timestamp, size_t start_row = 0, size_t end_row = 0 ) {
+	size_t row_from_date( boost::posix_time::ptime dte, const compact_table_t::value_type& column_timestamp, size_t start_row = 0, size_t end_row = 0 ) {
 		if( 0 == end_row ) {
 			end_row = column_timestamp.size( );
 		}
@@ -253,7 +359,7 @@ namespace {
 	}
 
 	
-	std::pair<size_t, size_t> rows_from_date_range( ::std::pair<boost::posix_time::ptime, boost::posix_time::ptime> date_range, const DataTable::value_type& column_timestamp ) {		
+	std::pair<size_t, size_t> rows_from_date_range( ::std::pair<boost::posix_time::ptime, boost::posix_time::ptime> date_range, const compact_table_t::value_type& column_timestamp ) {		
 		size_t first = row_from_date( date_range.first, column_timestamp );
 		size_t last = row_from_date( date_range.second, column_timestamp, first + 1 );
 		if( column_timestamp.size( ) == last ) {
@@ -284,20 +390,19 @@ namespace {
 // }
 
 void PanelPumpDataAnalyis::on_do_basal_tests( wxCommandEvent& ) {
-	using daw::algorithm::rbegin2;
-	using ::std::begin;
-	daw::wx::DialogDateRangeChooser date_range_selector( this, wxID_ANY, "Look for Basal tests", begin( m_table_data.data( )["Timestamp"] )->timestamp( ), rbegin2( m_table_data.data( )["Timestamp"] )->timestamp( ) );
+	if( !m_table_data.data_analysis( ).is_ready( ) ) {
+		return;
+	}
+	// Cells are read by value when packed, the column's iterators have no operator->
+	auto const & ts_col = m_table_data.data( )["Timestamp"];
+	daw::wx::DialogDateRangeChooser date_range_selector( this, wxID_ANY, "Look for Basal tests", ts_col[0].timestamp( ), ts_col[ts_col.size( ) - 1].timestamp( ) );
 	if( wxOK == date_range_selector.ShowModal( ) ) {
 		auto const selected_date_range = date_range_selector.get_selected_range( );
 		auto const date_range = rows_from_date_range( selected_date_range, m_table_data.data( )["Timestamp"] );
 		auto const basal_tests = m_table_data.data_analysis( ).basal_tests_in_range( date_range_selector.get_selected_range( ) );
 		auto const cb = ::std::bind( &PanelPumpDataAnalyis::add_menu_bar, this, ::std::placeholders::_1 );
-		for( auto const& period : basal_tests ) {
-			auto plot = new PanelDataPlot( GetBasalTestWindow( ), cb, m_table_data.data( ), period.first, period.second, wxDefaultPosition, GetBasalTestWindow( )->GetClientSize( ) );
-			auto const& col_ts = m_table_data.data( )["Timestamp"];
-			std::string title = daw::string::ptime_to_string( col_ts[period.first].timestamp( ), "%Y-%m-%d %H:%M" ) + " -> " + daw::string::ptime_to_string( col_ts[period.second].timestamp( ), "%Y-%m-%d %H:%M" );
-			add_basal_test_page( plot, title );
-		}
+		auto tests = new PanelBasalTests( GetTopPageWindow( ), cb, m_table_data.data( ), basal_tests );
+		add_top_page( tests, wxT( "Basal Tests" ) );
 		auto avgBasal = new PanelAverageBasal( GetTopPageWindow( ), cb, m_table_data.data( ), basal_tests );
 		add_top_page( avgBasal, wxT( "Aggregate Basal Day" ) );
 		auto avgDay = new PanelAverageBasal( GetTopPageWindow( ), cb, m_table_data.data( ), { { date_range.first, date_range.second } } );
@@ -309,14 +414,10 @@ void PanelPumpDataAnalyis::on_do_basal_tests( wxCommandEvent& ) {
 	}
 }
 
- void PanelPumpDataAnalyis::on_finished_do_basal_tests( const ::std::vector<std::pair<daw::data::DataTable::size_type, daw::data::DataTable::size_type>> positions, const ::std::pair<size_t, size_t> date_range ) {
+ void PanelPumpDataAnalyis::on_finished_do_basal_tests( const ::std::vector<std::pair<daw::data::compact_table_t::size_type, daw::data::compact_table_t::size_type>> positions, const ::std::pair<size_t, size_t> date_range ) {
 	auto const cb = ::std::bind( &PanelPumpDataAnalyis::add_menu_bar, this, ::std::placeholders::_1 );
-	for( auto const& period : positions ) {
-		auto plot = new PanelDataPlot( GetBasalTestWindow( ), cb, m_table_data.data( ), period.first, period.second, wxDefaultPosition, GetBasalTestWindow( )->GetClientSize( ) );
-		auto const& col_ts = m_table_data.data( )["Timestamp"];
-		std::string title = daw::string::ptime_to_string( col_ts[period.first].timestamp( ), "%Y-%m-%d %H:%M" ) + " -> " + daw::string::ptime_to_string( col_ts[period.second].timestamp( ), "%Y-%m-%d %H:%M" );
-		add_basal_test_page( plot, title );
-	}
+	auto tests = new PanelBasalTests( GetTopPageWindow( ), cb, m_table_data.data( ), positions );
+	add_top_page( tests, wxT( "Basal Tests" ) );
 	auto avgBasal = new PanelAverageBasal( GetTopPageWindow( ), cb, m_table_data.data( ), positions );
 	add_top_page( avgBasal, wxT( "Aggregate Basal Day" ) );
 	auto avgDay = new PanelAverageBasal( GetTopPageWindow( ), cb, m_table_data.data( ), { { date_range.first, date_range.second } } );
@@ -325,10 +426,205 @@ void PanelPumpDataAnalyis::on_do_basal_tests( wxCommandEvent& ) {
 	add_top_page( avgBasalDeriv, wxT( "Average Basal Change" ), true );
 }
 
+namespace {
+	/// Ask for one of the columns of table, -1 when cancelled
+	int choose_column( wxWindow * parent, compact_table_t const & table, wxString const & message ) {
+		wxArrayString headers;
+		for( size_t n = 0; n < table.size( ); ++n ) {
+			headers.push_back( table[n].header( ) );
+		}
+		return wxGetSingleChoiceIndex( message, "Choose Column", headers, parent );
+	}
+
+	/// A filter bound from the user.  Blank is unbounded, anything else is a number or a YYYY-MM-DD HH:MM:SS timestamp
+	bool parse_bound( wxString const & text, double unbounded, double & out ) {
+		auto const str = text.ToStdString( );
+		if( str.find_first_not_of( " \t" ) == ::std::string::npos ) {
+			out = unbounded;
+			return true;
+		}
+		try {
+			size_t used = 0;
+			out = ::std::stod( str, &used );
+			if( str.find_first_not_of( " \t", used ) == ::std::string::npos ) {
+				return true;
+			}
+		} catch( ::std::exception const & ) { }
+		try {
+			auto const ts = boost::posix_time::time_from_string( str );
+			out = static_cast<double>((ts - boost::posix_time::ptime( boost::gregorian::date( 1970, 1, 1 ) )).total_seconds( ));
+			return true;
+		} catch( ::std::exception const & ) { }
+		return false;
+	}
+}	// namespace anonymous
+
+void PanelPumpDataAnalyis::on_grid_label_click( wxGridEvent& event ) {
+	if( event.GetRow( ) >= 0 || event.GetCol( ) < 0 || !m_table_data.has_data( ) ) {
+		event.Skip( );
+		return;
+	}
+	// First click sorts ascending, clicking the sorted column again flips the order
+	auto spec = m_table_data.view_spec( );
+	auto const col = static_cast<size_t>(event.GetCol( ));
+	spec.ascending = col != spec.sort_col || !spec.ascending;
+	spec.sort_col = col;
+	m_table_data.set_view_spec( ::std::move( spec ) );
+}
+
+void PanelPumpDataAnalyis::on_filter_range( wxCommandEvent& ) {
+	if( !m_table_data.has_data( ) ) {
+		return;
+	}
+	auto const col = choose_column( this, m_table_data.data( ), "Only show rows where this column is within a range" );
+	if( col < 0 ) {
+		return;
+	}
+	auto const inf = ::std::numeric_limits<double>::infinity( );
+	daw::data::row_filter_t filter{ static_cast<size_t>(col), daw::data::row_filter_t::kind_t::in_range, -inf, inf };
+	wxString const hint = "\nA number or YYYY-MM-DD HH:MM:SS, blank for no limit";
+	if( !parse_bound( wxGetTextFromUser( "Lowest value shown" + hint, "Filter Rows", "", this ), -inf, filter.low ) || !parse_bound( wxGetTextFromUser( "Highest value shown" + hint, "Filter Rows", "", this ), inf, filter.high ) ) {
+		wxMessageBox( "Could not read the range", "Filter Rows", wxOK | wxICON_ERROR, this );
+		return;
+	}
+	auto spec = m_table_data.view_spec( );
+	spec.filters.push_back( filter );
+	m_table_data.set_view_spec( ::std::move( spec ) );
+	update_status( ::std::to_string( m_table_data.GetNumberRows( ) ) + " rows match" );
+}
+
+void PanelPumpDataAnalyis::on_filter_has_value( wxCommandEvent& ) {
+	if( !m_table_data.has_data( ) ) {
+		return;
+	}
+	auto const col = choose_column( this, m_table_data.data( ), "Only show rows with a value in this column" );
+	if( col < 0 ) {
+		return;
+	}
+	auto spec = m_table_data.view_spec( );
+	spec.filters.push_back( daw::data::row_filter_t{ static_cast<size_t>(col), daw::data::row_filter_t::kind_t::has_value, 0.0, 0.0 } );
+	m_table_data.set_view_spec( ::std::move( spec ) );
+	update_status( ::std::to_string( m_table_data.GetNumberRows( ) ) + " rows match" );
+}
+
+void PanelPumpDataAnalyis::on_clear_view( wxCommandEvent& ) {
+	m_table_data.set_view_spec( daw::data::row_view_spec_t( ) );
+}
+
+void PanelPumpDataAnalyis::on_find( wxCommandEvent& ) {
+	if( nullptr == m_grid || !m_table_data.has_data( ) ) {
+		return;
+	}
+	auto const needle = wxGetTextFromUser( "Find text", "Find", m_search ? wxString( m_search->needle( ) ) : wxString( ), this ).ToStdString( );
+	if( needle.empty( ) ) {
+		return;
+	}
+	m_search = m_table_data.start_search( needle );
+	m_search_pos = ::std::string::npos;
+	m_search_jump_pending = true;
+	update_status( "Searching for '" + needle + "'..." );
+	m_search_timer.Start( 100 );
+}
+
+void PanelPumpDataAnalyis::on_find_next( wxCommandEvent& event ) {
+	if( !m_search ) {
+		on_find( event );
+		return;
+	}
+	show_next_match( );
+}
+
+void PanelPumpDataAnalyis::show_next_match( ) {
+	m_search_jump_pending = false;
+	auto const done = m_search->is_done( );	// Read before the count so no match found in between is missed
+	auto const count = m_search->match_count( );
+	bool wrapped = false;
+	auto pos = ::std::string::npos == m_search_pos ? 0 : m_search_pos + 1;
+	for( ;; ++pos ) {
+		if( pos >= count ) {
+			if( !done ) {
+				m_search_jump_pending = true;
+				return;
+			}
+			if( wrapped || 0 == count ) {
+				update_status( "No matches for '" + m_search->needle( ) + "' in the rows shown" );
+				return;
+			}
+			wrapped = true;
+			pos = 0;
+		}
+		auto const match = m_search->match( pos );
+		auto const row = m_table_data.grid_row( match.row );
+		if( row >= 0 ) {
+			m_search_pos = pos;
+			auto const col = static_cast<int>(match.col);
+			m_grid->GoToCell( row, col );
+			m_grid->SelectBlock( row, col, row, col );
+			if( wrapped ) {
+				update_status( "Search wrapped to the first match" );
+			}
+			return;
+		}
+	}
+}
+
+void PanelPumpDataAnalyis::on_search_timer( wxTimerEvent& ) {
+	if( !m_search ) {
+		m_search_timer.Stop( );
+		return;
+	}
+	if( m_search_jump_pending ) {
+		show_next_match( );
+	}
+	auto const status = ::std::to_string( m_search->match_count( ) ) + " matches for '" + m_search->needle( ) + "'";
+	if( m_search->is_done( ) && !m_search_jump_pending ) {
+		m_search_timer.Stop( );
+		update_status( status );
+	} else {
+		update_status( status + " so far..." );
+	}
+}
+
+void PanelPumpDataAnalyis::on_autosize_timer( wxTimerEvent& ) {
+	if( !m_column_widths.is_ready( ) ) {
+		return;
+	}
+	m_autosize_timer.Stop( );
+	::std::vector<int> widths;
+	try {
+		widths = m_column_widths.get( );
+	} catch( ::std::exception const & ex ) {
+		update_status( ::std::string( "Could not size columns: " ) + ex.what( ) );
+		return;
+	}
+	if( nullptr == m_grid ) {
+		return;
+	}
+	m_grid->BeginBatch( );
+	for( size_t col = 0; col < widths.size( ); ++col ) {
+		m_grid->SetColSize( static_cast<int>(col), widths[col] );
+	}
+	m_grid->EndBatch( );
+}
+
 BEGIN_EVENT_TABLE( PanelPumpDataAnalyis, wxMDIChildFrame )
 	EVT_MENU( wxID_CLOSE, PanelPumpDataAnalyis::on_close )
 	EVT_MENU( MDI_REFRESH, PanelPumpDataAnalyis::on_refresh )
 	EVT_MENU( CWDATAGRID_BASALTESTS, PanelPumpDataAnalyis::on_do_basal_tests )
+	EVT_MENU( CWDATAGRID_FILTER_RANGE, PanelPumpDataAnalyis::on_filter_range )
+	EVT_MENU( CWDATAGRID_FILTER_HAS_VALUE, PanelPumpDataAnalyis::on_filter_has_value )
+	EVT_MENU( CWDATAGRID_CLEAR_VIEW, PanelPumpDataAnalyis::on_clear_view )
+	EVT_MENU( CWDATAGRID_FIND, PanelPumpDataAnalyis::on_find )
+	EVT_MENU( CWDATAGRID_FIND_NEXT, PanelPumpDataAnalyis::on_find_next )
+	EVT_TIMER( CWDATAGRID_SEARCH_TIMER, PanelPumpDataAnalyis::on_search_timer )
+	EVT_TIMER( CWDATAGRID_AUTOSIZE_TIMER, PanelPumpDataAnalyis::on_autosize_timer )
+	EVT_TIMER( CWDATAGRID_LOAD_TIMER, PanelPumpDataAnalyis::on_load_timer )
+	EVT_UPDATE_UI( CWDATAGRID_BASALTESTS, PanelPumpDataAnalyis::on_update_needs_basal_tests )
+	EVT_UPDATE_UI( CWDATAGRID_FILTER_RANGE, PanelPumpDataAnalyis::on_update_needs_data )
+	EVT_UPDATE_UI( CWDATAGRID_FILTER_HAS_VALUE, PanelPumpDataAnalyis::on_update_needs_data )
+	EVT_UPDATE_UI( CWDATAGRID_CLEAR_VIEW, PanelPumpDataAnalyis::on_update_needs_data )
+	EVT_UPDATE_UI( CWDATAGRID_FIND, PanelPumpDataAnalyis::on_update_needs_data )
+	EVT_UPDATE_UI( CWDATAGRID_FIND_NEXT, PanelPumpDataAnalyis::on_update_needs_data )
 	EVT_SIZE( PanelPumpDataAnalyis::on_size )
 	EVT_MOVE( PanelPumpDataAnalyis::on_move )
 	EVT_CLOSE( PanelPumpDataAnalyis::on_close_window )
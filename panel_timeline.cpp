@@ -0,0 +1,309 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <vector>
+#include <wx/dcbuffer.h>
+
+#include "async_plot.h"
+#include "frame_pump_data_analysis.h"
+#include "panel_timeline.h"
+#include "point_array.h"
+
+using daw::pumpdataanalysis::point_t;
+using daw::pumpdataanalysis::point_array_t;
+
+namespace {
+	auto get_epoch( ) {
+		static auto const s_epoch = boost::posix_time::time_from_string( "1970-01-01 00:00:00.000" );
+		return s_epoch;
+	}
+
+	int const s_min_view_span = 60;	// Don't zoom in past an hour
+	int const s_poll_ms = 50;
+	int const s_timer_id = wxID_HIGHEST + 1;
+	size_t const s_rows_per_cancel_check = 65536;
+
+	daw::pumpdataanalysis::lod_pyramid_t build_pyramid( daw::data::compact_table_t const & data, daw::cancellation_token_t const & cancelled ) {
+		auto const& bg_col = data["Sensor Glucose (mmol/L)"];
+		auto const& ts_col = data["Timestamp"];
+
+		::std::vector<int> xs;
+		::std::vector<float> ys;
+		for( size_t row = 0; row < bg_col.size( ); ++row ) {
+			if( 0 == row % s_rows_per_cancel_check ) {
+				cancelled.throw_if_cancelled( );
+			}
+			if( bg_col[row] && ts_col[row] ) {
+				xs.push_back( static_cast<int>((ts_col[row].timestamp( ) - get_epoch( )).total_seconds( ) / 60) );
+				ys.push_back( static_cast<float>(bg_col[row].real( )) );
+			}
+		}
+		if( !::std::is_sorted( xs.begin( ), xs.end( ) ) ) {	// Exports are not guaranteed to be in time order
+			::std::vector<size_t> order( xs.size( ) );
+			::std::iota( order.begin( ), order.end( ), 0 );
+			::std::stable_sort( order.begin( ), order.end( ), [&xs]( size_t a, size_t b ) {
+				return xs[a] < xs[b];
+			} );
+			::std::vector<int> sorted_xs;
+			::std::vector<float> sorted_ys;
+			sorted_xs.reserve( xs.size( ) );
+			sorted_ys.reserve( ys.size( ) );
+			for( auto const pos : order ) {
+				sorted_xs.push_back( xs[pos] );
+				sorted_ys.push_back( ys[pos] );
+			}
+			xs = ::std::move( sorted_xs );
+			ys = ::std::move( sorted_ys );
+		}
+		return daw::pumpdataanalysis::lod_pyramid_t{ xs, ys };
+	}
+}	// namespace anonymous
+
+PanelTimeline::PanelTimeline( wxWindow *parent, ::std::function<void( wxMenuBar* menu )> addmenu_cb, const daw::data::compact_table_t& dt ): 
+		wxPanel( parent, wxID_ANY ), 
+		m_pyramid( ),
+		m_cancel( ),
+		m_pending( ),
+		m_status( "Building timeline..." ),
+		m_timer( this, s_timer_id ),
+		m_view_first( 0 ),
+		m_view_last( 0 ),
+		m_built_width( 0 ),
+		m_dirty( true ),
+		m_dragging( false ),
+		m_drag_start_x( 0 ),
+		m_drag_view_first( 0 ),
+		m_addmenu_cb( addmenu_cb ), 
+		m_gen_plot( ) {
+
+	SetBackgroundStyle( wxBG_STYLE_PAINT );
+	// Multi-year files take a while to bucket, the window stays usable meanwhile
+	m_pending = daw::task_pool_t::get( ).submit( daw::task_priority_t::background, [&dt, cancelled = m_cancel.token( )]( ) {
+		return build_pyramid( dt, cancelled );
+	} );
+	m_timer.Start( s_poll_ms );
+
+	// create our menu bar: it will be shown instead of the main frame one when
+	// we're active
+	auto mbar = FramePumpDataAnalysis::create_menu_bar( );
+	mbar->GetMenu( 0 )->Insert( 1, wxID_CLOSE, "&Close child\tCtrl-W", "Close this window" );
+
+	// Associate the menu bar with the frame
+	addmenu_cb( mbar );
+}
+
+PanelTimeline::~PanelTimeline( ) {
+	m_timer.Stop( );
+	if( m_pending.valid( ) ) {
+		m_cancel.cancel( );
+		m_pending.wait( );
+	}
+}
+
+void PanelTimeline::on_timer( wxTimerEvent& ) {
+	if( !m_pending.is_ready( ) ) {
+		return;
+	}
+	m_timer.Stop( );
+	try {
+		m_pyramid = m_pending.get( );
+		m_status.clear( );
+	} catch( ::std::exception const & ex ) {
+		m_status = wxString( "Could not build timeline: " ) + ex.what( );
+	}
+	if( !m_pyramid.empty( ) ) {
+		m_view_first = m_pyramid.x_min( );
+		m_view_last = ::std::max( m_pyramid.x_max( ), m_view_first + s_min_view_span );
+	}
+	m_dirty = true;
+	Refresh( false );
+}
+
+size_t PanelTimeline::display_list_bytes( ) const {
+	return m_gen_plot.footprint( ) + m_pyramid.footprint( );
+}
+
+void PanelTimeline::build_view( int width ) {
+	using namespace daw::pumpdataanalysis;
+	m_gen_plot.clear( );
+	m_gen_plot.coord_data( ) = translation_t{ };
+	m_gen_plot.coord_data( ).margins.set_all( 15 );
+	m_built_width = width;
+	m_dirty = false;
+	if( m_pyramid.empty( ) ) {
+		return;
+	}
+	graph_config_t graph_config;
+	graph_config.axis_title_y = "mmol/L";
+
+	// About one bucket per pixel, whatever the zoom level
+	auto const plot_width = static_cast<size_t>(::std::max( width - static_cast<int>(m_gen_plot.coord_data( ).margins.width( )), 2 ));
+	auto const level_no = m_pyramid.level_for( m_view_first, m_view_last, plot_width );
+	auto const & lvl = m_pyramid.level( level_no );
+	auto rng = m_pyramid.range( level_no, m_view_first, m_view_last );
+	// Take a bucket either side so the lines run to the edge instead of stopping short
+	if( rng.first > 0 ) {
+		--rng.first;
+	}
+	if( rng.second < lvl.size( ) ) {
+		++rng.second;
+	}
+
+	point_array_t means;
+	point_array_t band;
+	means.reserve( rng.second - rng.first );
+	band.reserve( 2 * (rng.second - rng.first) );
+	for( auto n = rng.first; n < rng.second; ++n ) {
+		means.push_back( point_t{ lvl[n].x_mid( ), static_cast<int>(lvl[n].mean( )*10.0) } );
+		band.push_back( point_t{ lvl[n].x_mid( ), static_cast<int>(lvl[n].high*10.0) } );
+	}
+	for( auto n = rng.second; n > rng.first; --n ) {
+		band.push_back( point_t{ lvl[n - 1].x_mid( ), static_cast<int>(lvl[n - 1].low*10.0) } );
+	}
+	if( level_no > 0 && band.size( ) >= 3 ) {	// At level 0 high and low are the reading itself
+		m_gen_plot.set_pen( graph_config.pen_area_std_dev );
+		m_gen_plot.set_brush( graph_config.brush_area_std_dev );
+		m_gen_plot.draw_polygon( ::std::move( band ) );
+	}
+	if( means.size( ) >= 2 ) {
+		m_gen_plot.set_pen( graph_config.pen_line_average );
+		m_gen_plot.draw_lines( ::std::move( means ) );
+	}
+
+	// The view, not the buckets drawn, decides the x extents.  y is fixed to the whole file so panning doesn't rescale it
+	auto const y_minmax = m_pyramid.y_minmax( );
+	m_gen_plot.coord_data( ).item_bounds = box_t{ point_t{ m_view_first, static_cast<int>(y_minmax.first*10.0) }, point_t{ m_view_last, static_cast<int>(y_minmax.second*10.0) } };
+
+	graph_config.coord_data = m_gen_plot.coord_data( );
+	draw_mmol_y_axis( m_gen_plot, graph_config );
+	draw_time_range_x_axis( m_gen_plot, m_view_first, m_view_last, ::std::max( width / 80, 1 ), graph_config );
+	m_gen_plot.set_pen( wxNullPen );
+}
+
+void PanelTimeline::set_view( int first, int last ) {
+	if( m_pyramid.empty( ) ) {
+		return;
+	}
+	auto const full_span = ::std::max( m_pyramid.x_max( ) - m_pyramid.x_min( ), s_min_view_span );
+	auto const span = ::std::min( ::std::max( last - first, s_min_view_span ), full_span );
+	first = ::std::max( first, m_pyramid.x_min( ) );
+	first = ::std::min( first, m_pyramid.x_min( ) + full_span - span );
+	if( first != m_view_first || first + span != m_view_last ) {
+		m_view_first = first;
+		m_view_last = first + span;
+		m_dirty = true;
+		Refresh( false );
+	}
+}
+
+void PanelTimeline::on_paint( wxPaintEvent& ) {
+	wxAutoBufferedPaintDC dc( this );
+	dc.SetBackground( *wxWHITE_BRUSH );
+	dc.Clear( );
+	wxSize area( GetClientSize( ) );
+	if( area.GetWidth( ) <= 0 || area.GetHeight( ) <= 0 ) {
+		return;
+	}
+	if( !m_status.empty( ) ) {
+		daw::pumpdataanalysis::draw_plot_placeholder( dc, ::std::move( area ), m_status );
+		return;
+	}
+	if( m_pyramid.empty( ) ) {
+		dc.DrawText( wxT( "No sensor readings to display" ), 15, 15 );
+		return;
+	}
+	if( m_dirty || area.GetWidth( ) != m_built_width ) {
+		build_view( area.GetWidth( ) );
+	}
+	m_gen_plot.plot( dc, ::std::move( area ) );
+}
+
+void PanelTimeline::on_size( wxSizeEvent& event ) {
+	m_dirty = true;
+	Refresh( false );
+	event.Skip( );
+}
+
+void PanelTimeline::on_mouse_wheel( wxMouseEvent& event ) {
+	auto const notches = event.GetWheelRotation( ) / ::std::max( event.GetWheelDelta( ), 1 );
+	if( m_pyramid.empty( ) || 0 == notches ) {
+		return;
+	}
+	auto const span = m_view_last - m_view_first;
+	// Keep the time under the cursor where it is
+	auto const anchor = [&]( ) {
+		if( m_gen_plot.coord_data( ).scale.x <= 0.0f ) {
+			return m_view_first + span / 2;
+		}
+		return ::std::min( ::std::max( m_gen_plot.get_unmapped_x( event.GetX( ) ), m_view_first ), m_view_last );
+	}();
+	auto const new_span = static_cast<int>(static_cast<double>(span) * ::std::pow( 0.8, notches ));
+	auto const anchor_ratio = static_cast<double>(anchor - m_view_first) / static_cast<double>(span);
+	auto const new_first = anchor - static_cast<int>(anchor_ratio * static_cast<double>(new_span));
+	set_view( new_first, new_first + new_span );
+}
+
+void PanelTimeline::on_left_down( wxMouseEvent& event ) {
+	m_dragging = true;
+	m_drag_start_x = event.GetX( );
+	m_drag_view_first = m_view_first;
+	CaptureMouse( );
+}
+
+void PanelTimeline::on_left_up( wxMouseEvent& ) {
+	if( m_dragging ) {
+		m_dragging = false;
+		if( HasCapture( ) ) {
+			ReleaseMouse( );
+		}
+	}
+}
+
+void PanelTimeline::on_motion( wxMouseEvent& event ) {
+	auto const scale_x = m_gen_plot.coord_data( ).scale.x;
+	if( !m_dragging || scale_x <= 0.0f ) {
+		return;
+	}
+	auto const minutes = static_cast<int>(static_cast<float>(event.GetX( ) - m_drag_start_x) / scale_x);
+	auto const span = m_view_last - m_view_first;
+	set_view( m_drag_view_first - minutes, m_drag_view_first - minutes + span );
+}
+
+void PanelTimeline::on_capture_lost( wxMouseCaptureLostEvent& ) {
+	m_dragging = false;
+}
+
+BEGIN_EVENT_TABLE( PanelTimeline, wxPanel )
+EVT_PAINT( PanelTimeline::on_paint )
+EVT_TIMER( s_timer_id, PanelTimeline::on_timer )
+EVT_SIZE( PanelTimeline::on_size )
+EVT_MOUSEWHEEL( PanelTimeline::on_mouse_wheel )
+EVT_LEFT_DOWN( PanelTimeline::on_left_down )
+EVT_LEFT_UP( PanelTimeline::on_left_up )
+EVT_MOTION( PanelTimeline::on_motion )
+EVT_MOUSE_CAPTURE_LOST( PanelTimeline::on_capture_lost )
+END_EVENT_TABLE( )
@@ -0,0 +1,56 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+
+#include "parallel.h"
+
+#if USE_PPL
+#include <omp.h>
+#endif
+
+namespace daw {
+	size_t parallel_thread_count( ) {
+#if USE_PPL
+		return static_cast<size_t>(::std::max( omp_get_max_threads( ), 1 ));
+#else
+		return task_pool_t::get( ).thread_count( );
+#endif
+	}
+
+#if USE_PPL
+	namespace impl {
+		int omp_team_size( ) {
+			if( omp_in_parallel( ) || task_pool_t::get( ).is_worker_thread( ) ) {
+				return 1;
+			}
+			return ::std::max( omp_get_max_threads( ), 1 );
+		}
+	}	// namespace impl
+#endif
+
+	size_t parallel_range_count( size_t size, size_t min_per_range ) {
+		return ::std::max<size_t>( ::std::min( parallel_thread_count( ), size / ::std::max<size_t>( min_per_range, 1 ) ), 1 );
+	}
+}	// namespace daw
+
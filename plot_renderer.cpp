@@ -0,0 +1,67 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <stdexcept>
+#include <string>
+#include <wx/dcmemory.h>
+#include <wx/dcsvg.h>
+#include <wx/image.h>
+
+#include "plot_renderer.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		namespace {
+			void draw_page( wxDC & dc, PanelGenericPlotter & gen_plot, wxSize size ) {
+				dc.SetBackground( *wxWHITE_BRUSH );
+				dc.Clear( );
+				gen_plot.plot( dc, ::std::move( size ) );
+			}
+		}	// namespace anonymous
+
+		wxImage render_to_image( PanelGenericPlotter & gen_plot, wxSize size ) {
+			wxBitmap bmp( size.GetWidth( ), size.GetHeight( ), 24 );
+			{
+				wxMemoryDC dc( bmp );
+				draw_page( dc, gen_plot, size );
+			}
+			return bmp.ConvertToImage( );
+		}
+
+		void render_to_png( PanelGenericPlotter & gen_plot, wxSize size, wxString const & filename ) {
+			auto const img = render_to_image( gen_plot, ::std::move( size ) );
+			if( !img.SaveFile( filename, wxBITMAP_TYPE_PNG ) ) {
+				throw ::std::runtime_error( ": Could not write " + filename.ToStdString( ) );
+			}
+		}
+
+		void render_to_svg( PanelGenericPlotter & gen_plot, wxSize size, wxString const & filename ) {
+			wxSVGFileDC dc( filename, size.GetWidth( ), size.GetHeight( ) );
+			if( !dc.IsOk( ) ) {
+				throw ::std::runtime_error( ": Could not write " + filename.ToStdString( ) );
+			}
+			draw_page( dc, gen_plot, ::std::move( size ) );
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
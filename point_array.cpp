@@ -0,0 +1,195 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+
+#include "panel_generic_plot.h"
+#include "point_array.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define DAW_POINT_ARRAY_SSE2 1
+#include <emmintrin.h>
+#else
+#define DAW_POINT_ARRAY_SSE2 0
+#endif
+
+namespace daw {
+	namespace pumpdataanalysis {
+		static_assert( sizeof( wxPoint ) == 2 * sizeof( int ), "wxPoint is expected to be two packed ints" );
+
+		namespace {
+			/// The affine part of translation_t, pulled out once per run instead of once per point
+			struct affine_t {
+				int min_x;
+				int min_y;
+				float scale_x;
+				float scale_y;
+				float margin_left;
+				float margin_bottom;
+				int height;
+
+				affine_t( translation_t const & coord_data ):
+						min_x{ coord_data.item_bounds.point1.pos( ).x },
+						min_y{ coord_data.item_bounds.point1.pos( ).y },
+						scale_x{ coord_data.scale.x },
+						scale_y{ coord_data.scale.y },
+						margin_left{ static_cast<float>(coord_data.margins.left) },
+						margin_bottom{ static_cast<float>(coord_data.margins.bottom) },
+						height{ coord_data.panel_bounds.GetHeight( ) } { }
+			};
+
+			// Must produce exactly what point_t::mapped_point does
+			void map_scalar( affine_t const & af, int const * xs, int const * ys, int const * off_xs, int const * off_ys, uint8_t const * flags, int * out, size_t first, size_t last ) {
+				for( auto n = first; n < last; ++n ) {
+					auto x = xs[n];
+					auto y = ys[n];
+					if( 0 == (flags[n] & point_array_t::flag_unmapped_x) ) {
+						x = static_cast<int>(static_cast<float>(x - af.min_x)*af.scale_x + af.margin_left);
+					}
+					if( 0 == (flags[n] & point_array_t::flag_unmapped_y) ) {
+						y = af.height - static_cast<int>(static_cast<float>(y - af.min_y)*af.scale_y + af.margin_bottom);
+					}
+					out[2 * n] = x + off_xs[n];
+					out[2 * n + 1] = y - off_ys[n];	// Panel y-axis is inverted
+				}
+			}
+
+#if DAW_POINT_ARRAY_SSE2
+			size_t map_sse2( affine_t const & af, int const * xs, int const * ys, int const * off_xs, int const * off_ys, uint8_t const * flags, int * out, size_t count ) {
+				auto const min_x = _mm_set1_epi32( af.min_x );
+				auto const min_y = _mm_set1_epi32( af.min_y );
+				auto const scale_x = _mm_set1_ps( af.scale_x );
+				auto const scale_y = _mm_set1_ps( af.scale_y );
+				auto const margin_left = _mm_set1_ps( af.margin_left );
+				auto const margin_bottom = _mm_set1_ps( af.margin_bottom );
+				auto const height = _mm_set1_epi32( af.height );
+				auto const bit_x = _mm_set1_epi32( point_array_t::flag_unmapped_x );
+				auto const bit_y = _mm_set1_epi32( point_array_t::flag_unmapped_y );
+				auto const zero = _mm_setzero_si128( );
+
+				size_t n = 0;
+				for( ; n + 4 <= count; n += 4 ) {
+					auto const x = _mm_loadu_si128( reinterpret_cast<__m128i const *>(xs + n) );
+					auto const y = _mm_loadu_si128( reinterpret_cast<__m128i const *>(ys + n) );
+					auto const off_x = _mm_loadu_si128( reinterpret_cast<__m128i const *>(off_xs + n) );
+					auto const off_y = _mm_loadu_si128( reinterpret_cast<__m128i const *>(off_ys + n) );
+
+					int32_t flag_bytes;
+					memcpy( &flag_bytes, flags + n, sizeof( flag_bytes ) );
+					auto f = _mm_cvtsi32_si128( flag_bytes );
+					f = _mm_unpacklo_epi16( _mm_unpacklo_epi8( f, zero ), zero );
+					auto const keep_x = _mm_cmpeq_epi32( _mm_and_si128( f, bit_x ), bit_x );	// all ones where x is unmapped
+					auto const keep_y = _mm_cmpeq_epi32( _mm_and_si128( f, bit_y ), bit_y );
+
+					auto const fx = _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( x, min_x ) ), scale_x ), margin_left );
+					auto const mx = _mm_cvttps_epi32( fx );
+					auto const fy = _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( y, min_y ) ), scale_y ), margin_bottom );
+					auto const my = _mm_sub_epi32( height, _mm_cvttps_epi32( fy ) );
+
+					auto rx = _mm_or_si128( _mm_and_si128( keep_x, x ), _mm_andnot_si128( keep_x, mx ) );
+					auto ry = _mm_or_si128( _mm_and_si128( keep_y, y ), _mm_andnot_si128( keep_y, my ) );
+					rx = _mm_add_epi32( rx, off_x );
+					ry = _mm_sub_epi32( ry, off_y );
+
+					// Interleave into x0 y0 x1 y1 ... to match the wxPoint layout
+					_mm_storeu_si128( reinterpret_cast<__m128i *>(out + 2 * n), _mm_unpacklo_epi32( rx, ry ) );
+					_mm_storeu_si128( reinterpret_cast<__m128i *>(out + 2 * n + 4), _mm_unpackhi_epi32( rx, ry ) );
+				}
+				return n;
+			}
+#endif
+		}	// namespace anonymous
+
+		point_array_t::point_array_t( ):
+				m_x{ },
+				m_y{ },
+				m_offset_x{ },
+				m_offset_y{ },
+				m_flags{ } { }
+
+		point_array_t::point_array_t( ::std::vector<point_t> const & points ):
+				point_array_t{ } {
+
+			reserve( points.size( ) );
+			for( auto const & point : points ) {
+				push_back( point );
+			}
+		}
+
+		void point_array_t::reserve( size_t count ) {
+			m_x.reserve( count );
+			m_y.reserve( count );
+			m_offset_x.reserve( count );
+			m_offset_y.reserve( count );
+			m_flags.reserve( count );
+		}
+
+		void point_array_t::push_back( point_t const & point ) {
+			auto const offset = point.get_offset( );
+			m_x.push_back( point.pos( ).x );
+			m_y.push_back( point.pos( ).y );
+			m_offset_x.push_back( offset.x );
+			m_offset_y.push_back( offset.y );
+			m_flags.push_back( static_cast<uint8_t>((point.get_unmapped_x( ) ? flag_unmapped_x : 0) | (point.get_unmapped_y( ) ? flag_unmapped_y : 0)) );
+		}
+
+		size_t point_array_t::size( ) const {
+			return m_x.size( );
+		}
+
+		bool point_array_t::empty( ) const {
+			return m_x.empty( );
+		}
+
+		point_t point_array_t::operator[]( size_t pos ) const {
+			return point_t{ m_x[pos], m_y[pos], static_cast<int8_t>(m_offset_x[pos]), static_cast<int8_t>(m_offset_y[pos]), 0 != (m_flags[pos] & flag_unmapped_x), 0 != (m_flags[pos] & flag_unmapped_y) };
+		}
+
+		size_t point_array_t::footprint( ) const {
+			return sizeof( *this ) + (m_x.capacity( ) + m_y.capacity( ) + m_offset_x.capacity( ) + m_offset_y.capacity( )) * sizeof( int ) + m_flags.capacity( ) * sizeof( uint8_t );
+		}
+
+		::std::vector<int> const & point_array_t::x( ) const {
+			return m_x;
+		}
+
+		::std::vector<int> const & point_array_t::y( ) const {
+			return m_y;
+		}
+
+		void point_array_t::map_points( translation_t const & coord_data, ::std::vector<wxPoint> & out ) const {
+			auto const count = size( );
+			out.resize( count );
+			if( 0 == count ) {
+				return;
+			}
+			affine_t const af{ coord_data };
+			auto const dest = reinterpret_cast<int *>(out.data( ));
+			size_t done = 0;
+#if DAW_POINT_ARRAY_SSE2
+			done = map_sse2( af, m_x.data( ), m_y.data( ), m_offset_x.data( ), m_offset_y.data( ), m_flags.data( ), dest, count );
+#endif
+			map_scalar( af, m_x.data( ), m_y.data( ), m_offset_x.data( ), m_offset_y.data( ), m_flags.data( ), dest, done, count );
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
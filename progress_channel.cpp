@@ -0,0 +1,115 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstdio>
+#include <utility>
+
+#include "progress_channel.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		progress_channel_t::progress_channel_t( ):
+				m_start( clock_t::now( ) ),
+				m_stage( 0 ),
+				m_stage_start_ns( 0 ),
+				m_rows_done( 0 ),
+				m_rows_total( 0 ),
+				m_bytes_done( 0 ),
+				m_bytes_total( 0 ) { }
+
+		int64_t progress_channel_t::now_ns( ) const {
+			return ::std::chrono::duration_cast<::std::chrono::nanoseconds>(clock_t::now( ) - m_start).count( );
+		}
+
+		void progress_channel_t::set_stage( int stage ) {
+			m_rows_done.store( 0, ::std::memory_order_relaxed );
+			m_rows_total.store( 0, ::std::memory_order_relaxed );
+			m_stage_start_ns.store( now_ns( ), ::std::memory_order_relaxed );
+			m_stage.store( stage, ::std::memory_order_relaxed );
+		}
+
+		void progress_channel_t::set_rows( uint64_t done, uint64_t total ) {
+			m_rows_total.store( total, ::std::memory_order_relaxed );
+			m_rows_done.store( done, ::std::memory_order_relaxed );
+		}
+
+		void progress_channel_t::set_bytes( uint64_t done, uint64_t total ) {
+			m_bytes_total.store( total, ::std::memory_order_relaxed );
+			m_bytes_done.store( done, ::std::memory_order_relaxed );
+		}
+
+		progress_channel_t::snapshot_t progress_channel_t::snapshot( ) const {
+			// Each value is exact, together they may be from a moment apart which is fine for display
+			snapshot_t result;
+			auto const now = now_ns( );
+			result.stage = m_stage.load( ::std::memory_order_relaxed );
+			result.rows_done = m_rows_done.load( ::std::memory_order_relaxed );
+			result.rows_total = m_rows_total.load( ::std::memory_order_relaxed );
+			result.bytes_done = m_bytes_done.load( ::std::memory_order_relaxed );
+			result.bytes_total = m_bytes_total.load( ::std::memory_order_relaxed );
+			result.stage_seconds = static_cast<double>(now - m_stage_start_ns.load( ::std::memory_order_relaxed )) / 1.0e9;
+			result.total_seconds = static_cast<double>(now) / 1.0e9;
+			return result;
+		}
+
+		double progress_channel_t::snapshot_t::rows_per_second( ) const {
+			return stage_seconds > 0.0 ? static_cast<double>(rows_done) / stage_seconds : 0.0;
+		}
+
+		double progress_channel_t::snapshot_t::bytes_per_second( ) const {
+			return total_seconds > 0.0 ? static_cast<double>(bytes_done) / total_seconds : 0.0;
+		}
+
+		double progress_channel_t::snapshot_t::eta_seconds( ) const {
+			if( 0 == rows_total ) {
+				// Parsing only knows how far through the file it is.  Once it is read the bytes say nothing of the
+				// stages after
+				auto const rate = bytes_per_second( );
+				if( 0 == bytes_total || bytes_done >= bytes_total || rate <= 0.0 ) {
+					return -1.0;
+				}
+				return static_cast<double>(bytes_total - bytes_done) / rate;
+			}
+			auto const rate = rows_per_second( );
+			if( rows_done > rows_total || rate <= 0.0 ) {
+				return -1.0;
+			}
+			return static_cast<double>(rows_total - rows_done) / rate;
+		}
+
+		::std::string format_count( double value ) {
+			char buff[32];
+			if( value >= 1.0e9 ) {
+				snprintf( buff, sizeof( buff ), "%.1f G", value / 1.0e9 );
+			} else if( value >= 1.0e6 ) {
+				snprintf( buff, sizeof( buff ), "%.1f M", value / 1.0e6 );
+			} else if( value >= 1.0e3 ) {
+				snprintf( buff, sizeof( buff ), "%.1f k", value / 1.0e3 );
+			} else {
+				snprintf( buff, sizeof( buff ), "%.0f ", value );
+			}
+			return buff;
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
@@ -21,17 +21,27 @@
 // SOFTWARE.
 
 
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <string>
+#include <vector>
+
 #include <daw/csv_helper/data_cell.h>
 #include <daw/csv_helper/data_table.h>
 #include <daw/daw_algorithm.h>
+#include <daw/daw_math.h>
 
+#include "allocation_tracker.h"
+#include "csv_parser.h"
+#include "parallel.h"
 #include "pump_data_analysis.h"
+#include "trace.h"
 
 namespace daw {
 	namespace pumpdataanalysis {
 
 		namespace {
-			size_t skip_hrs( size_t row, daw::data::DataTable::value_type const & ts_col, int32_t const hours ) {
+			size_t skip_hrs( size_t row, daw::data::compact_table_t::value_type const & ts_col, int32_t const hours ) {
 				auto const time_start = ts_col[row++].timestamp( );
 				for( ; row < ts_col.size( ); ++row ) {
 					auto const time_now = ts_col[row].timestamp( );
@@ -53,7 +63,7 @@ namespace daw {
 				return end_exclusive;
 			}
 
-			size_t row_from_date( boost::posix_time::ptime dte, const daw::data::DataTable::value_type& column_timestamp, size_t start_row = 0, size_t end_row = 0 ) {
+			size_t row_from_date( boost::posix_time::ptime dte, const daw::data::compact_table_t::value_type& column_timestamp, size_t start_row = 0, size_t end_row = 0 ) {
 				if( 0 == end_row ) {
 					end_row = column_timestamp.size( );
 				}
@@ -68,7 +78,7 @@ namespace daw {
 			}
 			
 			#if 0
-			std::pair<size_t, size_t> rows_from_date_range( ::std::pair<boost::posix_time::ptime, boost::posix_time::ptime> date_range, const daw::data::DataTable::value_type& column_timestamp ) {
+			std::pair<size_t, size_t> rows_from_date_range( ::std::pair<boost::posix_time::ptime, boost::posix_time::ptime> date_range, const daw::data::compact_table_t::value_type& column_timestamp ) {
 				size_t first = row_from_date( date_range.first, column_timestamp );
 				size_t last = row_from_date( date_range.second, column_timestamp, first + 1 );
 				if( column_timestamp.size( ) == last ) {
@@ -81,42 +91,73 @@ namespace daw {
 			}
 			#endif
 
-			bool should_stop_basal_test( const daw::data::DataTable& table, const size_t row ) {
+			// Rows between cancellation checks
+			size_t const s_rows_per_cancel_check = 4096;
+
+			/// Rows that end a basal test.  A row only depends on itself so they are found in parallel
+			::std::vector<uint8_t> find_stop_rows( const daw::data::compact_table_t& table, cancellation_token_t const & cancelled ) {
 				// Columns of impact
 				auto const& col_bolus = table["Bolus Volume Delivered (U)"];
 				auto const& col_carb = table["BWZ Carb Input (grams)"];
 				auto const& col_raw_type = table["Raw-Type"];
 
-				const bool has_manual_food = 0 == col_raw_type[row].string( ).compare( "JournalEntryMealMarker" );	// Has eaten
-				const bool has_temp_basal = 0 == col_raw_type[row].string( ).compare( "ChangeTempBasalPercent" );	// Basal dose isn't normal
-				const bool has_bolus_wizard_carb = !col_carb[row].empty( );	// Has eaten
-				const bool has_bolus_dose = !col_bolus[row].empty( );	// Has taken bolus insulin
-				return has_manual_food || has_temp_basal || has_bolus_wizard_carb || has_bolus_dose;
+				::std::vector<uint8_t> result( table["Timestamp"].size( ), 0 );
+				parallel_for( result.size( ), [&]( size_t first, size_t last ) {
+					cancelled.throw_if_cancelled( );
+					for( auto row = first; row < last; ++row ) {
+						const bool has_manual_food = 0 == col_raw_type[row].string( ).compare( "JournalEntryMealMarker" );	// Has eaten
+						const bool has_temp_basal = 0 == col_raw_type[row].string( ).compare( "ChangeTempBasalPercent" );	// Basal dose isn't normal
+						const bool has_bolus_wizard_carb = !col_carb[row].empty( );	// Has eaten
+						const bool has_bolus_dose = !col_bolus[row].empty( );	// Has taken bolus insulin
+						result[row] = static_cast<uint8_t>(has_manual_food || has_temp_basal || has_bolus_wizard_carb || has_bolus_dose);
+					}
+				} );
+				return result;
 			}
 
-			PumpDataAnalysis::basal_tests_t do_basal_test( daw::data::DataTable const & data_table ) {				
+			using bins_t = ::std::vector<daw::AggregateData<daw::data::real_t>>;
+
+			// Basal tests aggregated by one task
+			size_t const s_tests_per_range = 4;
+
+			void merge_bins( bins_t & into, bins_t const & from ) {
+				for( size_t n = 0; n < into.size( ); ++n ) {
+					into[n].merge( from[n] );
+				}
+			}
+
+			PumpDataAnalysis::basal_tests_t do_basal_test( daw::data::compact_table_t const & data_table, basal_test_params_t const & params, cancellation_token_t const & cancelled ) {
 				using daw::algorithm::rbegin2;
 				using ::std::begin;
 
+				trace_span_t span( "find_basal_tests" );
+				alloc_phase_scope_t phase( alloc_phase_t::analysis );
 				auto const& ts_col = data_table["Timestamp"];
+				span.counter( "rows", static_cast<int64_t>(ts_col.size( )) );
 				auto const& sensor_col = data_table["Sensor Glucose (mmol/L)"];
 				const ::std::pair<size_t, size_t> minmax_rows = { 0, ts_col.size( ) - 1 };
+				auto const stop_rows = find_stop_rows( data_table, cancelled );
 
 				std::vector<std::pair<daw::data::timestamp_t, size_t>> current_values;
 				PumpDataAnalysis::basal_tests_t basal_tests;
 				size_t start_row = minmax_rows.first;
-				start_row = skip_hrs( start_row, ts_col, 4 );	// We don't know if there is insulin/food just before start
+				start_row = skip_hrs( start_row, ts_col, params.settle_hours );	// We don't know if there is insulin/food just before start
 				// TODO: backtrack if duration is changed and see if we can go back 4hrs without food/insulin
 				// or start of file
+				auto next_cancel_check = start_row;
 				for( size_t row = start_row; row <= minmax_rows.second; ++row ) {
+					if( row >= next_cancel_check ) {
+						cancelled.throw_if_cancelled( );
+						next_cancel_check = row + s_rows_per_cancel_check;
+					}
 					if( sensor_col[row] ) {
 						current_values.push_back( { ts_col[row].timestamp( ), row } );
 					}
 
-					if( should_stop_basal_test( data_table, row ) ) {
+					if( stop_rows[row] ) {
 						if( 2 <= current_values.size( ) && rbegin2( current_values )->first != begin( current_values )->first ) {
 							const boost::posix_time::time_duration duration = rbegin2( current_values )->first - begin( current_values )->first;
-							if( duration.total_seconds( ) > 1800 ) {	// For now, keep a minimum duration of 1/2hr.  May not be needed TODO: test change without
+							if( duration.total_seconds( ) > params.min_minutes * 60 ) {	// For now, keep a minimum duration of 1/2hr.  May not be needed TODO: test change without
 								auto const minmax_vals = [&]( ) {
 									std::pair<daw::data::real_t, daw::data::real_t> ret{ ::std::numeric_limits<daw::data::real_t>::max( ), ::std::numeric_limits<daw::data::real_t>::min( ) };
 									for( auto const& pos : current_values ) {
@@ -135,94 +176,422 @@ namespace daw {
 									return ret;
 								}();
 								auto const rise = (minmax_vals.second - minmax_vals.first) / (static_cast<daw::data::real_t>(duration.hours( )) + static_cast<daw::data::real_t>(duration.minutes( )) / 60.0);
-								if( abs( rise ) <= 1.0 && (rbegin2( current_values )->first - begin( current_values )->first).hours( ) < 24 ) {	// For now, don't allow more than a 1mmol/L per hr rise or drop
+								if( abs( rise ) <= params.max_rise && (rbegin2( current_values )->first - begin( current_values )->first).hours( ) < params.max_hours ) {	// For now, don't allow more than a 1mmol/L per hr rise or drop
 									basal_tests.push_back( { begin( current_values )->second, rbegin2( current_values )->second } );
 								}
 							}
 						}
 						current_values.clear( );
-						row = skip_hrs( row, ts_col, 4 );
+						row = skip_hrs( row, ts_col, params.settle_hours );
 					}
 				}
+				span.counter( "tests", static_cast<int64_t>(basal_tests.size( )) );
 				return basal_tests;
 			}
 
+			template<typename Cells>
+			void convert_timestamp_cells( Cells & ts_col, size_t first_row, size_t last_row ) {
+				// Convert Timestamp column from string to timestamp
+				static auto const dteformat = "%d/%m/%y %H:%M:%S";
+				trace_span_t span( "convert_timestamps" );
+				alloc_phase_scope_t phase( alloc_phase_t::analysis );
+				span.counter( "rows", static_cast<int64_t>(last_row - first_row) );
+				// Parsing a timestamp is slow enough that small ranges are still worth a task
+				parallel_for( last_row - first_row, [&]( size_t first, size_t last ) {
+					for( auto row = first_row + first; row < first_row + last; ++row ) {
+						auto & cell = ts_col[row];
+						auto cell_value = cell.string( );
+						cell = daw::data::DataCell::from_time_string( cell_value, dteformat );
+					}
+				}, 1024 );
+			}
+
+			/// Carelink exports have 11 lines before the header, rows without data are dropped as they are read and
+			/// columns the analyses do not read are left lazy
+			daw::data::csv_parse_options_t pump_parse_options( ::std::function<void( size_t, size_t )> on_progress ) {
+				daw::data::csv_parse_options_t options;
+				options.header_row = 11;
+				options.column_filter = &pump_column_filter;
+				options.parse_now = &pump_column_is_hot;
+				options.skip_empty_rows = true;
+				options.on_progress = ::std::move( on_progress );
+				return options;
+			}
+
+			daw::data::csv_parse_result_t parse_pump_data( ::std::string const & filename, ::std::function<void( size_t, size_t )> on_progress ) {
+				trace_span_t span( "parse_csv" );
+				alloc_phase_scope_t phase( alloc_phase_t::parse );
+				auto result = daw::data::parse_csv_file( filename, pump_parse_options( ::std::move( on_progress ) ) );
+				span.counter( "bytes", static_cast<int64_t>(result.bytes) );
+				span.counter( "rows", static_cast<int64_t>(result.rows_read) );
+				span.counter( "rows_skipped", static_cast<int64_t>(result.rows_skipped) );
+				return result;
+			}
 		}	// namespace anonymous~
 
-		daw::data::DataTable PumpDataAnalysis::parse_csv( daw::data::parse_csv_data_param const & param, ::std::function<void( )> on_completed ) {
-			auto && tbl = daw::data::parse_csv_data( ::std::move( param ) );
-			if( !tbl.has_value( ) ) {
-				::std::string msg = ": Error opening table\n";
-				msg += tbl.get_exception_message( );
-				throw ::std::runtime_error( msg );
-			} else {
-				daw::data::DataTable result = ::std::move( tbl.get( ) );
-				// Cleanup
-				{	// TODO: Move out to a callback
-					daw::data::algorithm::erase_rows( result, []( auto const & row, auto const & tbl ) {
-						for( size_t n = 1; n < tbl.size( ); ++n ) {
-							if( tbl[n][row] ) {
-								return false;	// Row has data, don't erase
+		bool pump_column_filter( ::std::string const & header ) {
+			using daw::algorithm::contains;
+			static std::vector<std::string> const disallowed_headers = { "Index", "Time", "Date", "Raw-ID", "Raw-Upload ID", "Raw-Seq Num", "Raw-Device Type" };
+			const bool is_disallowed = contains( disallowed_headers, header );
+			return !is_disallowed;
+		}
+
+		bool pump_column_is_hot( ::std::string const & header ) {
+			using daw::algorithm::contains;
+			// Every column read by find_basal_tests, the aggregates and the plots
+			static std::vector<std::string> const hot_headers = { "Timestamp", "Sensor Glucose (mmol/L)", "BWZ Carb Input (grams)", "Bolus Volume Delivered (U)", "Raw-Type" };
+			return contains( hot_headers, header );
+		}
+
+		void clean_pump_data( daw::data::DataTable & data_table ) {
+			remove_empty_rows( data_table );
+			convert_timestamps( data_table, 0, data_table["Timestamp"].size( ) );
+		}
+
+		void remove_empty_rows( daw::data::DataTable & data_table ) {
+			trace_span_t span( "remove_empty_rows" );
+			alloc_phase_scope_t phase( alloc_phase_t::analysis );
+			auto const row_count = data_table.empty( ) ? 0 : data_table[0].size( );
+			span.counter( "rows_in", static_cast<int64_t>(row_count) );
+			// Rows are checked in parallel, then every column is compacted in one stable pass, columns in parallel
+			::std::vector<uint8_t> keep( row_count, 0 );
+			parallel_for( row_count, [&]( size_t first, size_t last ) {
+				for( auto row = first; row < last; ++row ) {
+					for( size_t n = 1; n < data_table.size( ); ++n ) {
+						if( data_table[n][row] ) {
+							keep[row] = 1;	// Row has data
+							break;
+						}
+					}
+				}
+			} );
+			parallel_for( data_table.size( ), [&]( size_t first, size_t last ) {
+				for( auto col = first; col < last; ++col ) {
+					auto & column = data_table[col];
+					size_t kept = 0;
+					for( size_t row = 0; row < row_count; ++row ) {
+						if( keep[row] ) {
+							if( kept != row ) {
+								column[kept] = ::std::move( column[row] );
 							}
+							++kept;
 						}
-						return true;	// Row is empty of our data
-					} );
-					// Convert Timestamp column from string to timestamp
-					static auto const dteformat = "%d/%m/%y %H:%M:%S";
-					for( auto & cell : result["Timestamp"] ) {
-						auto cell_value = cell.string( );
-						cell = daw::data::DataCell::from_time_string( cell_value, dteformat );
 					}
+					column.erase( column.begin( ) + static_cast<ptrdiff_t>(kept), column.end( ) );
+				}
+			}, 1 );
+			span.counter( "rows_out", data_table.empty( ) ? 0 : static_cast<int64_t>(data_table[0].size( )) );
+		}
+
+		void convert_timestamps( daw::data::DataTable & data_table, size_t first_row, size_t last_row ) {
+			convert_timestamp_cells( data_table["Timestamp"], first_row, last_row );
+		}
+
+		void convert_timestamps( ::std::vector<daw::data::DataCell> & timestamps, size_t first_row, size_t last_row ) {
+			convert_timestamp_cells( timestamps, first_row, last_row );
+		}
+
+		daw::data::compact_table_t compact_pump_data( daw::data::DataTable data_table ) {
+			return compact_pump_data( daw::data::to_dense_columns( data_table ) );
+		}
+
+		daw::data::compact_table_t compact_pump_data( ::std::vector<daw::data::dense_column_t> columns, ::std::vector<::std::unique_ptr<daw::data::lazy_column_t const>> lazy ) {
+			trace_span_t span( "compact_table" );
+			alloc_phase_scope_t phase( alloc_phase_t::analysis );
+			daw::data::compact_table_t result( ::std::move( columns ), ::std::move( lazy ), []( ::std::string const & header ) {
+				return header == "Timestamp";
+			} );
+			span.counter( "columns", static_cast<int64_t>(result.size( )) );
+			span.counter( "sparse", static_cast<int64_t>(result.sparse_count( )) );
+			span.counter( "lazy", static_cast<int64_t>(result.lazy_count( )) );
+			return result;
+		}
+
+		daw::data::compact_table_t load_pump_data( ::std::string const & filename, ::std::function<void( ::std::string )> on_status ) {
+			trace_span_t span( "load_pump_data" );
+			auto parsed = parse_pump_data( filename, [&on_status]( size_t done, size_t total ) {
+				if( on_status ) {
+					on_status( "Parsed " + ::std::to_string( done / (1024 * 1024) ) + " of " + ::std::to_string( total / (1024 * 1024) ) + " MiB" );
+				}
+			} );
+			// Empty rows were never stored, see pump_parse_options
+			auto compacted = compact_pump_data( ::std::move( parsed.columns ), ::std::move( parsed.lazy ) );
+			auto & timestamps = compacted.dense_cells( "Timestamp" );
+			convert_timestamps( timestamps, 0, timestamps.size( ) );
+			return compacted;
+		}
+
+		PumpDataAnalysis::basal_tests_t find_basal_tests( daw::data::compact_table_t const & data_table, cancellation_token_t const & cancelled ) {
+			return do_basal_test( data_table, basal_test_params_t( ), cancelled );
+		}
+
+		PumpDataAnalysis::basal_tests_t find_basal_tests( daw::data::compact_table_t const & data_table, basal_test_params_t const & params, cancellation_token_t const & cancelled ) {
+			return do_basal_test( data_table, params, cancelled );
+		}
+
+		::std::vector<daw::AggregateData<daw::data::real_t>> aggregate_basal_tests( daw::data::compact_table_t const & data_table, PumpDataAnalysis::basal_tests_t const & positions, cancellation_token_t const & cancelled ) {
+			trace_span_t span( "aggregate_basal_tests" );
+			alloc_phase_scope_t phase( alloc_phase_t::analysis );
+			span.counter( "tests", static_cast<int64_t>(positions.size( )) );
+
+			auto const& bg_col = data_table["Sensor Glucose (mmol/L)"];
+			auto const& ts_col = data_table["Timestamp"];
+
+			// Tests are binned in parallel, each range into its own bins, and the bins merged in order
+			auto result = parallel_reduce( positions.size( ), bins_t( 24 * 12, daw::AggregateData<daw::data::real_t>( ) ), [&]( size_t first, size_t last, bins_t & bins ) {
+				for( auto n = first; n < last; ++n ) {
+					cancelled.throw_if_cancelled( );
+					auto const position = positions[n];
+					for( auto row = position.first; row <= position.second; ++row ) {
+						if( bg_col[row] ) {
+							const size_t pos = [&]( ) {
+								auto const ts_value = ts_col[row].timestamp( ).time_of_day( );
+								auto ret = ts_value.hours( ) * 12 + daw::math::round_to_nearest( ts_value.minutes( ), 5.0 ) / 5;
+								if( 288 == ret ) {
+									ret = 0;
+								}
+								return ret;
+							}();
+
+							auto const bg_value = bg_col[row].real( );
+							bins[pos].add_value( bg_value );
+						}
+					}
+				}
+			}, &merge_bins, s_tests_per_range );
+
+			for( auto& avg_item : result ) {
+				if( 0 != avg_item.average ) {
+					avg_item.process_values( );
 				}
-				on_completed( );
-				m_basal_tests_fut = std::async( [res = std::cref( result )]( ) {
-					return do_basal_test( res );
-				} ).share( );
-				return result;
 			}
+			return result;
 		}
 
-		PumpDataAnalysis::PumpDataAnalysis( daw::data::parse_csv_data_param const & param, ::std::function<void( )> on_completed ):
-				m_data_table_fut{ std::async( [&, param, on_completed]( ) {
+		::std::vector<daw::AggregateData<daw::data::real_t>> aggregate_basal_test_derivatives( daw::data::compact_table_t const & data_table, PumpDataAnalysis::basal_tests_t const & positions, cancellation_token_t const & cancelled ) {
+			trace_span_t span( "aggregate_basal_test_derivatives" );
+			alloc_phase_scope_t phase( alloc_phase_t::analysis );
+			span.counter( "tests", static_cast<int64_t>(positions.size( )) );
+
+			auto const& bg_col = data_table["Sensor Glucose (mmol/L)"];
+			auto const& ts_col = data_table["Timestamp"];
+
+			auto const incs_per_hour = 1;	// must be 12(5min),6(10min),4(15min),3(20min),2(30min),1(60min)
+			auto const incs_every_n_min = 60 / incs_per_hour;
+			auto result = parallel_reduce( positions.size( ), bins_t( 24 * 12, daw::AggregateData<daw::data::real_t>( ) ), [&]( size_t first, size_t last, bins_t & bins ) {
+				for( auto n = first; n < last; ++n ) {
+					cancelled.throw_if_cancelled( );
+					auto const position = positions[n];
+					for( auto row = position.first; row <= position.second; ++row ) {
+						if( bg_col[row] ) {
+							auto const five_minute_periods_per_day = (60 / 5) * 24;
+							const size_t pos = [&]( ) {
+								auto const ts_value = ts_col[row].timestamp( ).time_of_day( );
+								auto ret = ts_value.hours( ) * 12 + daw::math::round_to_nearest( ts_value.minutes( ), static_cast<float>(incs_every_n_min) ) / 5;
+								//auto ret = ts_value.hours( )*12;					
+								if( five_minute_periods_per_day <= ret ) {	// Wrap back to midnight 0
+									ret = 0;
+								}
+								return ret;
+							}();				
+							auto const bg_value = bg_col[row].real( );
+							auto const prev_row = row > 0 ? row - 1 : five_minute_periods_per_day-1;
+							auto const bg_prev = [prev_row, &bg_col]( ) {
+								if( bg_col[prev_row] ) {
+									return bg_col[prev_row].real( );
+								}
+								return static_cast<daw::data::real_t>( 0 );
+							}();
+
+							if( 0 != bg_prev ) {
+								for( int inc = 0; inc < (incs_every_n_min/5); ++inc ) {
+									bins[pos+inc].add_value( (bg_value - bg_prev)*12.0 );	// mmol/L / hr instead of mmol/L / 5min
+								}
+							}
+						}
+					}
+				}
+			}, &merge_bins, s_tests_per_range );
 
-			auto result = parse_csv( param, on_completed );
+			for( auto& avg_item : result ) {
+				if( 0 != avg_item.average ) {
+					avg_item.process_values( );
+				}
+			}
 			return result;
-		} ).share( ) } { }
+		}
 
-		daw::data::DataTable const & PumpDataAnalysis::data_table( ) const {
-			return m_data_table_fut.get( );
+		size_t load_memory_estimate( ::std::string const & filename ) {
+			// Parsed cells take several times the room of their text
+			size_t const memory_per_file_byte = 8;
+			boost::system::error_code ec;
+			auto const file_size = static_cast<size_t>(boost::filesystem::file_size( filename, ec ));
+			return ec ? 0 : file_size * memory_per_file_byte;
 		}
 
-		PumpDataAnalysis::basal_tests_t const & PumpDataAnalysis::basal_tests( ) const {
-			return m_basal_tests_fut.get( );
-		}
-
-		PumpDataAnalysis::PumpDataAnalysis( PumpDataAnalysis&& other ) noexcept:
-				m_data_table_fut{ ::std::move( other.m_data_table_fut ) },
-				m_basal_tests_fut{ ::std::move( other.m_basal_tests_fut ) } { }
-	
-		PumpDataAnalysis & PumpDataAnalysis::operator=( PumpDataAnalysis && rhs) noexcept {
-			if( this != &rhs ) {
-				PumpDataAnalysis tmp{ ::std::move( rhs ) };
-				using std::swap;
-				swap( *this, tmp );
+		PumpDataAnalysis::PumpDataAnalysis( ::std::string filename ):
+				m_table_mutex{ },
+				m_data_table{ new daw::data::compact_table_t( ) },
+				m_basal_tests{ },
+				m_error{ },
+				m_stage{ load_stage_t::parsing },
+				m_rows_ready{ 0 },
+				m_progress{ },
+				m_cancel{ },
+				m_loader{ } {
+
+			// Several files opened at once are loaded as memory allows rather than all together
+			auto const memory_estimate = load_memory_estimate( filename );
+			m_loader = task_pool_t::get( ).submit( task_priority_t::background, [this, filename = ::std::move( filename )]( ) {
+				load( filename );
+			}, memory_estimate );
+		}
+
+		PumpDataAnalysis::~PumpDataAnalysis( ) {
+			cancel( );
+			wait( );
+		}
+
+		void PumpDataAnalysis::load( ::std::string const & filename ) {
+			// Each stage publishes with a release store of m_stage, readers acquire it before touching what it guards
+			auto const set_stage = [&]( load_stage_t stage ) {
+				m_progress.set_stage( static_cast<int>(stage) );
+				m_stage.store( stage, ::std::memory_order_release );
+			};
+			auto const cancelled = m_cancel.token( );
+			trace_span_t span( "load" );
+			try {
+				// Cancelled before the pool got to it, the load is then run by the thread waiting on it
+				cancelled.throw_if_cancelled( );
+				m_progress.set_stage( static_cast<int>(load_stage_t::parsing) );
+				boost::system::error_code ec;
+				auto const file_size = static_cast<uint64_t>(boost::filesystem::file_size( filename, ec ));
+				auto const bytes_total = ec ? 0 : file_size;
+				m_progress.set_bytes( 0, bytes_total );
+				// The parser is stopped by throwing from its progress callback.  Its columns are only compacted into
+				// the table once it is done, no rows can be shown before that
+				auto parsed = parse_pump_data( filename, [this, cancelled]( size_t done, size_t total ) {
+					cancelled.throw_if_cancelled( );
+					m_progress.set_bytes( done, total );
+				} );
+				m_progress.set_bytes( bytes_total, bytes_total );
+				set_stage( load_stage_t::cleaning );
+				{
+					// Nothing can read the table before converting, the lock only keeps to the scheme.  Empty rows
+					// were dropped while parsing
+					auto const lock = write_lock( );
+					*m_data_table = compact_pump_data( ::std::move( parsed.columns ), ::std::move( parsed.lazy ) );
+				}
+				cancelled.throw_if_cancelled( );
+				set_stage( load_stage_t::converting );
+
+				// From here on only cells at or past rows_ready are written, readers stay below it
+				auto const row_count = (*m_data_table)["Timestamp"].size( );
+				for( size_t first = 0; first < row_count; first += s_rows_per_block ) {
+					auto const last = ::std::min( first + s_rows_per_block, row_count );
+					cancelled.throw_if_cancelled( );
+					convert_timestamps( m_data_table->dense_cells( "Timestamp" ), first, last );
+					m_rows_ready.store( last, ::std::memory_order_release );
+					m_progress.set_rows( last, row_count );
+				}
+				set_stage( load_stage_t::detecting );
+
+				m_basal_tests = find_basal_tests( *m_data_table, cancelled );
+				set_stage( load_stage_t::ready );
+			} catch( ::std::exception const & ex ) {
+				m_error = ex.what( );
+				set_stage( load_stage_t::failed );
+			}
+		}
+
+		PumpDataAnalysis::load_stage_t PumpDataAnalysis::stage( ) const {
+			return m_stage.load( ::std::memory_order_acquire );
+		}
+
+		bool PumpDataAnalysis::has_table( ) const {
+			auto const current = stage( );
+			return load_stage_t::converting <= current && load_stage_t::failed != current;
+		}
+
+		bool PumpDataAnalysis::has_data( ) const {
+			auto const current = stage( );
+			return load_stage_t::detecting <= current && load_stage_t::failed != current;
+		}
+
+		bool PumpDataAnalysis::is_ready( ) const {
+			return load_stage_t::ready == stage( );
+		}
+
+		bool PumpDataAnalysis::has_failed( ) const {
+			return load_stage_t::failed == stage( );
+		}
+
+		::std::string const & PumpDataAnalysis::error( ) const {
+			return m_error;
+		}
+
+		size_t PumpDataAnalysis::rows_ready( ) const {
+			return m_rows_ready.load( ::std::memory_order_acquire );
+		}
+
+		progress_channel_t const & PumpDataAnalysis::progress( ) const {
+			return m_progress;
+		}
+
+		char const * load_stage_name( PumpDataAnalysis::load_stage_t stage ) {
+			switch( stage ) {
+			case PumpDataAnalysis::load_stage_t::parsing:
+				return "Reading";
+			case PumpDataAnalysis::load_stage_t::cleaning:
+				return "Removing empty rows";
+			case PumpDataAnalysis::load_stage_t::converting:
+				return "Converting timestamps";
+			case PumpDataAnalysis::load_stage_t::detecting:
+				return "Looking for basal tests";
+			case PumpDataAnalysis::load_stage_t::ready:
+				return "Loaded";
+			case PumpDataAnalysis::load_stage_t::failed:
+			default:
+				return "Failed";
+			}
+		}
+
+		void PumpDataAnalysis::cancel( ) {
+			m_cancel.cancel( );
+		}
+
+		void PumpDataAnalysis::wait( ) const {
+			if( m_loader.valid( ) ) {
+				m_loader.wait( );
 			}
-			return *this;
 		}
 
-		void swap( PumpDataAnalysis & lhs, PumpDataAnalysis & rhs ) noexcept {
-			using ::std::swap;
-			swap( lhs.m_data_table_fut, rhs.m_data_table_fut );
-			swap( lhs.m_basal_tests_fut, rhs.m_basal_tests_fut );
+		daw::data::compact_table_t const & PumpDataAnalysis::data_table( ) const {
+			daw::exception::dbg_throw_on_false( has_table( ), ": Attempt to access the table before it is loaded" );
+			return *m_data_table;
+		}
+
+		PumpDataAnalysis::basal_tests_t const & PumpDataAnalysis::basal_tests( ) const {
+			daw::exception::dbg_throw_on_false( is_ready( ), ": Attempt to access basal tests before they are found" );
+			return m_basal_tests;
+		}
+
+		::std::shared_lock<shared_mutex_t> PumpDataAnalysis::read_lock( ) const {
+			return ::std::shared_lock<shared_mutex_t>( m_table_mutex );
+		}
+
+		::std::unique_lock<shared_mutex_t> PumpDataAnalysis::write_lock( ) {
+			return ::std::unique_lock<shared_mutex_t>( m_table_mutex );
 		}
 
-		PumpDataAnalysis::basal_tests_t PumpDataAnalysis::basal_tests_in_range( ::std::pair<boost::posix_time::ptime, boost::posix_time::ptime> date_range ) {
+		PumpDataAnalysis::basal_tests_t PumpDataAnalysis::basal_tests_in_range( ::std::pair<boost::posix_time::ptime, boost::posix_time::ptime> date_range ) const {
+			auto const lock = read_lock( );
 			auto const& ts_col = data_table( )["Timestamp"];
 			const size_t min_row = row_from_date( date_range.first, ts_col );
 			const size_t max_row = row_from_date( date_range.second, ts_col, min_row + 1 );
 
 			auto const first = [&]( ) {
-				for( size_t test_no = 0; test_no <= basal_tests( ).size( ); ++test_no ) {
+				for( size_t test_no = 0; test_no < basal_tests( ).size( ); ++test_no ) {
 					if( basal_tests( )[test_no].first >= min_row ) {
 						return test_no;
 					}
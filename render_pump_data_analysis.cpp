@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <wx/init.h>
+#include <wx/wx.h>
+
+#include "batch_render.h"
+#include "task_pool.h"
+
+// ---------------------------------------------------------------------------
+// Batch rendering of the basal test reports without a window.  wx still has
+// to be initialized for drawing, under X that needs a display such as xvfb
+// ---------------------------------------------------------------------------
+
+int main( int argc, char ** argv ) {
+	namespace po = boost::program_options;
+	using namespace daw::pumpdataanalysis;
+
+	batch_render_options_t options;
+	::std::vector<::std::string> inputs;
+	::std::string out_dir;
+	int width = options.size.GetWidth( );
+	int height = options.size.GetHeight( );
+	size_t memory_budget_mib = 0;
+
+	po::options_description visible( "Usage: mm_history_render [options] -o dir export.csv...\nOptions" );
+	visible.add_options( )
+		( "help,h", "Show this message" )
+		( "output,o", po::value<::std::string>( &out_dir ), "Folder the images are written to" )
+		( "width", po::value<int>( &width )->default_value( width ), "Image width in pixels" )
+		( "height", po::value<int>( &height )->default_value( height ), "Image height in pixels" )
+		( "svg", "Write SVG images as well" )
+		( "no-png", "Do not write PNG images" )
+		( "threads", po::value<size_t>( &options.thread_count )->default_value( options.thread_count ), "Plots built at once, 0 for one per hardware thread" )
+		( "memory-budget", po::value<size_t>( &memory_budget_mib ), "MiB of estimated memory the files being loaded at once may use" );
+
+	po::options_description hidden;
+	hidden.add_options( )
+		( "input", po::value<::std::vector<::std::string>>( &inputs ), "Carelink CSV exports" );
+
+	po::options_description all;
+	all.add( visible ).add( hidden );
+	po::positional_options_description positional;
+	positional.add( "input", -1 );
+
+	try {
+		po::variables_map vm;
+		po::store( po::command_line_parser( argc, argv ).options( all ).positional( positional ).run( ), vm );
+		po::notify( vm );
+		if( vm.count( "help" ) || inputs.empty( ) || out_dir.empty( ) ) {
+			::std::cout << visible << '\n';
+			return vm.count( "help" ) ? 0 : 1;
+		}
+		if( width <= 0 || height <= 0 ) {
+			throw ::std::runtime_error( "--width and --height must be greater than 0" );
+		}
+		options.size = wxSize( width, height );
+		options.write_svg = 0 != vm.count( "svg" );
+		options.write_png = 0 == vm.count( "no-png" );
+		if( !options.write_png && !options.write_svg ) {
+			throw ::std::runtime_error( "--no-png without --svg leaves nothing to write" );
+		}
+		if( 0 != memory_budget_mib ) {
+			daw::task_pool_t::get( ).set_memory_budget( memory_budget_mib * 1024 * 1024 );
+		}
+	} catch( ::std::exception const & ex ) {
+		::std::cerr << ex.what( ) << '\n' << visible << '\n';
+		return 1;
+	}
+
+	wxInitializer initializer( argc, argv );
+	if( !initializer.IsOk( ) ) {
+		::std::cerr << "Could not initialize wxWidgets, drawing needs a display\n";
+		return 1;
+	}
+
+	try {
+		// This is the only thread using wx, so it is the one that draws
+		batch_render_t batch( inputs, out_dir, options );
+		while( !batch.draw_ready( ::std::chrono::milliseconds( 100 ) ) ) { }
+		auto const result = batch.get( );
+		::std::cout << "Rendered " << result.images_written << " images from " << result.files_loaded << " files\n";
+		for( auto const & error : result.errors ) {
+			::std::cerr << error << '\n';
+		}
+		// The images that could be drawn are still written, the exit code tells a script some failed
+		return result.errors.empty( ) ? 0 : 2;
+	} catch( ::std::exception const & ex ) {
+		::std::cerr << "Unrecoverable error: " << ex.what( ) << '\n';
+		return 1;
+	}
+}
@@ -0,0 +1,201 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <daw/csv_helper/data_common.h>
+#include <daw/daw_exception.h>
+
+#include "parallel.h"
+#include "row_view.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define DAW_ROW_VIEW_SSE2 1
+#include <emmintrin.h>
+#else
+#define DAW_ROW_VIEW_SSE2 0
+#endif
+
+namespace daw {
+	namespace data {
+		bool row_view_spec_t::is_identity( ) const {
+			return no_sort == sort_col && filters.empty( );
+		}
+
+		namespace {
+			boost::posix_time::ptime const & epoch( ) {
+				static boost::posix_time::ptime const s_epoch( boost::gregorian::date( 1970, 1, 1 ) );
+				return s_epoch;
+			}
+
+			/// mask[n] &= low <= values[n] <= high.  NaN never matches
+			void and_in_range( double const * values, uint8_t * mask, size_t size, double low, double high ) {
+				size_t n = 0;
+#if DAW_ROW_VIEW_SSE2
+				auto const v_low = _mm_set1_pd( low );
+				auto const v_high = _mm_set1_pd( high );
+				for( ; n + 2 <= size; n += 2 ) {
+					auto const v = _mm_loadu_pd( values + n );
+					auto const bits = _mm_movemask_pd( _mm_and_pd( _mm_cmpge_pd( v, v_low ), _mm_cmple_pd( v, v_high ) ) );
+					mask[n] &= static_cast<uint8_t>(bits & 1);
+					mask[n + 1] &= static_cast<uint8_t>((bits >> 1) & 1);
+				}
+#endif
+				for( ; n < size; ++n ) {
+					mask[n] &= static_cast<uint8_t>(values[n] >= low && values[n] <= high);
+				}
+			}
+
+			struct sort_key_t {
+				enum : uint8_t { number = 0, text, empty };
+				uint8_t cls;
+				double value;
+				boost::string_ref str;	// Into the table, which outlives the keys
+			};
+
+			sort_key_t make_sort_key( daw::data::compact_table_t::value_type::value_type const & cell ) {
+				switch( cell.type( ) ) {
+				case DataCellType::real:
+				case DataCellType::timestamp:
+					return { sort_key_t::number, numeric_key( cell ), boost::string_ref( ) };
+				case DataCellType::string:
+					return { sort_key_t::text, 0.0, boost::string_ref( cell.string( ) ) };
+				case DataCellType::empty_string:
+				default:
+					return { sort_key_t::empty, 0.0, boost::string_ref( ) };
+				}
+			}
+
+			// Orders two keys, empty cells last whichever the direction
+			struct key_less_t {
+				::std::vector<sort_key_t> const * keys;
+				bool ascending;
+
+				bool operator( )( size_t row_a, size_t row_b ) const {
+					auto const & a = (*keys)[row_a];
+					auto const & b = (*keys)[row_b];
+					if( a.cls == sort_key_t::empty || b.cls == sort_key_t::empty ) {
+						return a.cls != sort_key_t::empty && b.cls == sort_key_t::empty;
+					}
+					if( a.cls != b.cls ) {
+						return ascending == (a.cls < b.cls);
+					}
+					if( sort_key_t::number == a.cls ) {
+						return ascending ? a.value < b.value : b.value < a.value;
+					}
+					return ascending ? a.str < b.str : b.str < a.str;
+				}
+			};
+		}	// namespace anonymous
+
+		double numeric_key( daw::data::compact_table_t::value_type::value_type const & cell ) {
+			switch( cell.type( ) ) {
+			case DataCellType::real:
+				return static_cast<double>(cell.real( ));
+			case DataCellType::timestamp:
+				return static_cast<double>((cell.timestamp( ) - epoch( )).total_seconds( ));
+			default:
+				return ::std::numeric_limits<double>::quiet_NaN( );
+			}
+		}
+
+		::std::vector<size_t> filter_rows( daw::data::compact_table_t const & table, ::std::vector<row_filter_t> const & filters ) {
+			auto const row_count = table.empty( ) ? 0 : table[0].size( );
+			::std::vector<uint8_t> mask( row_count, 1 );
+			::std::vector<double> values;
+			for( auto const & filter : filters ) {
+				daw::exception::dbg_throw_on_false( filter.col < table.size( ), ": Filter column is out of range" );
+				auto const & column = table[filter.col];
+				switch( filter.kind ) {
+				case row_filter_t::kind_t::has_value:
+					parallel_for( row_count, [&]( size_t first, size_t last ) {
+						for( auto row = first; row < last; ++row ) {
+							mask[row] &= static_cast<uint8_t>(!column[row].empty( ));
+						}
+					} );
+					break;
+				case row_filter_t::kind_t::in_range:
+					// Decode the typed cells once into a flat array so the compare runs over plain doubles
+					values.resize( row_count );
+					parallel_for( row_count, [&]( size_t first, size_t last ) {
+						for( auto row = first; row < last; ++row ) {
+							values[row] = numeric_key( column[row] );
+						}
+						and_in_range( values.data( ) + first, mask.data( ) + first, last - first, filter.low, filter.high );
+					} );
+					break;
+				}
+			}
+			if( 0 == row_count ) {
+				return ::std::vector<size_t>( );
+			}
+			// Each range's kept rows are counted, a scan gives where each range starts in the result and
+			// the ranges then write their rows in parallel
+			::std::vector<size_t> offsets( parallel_range_count( row_count ), 0 );
+			parallel_for_ranges( row_count, [&]( size_t range, size_t first, size_t last ) {
+				offsets[range] = static_cast<size_t>(::std::count( mask.begin( ) + static_cast<ptrdiff_t>(first), mask.begin( ) + static_cast<ptrdiff_t>(last), static_cast<uint8_t>(1) ));
+			} );
+			::std::vector<size_t> result( parallel_exclusive_scan( offsets ) );
+			parallel_for_ranges( row_count, [&]( size_t range, size_t first, size_t last ) {
+				auto out = offsets[range];
+				for( auto row = first; row < last; ++row ) {
+					if( mask[row] ) {
+						result[out++] = row;
+					}
+				}
+			} );
+			return result;
+		}
+
+		void sort_rows( daw::data::compact_table_t const & table, size_t col, bool ascending, ::std::vector<size_t> & rows ) {
+			daw::exception::dbg_throw_on_false( col < table.size( ), ": Sort column is out of range" );
+			auto const & column = table[col];
+			// Keys are indexed by table row so rows can be any subset of the table
+			::std::vector<sort_key_t> keys( column.size( ) );
+			parallel_for( keys.size( ), [&]( size_t first, size_t last ) {
+				for( auto row = first; row < last; ++row ) {
+					keys[row] = make_sort_key( column[row] );
+				}
+			} );
+			parallel_stable_sort( rows.begin( ), rows.end( ), key_less_t{ &keys, ascending } );
+		}
+
+		::std::shared_ptr<::std::vector<size_t> const> make_row_view( daw::data::compact_table_t const & table, row_view_spec_t const & spec ) {
+			if( spec.is_identity( ) ) {
+				return nullptr;
+			}
+			auto rows = filter_rows( table, spec.filters );
+			if( row_view_spec_t::no_sort != spec.sort_col ) {
+				sort_rows( table, spec.sort_col, spec.ascending, rows );
+			}
+			return ::std::make_shared<::std::vector<size_t> const>( ::std::move( rows ) );
+		}
+	}	// namespace data
+}	// namespace daw
+
@@ -0,0 +1,119 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <utility>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+#include "sparse_column.h"
+
+namespace daw {
+	namespace data {
+		namespace {
+			size_t const s_bits_per_word = 64;
+
+			size_t popcount( uint64_t value ) {
+#if defined( _MSC_VER )
+				return static_cast<size_t>(__popcnt64( value ));
+#else
+				return static_cast<size_t>(__builtin_popcountll( value ));
+#endif
+			}
+
+			sparse_column_t::value_type const & empty_cell( ) {
+				static sparse_column_t::value_type const s_empty_cell;
+				return s_empty_cell;
+			}
+		}	// namespace anonymous
+
+		sparse_column_t::sparse_column_t( ):
+				m_size( 0 ),
+				m_present( ),
+				m_ranks( ),
+				m_values( ) { }
+
+		sparse_column_t::sparse_column_t( ::std::vector<DataCell> & cells, string_arena_t & arena ):
+				m_size( cells.size( ) ),
+				m_present( (cells.size( ) + s_bits_per_word - 1) / s_bits_per_word, 0 ),
+				m_ranks( m_present.size( ), 0 ),
+				m_values( ) {
+
+			m_values.reserve( static_cast<size_t>(density( cells ) * static_cast<double>(m_size) + 0.5) );
+			for( size_t row = 0; row < m_size; ++row ) {
+				auto const word = row / s_bits_per_word;
+				if( 0 == row % s_bits_per_word ) {
+					m_ranks[word] = static_cast<uint32_t>(m_values.size( ));
+				}
+				if( cells[row] ) {
+					m_present[word] |= static_cast<uint64_t>(1) << (row % s_bits_per_word);
+#if PACK_VARIANT
+					m_values.emplace_back( cells[row], arena );
+#else
+					m_values.push_back( ::std::move( cells[row] ) );
+#endif
+				}
+			}
+		}
+
+		sparse_column_t::value_type const & sparse_column_t::operator[]( size_t row ) const {
+			auto const word = row / s_bits_per_word;
+			auto const bit = static_cast<uint64_t>(1) << (row % s_bits_per_word);
+			auto const present = m_present[word];
+			if( 0 == (present & bit) ) {
+				return empty_cell( );
+			}
+			return m_values[m_ranks[word] + popcount( present & (bit - 1) )];
+		}
+
+		size_t sparse_column_t::size( ) const {
+			return m_size;
+		}
+
+		bool sparse_column_t::empty( ) const {
+			return 0 == m_size;
+		}
+
+		size_t sparse_column_t::value_count( ) const {
+			return m_values.size( );
+		}
+
+		size_t sparse_column_t::footprint( ) const {
+			return sizeof( *this ) + m_present.capacity( ) * sizeof( uint64_t ) + m_ranks.capacity( ) * sizeof( uint32_t ) + m_values.capacity( ) * sizeof( value_type );
+		}
+
+		double sparse_column_t::density( ::std::vector<DataCell> const & cells ) {
+			if( cells.empty( ) ) {
+				return 1.0;
+			}
+			size_t values = 0;
+			for( size_t row = 0; row < cells.size( ); ++row ) {
+				if( cells[row] ) {
+					++values;
+				}
+			}
+			return static_cast<double>(values) / static_cast<double>(cells.size( ));
+		}
+	}	// namespace data
+}	// namespace daw
+
@@ -20,6 +20,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 #include <daw/daw_string.h>
@@ -28,10 +30,216 @@
 
 namespace daw {
 	namespace string {
+		namespace {
+			char const * const s_month_abbr[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+			char const * const s_month_name[] = { "January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December" };
+			char const * const s_weekday_abbr[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+			char const * const s_weekday_name[] = { "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday" };
+
+			/// Bounded output, writes past the end are dropped
+			struct writer_t {
+				char * out;
+				size_t size;
+				size_t pos;
+
+				void put( char c ) {
+					if( pos < size ) {
+						out[pos] = c;
+					}
+					++pos;
+				}
+
+				void put( char const * str ) {
+					while( *str ) {
+						put( *str++ );
+					}
+				}
+
+				void put( char const * str, size_t len ) {
+					for( size_t n = 0; n < len; ++n ) {
+						put( str[n] );
+					}
+				}
+
+				void put_number( long value, size_t width ) {
+					char digits[20];
+					size_t count = 0;
+					auto remaining = value < 0 ? -value : value;
+					do {
+						digits[count++] = static_cast<char>('0' + remaining % 10);
+						remaining /= 10;
+					} while( remaining > 0 && count < sizeof( digits ) );
+					if( value < 0 ) {
+						put( '-' );
+					}
+					for( ; count < width; --width ) {
+						put( '0' );
+					}
+					while( count > 0 ) {
+						put( digits[--count] );
+					}
+				}
+
+				size_t written( ) const {
+					return ::std::min( pos, size );
+				}
+			};	// writer_t
+		}	// namespace anonymous
+
+		void ptime_formatter_t::add_literal( char const * first, size_t size ) {
+			if( 0 == size ) {
+				return;
+			}
+			if( !m_steps.empty( ) && op_t::literal == m_steps.back( ).op && m_steps.back( ).literal_first + m_steps.back( ).literal_size == m_literals.size( ) ) {
+				m_steps.back( ).literal_size = static_cast<uint16_t>(m_steps.back( ).literal_size + size);
+			} else {
+				m_steps.push_back( step_t{ op_t::literal, static_cast<uint16_t>(m_literals.size( )), static_cast<uint16_t>(size) } );
+			}
+			m_literals.append( first, size );
+			m_max_size += size;
+		}
+
+		void ptime_formatter_t::add_op( op_t op ) {
+			static size_t const s_fraction_digits = static_cast<size_t>(boost::posix_time::time_duration::num_fractional_digits( ));
+			m_steps.push_back( step_t{ op, 0, 0 } );
+			switch( op ) {
+			case op_t::year: m_max_size += 4; break;
+			case op_t::month_name:
+			case op_t::weekday_name: m_max_size += 9; break;
+			case op_t::month_abbr:
+			case op_t::weekday_abbr:
+			case op_t::day_of_year: m_max_size += 3; break;
+			case op_t::fractional_seconds: m_max_size += s_fraction_digits; break;
+			case op_t::fractional_seconds_if_any: m_max_size += s_fraction_digits + 1; break;
+			default: m_max_size += 2; break;
+			}
+		}
+
+		ptime_formatter_t::ptime_formatter_t( ::std::string const & format ):
+				m_steps( ),
+				m_literals( ),
+				m_max_size( 0 ) {
+
+			size_t literal_first = 0;
+			size_t n = 0;
+			while( n < format.size( ) ) {
+				if( '%' != format[n] || n + 1 == format.size( ) ) {
+					++n;
+					continue;
+				}
+				auto const code = format[n + 1];
+				auto literal_size = n - literal_first;
+				if( ('Z' == code || 'z' == code) && 0 < literal_size && ' ' == format[n - 1] ) {
+					--literal_size;	// As boost does, drop the separator of a zone that is not there
+				}
+				add_literal( format.data( ) + literal_first, literal_size );
+				n += 2;
+				literal_first = n;
+				switch( code ) {
+				case 'Y': add_op( op_t::year ); break;
+				case 'y': add_op( op_t::year_2digit ); break;
+				case 'm': add_op( op_t::month ); break;
+				case 'b': add_op( op_t::month_abbr ); break;
+				case 'B': add_op( op_t::month_name ); break;
+				case 'd': add_op( op_t::day ); break;
+				case 'j': add_op( op_t::day_of_year ); break;
+				case 'a': add_op( op_t::weekday_abbr ); break;
+				case 'A': add_op( op_t::weekday_name ); break;
+				case 'H': add_op( op_t::hour ); break;
+				case 'I': add_op( op_t::hour_12 ); break;
+				case 'M': add_op( op_t::minute ); break;
+				case 'S': add_op( op_t::second ); break;
+				case 'f': add_op( op_t::fractional_seconds ); break;
+				case 'p': add_op( op_t::am_pm ); break;
+				case 'F': add_op( op_t::fractional_seconds_if_any ); break;
+				case 'T':
+				case 'R':
+					add_op( op_t::hour );
+					add_literal( ":", 1 );
+					add_op( op_t::minute );
+					if( 'T' == code ) {
+						add_literal( ":", 1 );
+						add_op( op_t::second );
+					}
+					break;
+				case 'D':
+					add_op( op_t::month );
+					add_literal( "/", 1 );
+					add_op( op_t::day );
+					add_literal( "/", 1 );
+					add_op( op_t::year_2digit );
+					break;
+				case '%': add_literal( "%", 1 ); break;
+				case 'Z':
+				case 'z': break;
+				default: add_literal( format.data( ) + n - 2, 2 ); break;
+				}
+			}
+			add_literal( format.data( ) + literal_first, format.size( ) - literal_first );
+			m_max_size = ::std::max<size_t>( m_max_size, 15 );	// Room for "not-a-date-time"
+		}
+
+		size_t ptime_formatter_t::max_size( ) const {
+			return m_max_size;
+		}
+
+		size_t ptime_formatter_t::format( boost::posix_time::ptime const & value, char * out, size_t out_size ) const {
+			writer_t w{ out, out_size, 0 };
+			if( value.is_special( ) ) {
+				w.put( value.is_not_a_date_time( ) ? "not-a-date-time" : value.is_pos_infinity( ) ? "+infinity" : "-infinity" );
+				return w.written( );
+			}
+			auto const dte = value.date( );
+			auto const ymd = dte.year_month_day( );
+			auto const tod = value.time_of_day( );
+			auto const hours = static_cast<long>(tod.hours( ));
+			for( auto const & step : m_steps ) {
+				switch( step.op ) {
+				case op_t::literal: w.put( m_literals.data( ) + step.literal_first, step.literal_size ); break;
+				case op_t::year: w.put_number( static_cast<long>(ymd.year), 4 ); break;
+				case op_t::year_2digit: w.put_number( static_cast<long>(ymd.year) % 100, 2 ); break;
+				case op_t::month: w.put_number( static_cast<long>(ymd.month.as_number( )), 2 ); break;
+				case op_t::month_abbr: w.put( s_month_abbr[ymd.month.as_number( ) - 1] ); break;
+				case op_t::month_name: w.put( s_month_name[ymd.month.as_number( ) - 1] ); break;
+				case op_t::day: w.put_number( static_cast<long>(ymd.day), 2 ); break;
+				case op_t::day_of_year: w.put_number( static_cast<long>(dte.day_of_year( )), 3 ); break;
+				case op_t::weekday_abbr: w.put( s_weekday_abbr[dte.day_of_week( ).as_number( )] ); break;
+				case op_t::weekday_name: w.put( s_weekday_name[dte.day_of_week( ).as_number( )] ); break;
+				case op_t::hour: w.put_number( hours, 2 ); break;
+				case op_t::hour_12: w.put_number( 0 == hours % 12 ? 12 : hours % 12, 2 ); break;
+				case op_t::minute: w.put_number( static_cast<long>(tod.minutes( )), 2 ); break;
+				case op_t::second: w.put_number( static_cast<long>(tod.seconds( )), 2 ); break;
+				case op_t::fractional_seconds: w.put_number( static_cast<long>(tod.fractional_seconds( )), static_cast<size_t>(boost::posix_time::time_duration::num_fractional_digits( )) ); break;
+				case op_t::fractional_seconds_if_any:
+					if( 0 != tod.fractional_seconds( ) ) {
+						w.put( '.' );
+						w.put_number( static_cast<long>(tod.fractional_seconds( )), static_cast<size_t>(boost::posix_time::time_duration::num_fractional_digits( )) );
+					}
+					break;
+				case op_t::am_pm: w.put( hours < 12 ? "AM" : "PM" ); break;
+				}
+			}
+			return w.written( );
+		}
+
+		::std::string ptime_formatter_t::to_string( boost::posix_time::ptime const & value ) const {
+			char buff[128];
+			if( m_max_size <= sizeof( buff ) ) {
+				return ::std::string( buff, format( value, buff, sizeof( buff ) ) );
+			}
+			::std::string result( m_max_size, '\0' );
+			result.resize( format( value, &result[0], result.size( ) ) );
+			return result;
+		}
+
 		std::string ptime_to_string( const boost::posix_time::ptime& value, const std::string& format, const std::string locale_str ) {
+			if( locale_str.empty( ) ) {
+				return ptime_formatter_t( format ).to_string( value );
+			}
 			try {
-				static std::stringstream ss( "" );
-				static std::unique_ptr<boost::posix_time::time_facet> facet;
+				// Per thread as plot display lists are built on worker threads.  The facet must outlive the stream imbued with it
+				thread_local std::unique_ptr<boost::posix_time::time_facet> facet;
+				thread_local std::stringstream ss( "" );
 				if( !facet ) {
 					facet = std::make_unique<boost::posix_time::time_facet>( 1 );
 					ss.imbue( std::locale( std::locale( locale_str ), facet.get( ) ) );
@@ -47,7 +255,7 @@ namespace daw {
 
 		std::string ptime_to_string( const boost::posix_time::time_duration& value, bool show_seconds ) {
 			try {
-				static std::stringstream ss( "" );
+				thread_local std::stringstream ss( "" );
 				clear( ss );
 				ss << std::setw( 2 ) << std::setfill( '0' ) << value.hours( );
 				ss << ":";
@@ -0,0 +1,260 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <string>
+
+#include "task_pool.h"
+#include "trace.h"
+
+namespace daw {
+	namespace {
+		// Index of the pool worker running on this thread
+		thread_local task_pool_t const * t_pool = nullptr;
+		thread_local size_t t_worker_index = 0;
+		// Of the task running on this thread
+		thread_local task_priority_t t_priority = task_priority_t::interactive;
+	}	// namespace anonymous
+
+	namespace impl {
+		pool_job_t::callable_base_t::~callable_base_t( ) { }
+
+		bool pool_job_t::is_claimed( ) const {
+			return m_claimed.load( ::std::memory_order_acquire );
+		}
+
+		bool pool_job_t::try_claim( ) {
+			bool expected = false;
+			return m_claimed.compare_exchange_strong( expected, true, ::std::memory_order_acq_rel );
+		}
+
+		void pool_job_t::run( ) {
+			// Set wherever the task runs, a worker or a thread waiting on it.  The packaged_task of submit keeps
+			// whatever the task throws, nothing leaves run early
+			auto const previous_priority = t_priority;
+			t_priority = priority;
+			m_callable->run( );
+			t_priority = previous_priority;
+			m_callable.reset( );	// Free what the task captured now, not when the last handle goes
+		}
+	}	// namespace impl
+
+	task_pool_t::task_pool_t( size_t thread_count, size_t memory_budget ):
+			m_memory_budget( memory_budget ),
+			m_low_priority_limit( ::std::max<size_t>( thread_count, 2 ) - 1 ),
+			m_memory_in_use( 0 ),
+			m_low_priority_running( 0 ),
+			m_held_back( false ),
+			m_injected( ),
+			m_queues( ),
+			m_wake_mutex( ),
+			m_wake( ),
+			m_wake_count( 0 ),
+			m_stopping( false ),
+			m_threads( ) {
+
+		thread_count = ::std::max<size_t>( thread_count, 2 );
+		for( size_t n = 0; n < thread_count; ++n ) {
+			m_queues.emplace_back( new queue_t( ) );
+		}
+		m_threads.reserve( thread_count );
+		for( size_t n = 0; n < thread_count; ++n ) {
+			m_threads.emplace_back( [this, n]( ) {
+				worker_loop( n );
+			} );
+		}
+	}
+
+	task_pool_t::~task_pool_t( ) {
+		{
+			::std::lock_guard<::std::mutex> lock( m_wake_mutex );
+			m_stopping = true;
+			++m_wake_count;
+		}
+		m_wake.notify_all( );
+		for( auto & th : m_threads ) {
+			th.join( );
+		}
+	}
+
+	task_pool_t & task_pool_t::get( ) {
+		static task_pool_t s_pool( ::std::max( 2u, ::std::thread::hardware_concurrency( ) ), default_memory_budget );
+		return s_pool;
+	}
+
+	task_priority_t task_pool_t::current_priority( ) {
+		return t_priority;
+	}
+
+	bool task_pool_t::is_worker_thread( ) const {
+		return this == t_pool;
+	}
+
+	size_t task_pool_t::thread_count( ) const {
+		return m_threads.size( );
+	}
+
+	size_t task_pool_t::memory_in_use( ) const {
+		return m_memory_in_use.load( ::std::memory_order_relaxed );
+	}
+
+	size_t task_pool_t::memory_budget( ) const {
+		return m_memory_budget.load( ::std::memory_order_relaxed );
+	}
+
+	void task_pool_t::set_memory_budget( size_t memory_budget ) {
+		m_memory_budget.store( memory_budget, ::std::memory_order_relaxed );
+		// A larger budget may let held back tasks start
+		signal( true );
+	}
+
+	void task_pool_t::signal( bool all ) {
+		{
+			::std::lock_guard<::std::mutex> lock( m_wake_mutex );
+			++m_wake_count;
+		}
+		if( all ) {
+			m_wake.notify_all( );
+		} else {
+			m_wake.notify_one( );
+		}
+	}
+
+	void task_pool_t::enqueue( job_ptr_t job ) {
+		auto const priority = static_cast<size_t>(job->priority);
+		// Tasks started by a worker are most likely needed by it, they go on its own queue
+		auto & queue = this == t_pool ? *m_queues[t_worker_index] : m_injected;
+		{
+			::std::lock_guard<::std::mutex> lock( queue.mutex );
+			queue.jobs[priority].push_back( ::std::move( job ) );
+		}
+		signal( false );
+	}
+
+	bool task_pool_t::try_admit( impl::pool_job_t const & job ) {
+		if( task_priority_t::interactive != job.priority ) {
+			auto running = m_low_priority_running.load( ::std::memory_order_relaxed );
+			do {
+				if( running >= m_low_priority_limit ) {
+					return false;
+				}
+			} while( !m_low_priority_running.compare_exchange_weak( running, running + 1, ::std::memory_order_relaxed ) );
+		}
+		if( 0 != job.memory ) {
+			auto in_use = m_memory_in_use.load( ::std::memory_order_relaxed );
+			do {
+				// An oversized task is let in when nothing else holds memory, or it would never run
+				if( 0 != in_use && in_use + job.memory > m_memory_budget.load( ::std::memory_order_relaxed ) ) {
+					if( task_priority_t::interactive != job.priority ) {
+						m_low_priority_running.fetch_sub( 1, ::std::memory_order_relaxed );
+					}
+					return false;
+				}
+			} while( !m_memory_in_use.compare_exchange_weak( in_use, in_use + job.memory, ::std::memory_order_relaxed ) );
+		}
+		return true;
+	}
+
+	void task_pool_t::release( impl::pool_job_t const & job ) {
+		if( 0 != job.memory ) {
+			m_memory_in_use.fetch_sub( job.memory, ::std::memory_order_relaxed );
+		}
+		if( task_priority_t::interactive != job.priority ) {
+			m_low_priority_running.fetch_sub( 1, ::std::memory_order_relaxed );
+		}
+	}
+
+	task_pool_t::job_ptr_t task_pool_t::take( queue_t & queue, size_t priority, bool lifo ) {
+		::std::lock_guard<::std::mutex> lock( queue.mutex );
+		auto & jobs = queue.jobs[priority];
+		for( size_t n = 0; n < jobs.size( ); ) {
+			auto const pos = jobs.begin( ) + static_cast<ptrdiff_t>(lifo ? jobs.size( ) - 1 - n : n);
+			auto & job = *pos;
+			if( job->is_claimed( ) ) {
+				// Already run by a thread waiting on it
+				jobs.erase( pos );
+				continue;
+			}
+			if( !try_admit( *job ) ) {
+				m_held_back.store( true, ::std::memory_order_relaxed );
+				++n;
+				continue;
+			}
+			if( !job->try_claim( ) ) {
+				release( *job );
+				jobs.erase( pos );
+				continue;
+			}
+			auto result = ::std::move( job );
+			jobs.erase( pos );
+			return result;
+		}
+		return nullptr;
+	}
+
+	task_pool_t::job_ptr_t task_pool_t::find_job( size_t worker_index ) {
+		for( size_t priority = 0; priority < s_priority_count; ++priority ) {
+			if( auto job = take( *m_queues[worker_index], priority, true ) ) {
+				return job;
+			}
+			if( auto job = take( m_injected, priority, false ) ) {
+				return job;
+			}
+			for( size_t n = 1; n < m_queues.size( ); ++n ) {
+				if( auto job = take( *m_queues[(worker_index + n) % m_queues.size( )], priority, false ) ) {
+					return job;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	void task_pool_t::worker_loop( size_t worker_index ) {
+		t_pool = this;
+		t_worker_index = worker_index;
+		set_trace_thread_name( "Pool worker " + ::std::to_string( worker_index ) );
+		while( true ) {
+			uint64_t wake_count;
+			{
+				::std::lock_guard<::std::mutex> lock( m_wake_mutex );
+				wake_count = m_wake_count;
+			}
+			if( auto job = find_job( worker_index ) ) {
+				job->run( );
+				release( *job );
+				// Freed a slot or memory.  Every worker is woken only when a task was held back by either, this
+				// one looks for more work itself and any idle one will do for the rest
+				signal( m_held_back.exchange( false, ::std::memory_order_relaxed ) );
+				continue;
+			}
+			::std::unique_lock<::std::mutex> lock( m_wake_mutex );
+			if( m_stopping ) {
+				break;
+			}
+			m_wake.wait( lock, [&]( ) {
+				return m_stopping || wake_count != m_wake_count;
+			} );
+		}
+	}
+}	// namespace daw
+
@@ -0,0 +1,125 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+
+#include "panel_generic_plot.h"
+#include "text_metrics.h"
+
+namespace daw {
+	namespace pumpdataanalysis {
+		bool text_metrics_t::font_key_t::operator==( font_key_t const & rhs ) const {
+			return point_size == rhs.point_size && family == rhs.family && style == rhs.style && weight == rhs.weight;
+		}
+
+		text_metrics_t::font_key_t text_metrics_t::key_of( wxFont const & font ) {
+			return font_key_t{ font.GetPointSize( ), static_cast<int>(font.GetFamily( )), static_cast<int>(font.GetStyle( )), static_cast<int>(font.GetWeight( )) };
+		}
+
+		text_metrics_t::text_metrics_t( ::std::vector<wxFont> const & fonts ):
+				m_fonts{ } {
+
+			wxMemoryDC dc;
+			auto measure = [&dc]( wxFont const * font ) {
+				font_metrics_t result;
+				result.is_default = nullptr == font;
+				result.key = nullptr == font ? font_key_t{ 0, 0, 0, 0 } : key_of( *font );
+				result.height = 0;
+				wxCoord zero{ 0 };
+				wxCoord height{ 0 };
+				int total = 0;
+				for( size_t n = s_first_glyph; n <= s_last_glyph; ++n ) {
+					wxCoord width{ 0 };
+					dc.GetTextExtent( wxString( static_cast<char>(n), 1 ), &width, &height, &zero, &zero, font );
+					result.advances[n - s_first_glyph] = width;
+					result.height = ::std::max( result.height, height );
+					total += width;
+				}
+				result.fallback_advance = total / static_cast<int>(result.advances.size( ));
+				return result;
+			};
+			m_fonts.reserve( fonts.size( ) + 1 );
+			m_fonts.push_back( measure( nullptr ) );
+			for( auto const & font : fonts ) {
+				if( font.IsOk( ) ) {
+					m_fonts.push_back( measure( &font ) );
+				}
+			}
+		}
+
+		text_metrics_t::font_metrics_t const & text_metrics_t::find( wxFont const & font ) const {
+			if( font.IsOk( ) ) {
+				return find( key_of( font ) );
+			}
+			return m_fonts.front( );
+		}
+
+		text_metrics_t::font_metrics_t const & text_metrics_t::find( font_key_t const & key ) const {
+			auto const pos = ::std::find_if( m_fonts.begin( ), m_fonts.end( ), [&key]( font_metrics_t const & metrics ) {
+				return !metrics.is_default && metrics.key == key;
+			} );
+			if( m_fonts.end( ) != pos ) {
+				return *pos;
+			}
+			return m_fonts.front( );
+		}
+
+		wxSize text_metrics_t::get_text_extent( wxFont const & font, wxString const & text ) const {
+			auto const & metrics = find( font );
+			int width = 0;
+			for( auto const ch : text ) {
+				auto const code = static_cast<size_t>(wxUniChar( ch ).GetValue( ));
+				if( code >= s_first_glyph && code <= s_last_glyph ) {
+					width += metrics.advances[code - s_first_glyph];
+				} else {
+					width += metrics.fallback_advance;
+				}
+			}
+			return wxSize( width, metrics.height );
+		}
+
+		int text_metrics_t::get_text_width( font_key_t const & key, ::std::string const & text ) const {
+			auto const & metrics = find( key );
+			int width = 0;
+			for( auto const ch : text ) {
+				auto const code = static_cast<unsigned char>(ch);
+				if( code >= s_first_glyph && code <= s_last_glyph ) {
+					width += metrics.advances[code - s_first_glyph];
+				} else if( (code & 0xC0) != 0x80 ) {
+					// One fallback advance per code point, continuation bytes add nothing
+					width += metrics.fallback_advance;
+				}
+			}
+			return width;
+		}
+
+		::std::shared_ptr<text_metrics_t const> text_metrics_t::for_graphs( ) {
+			static auto const s_metrics = [ ]( ) {
+				graph_config_t const graph_config{ };
+				return ::std::make_shared<text_metrics_t const>( ::std::vector<wxFont>{ graph_config.fnt_axis_title, graph_config.fnt_axis_title_bold } );
+			}();
+			return s_metrics;
+		}
+	}	// namespace pumpdataanalysis
+}	// namespace daw
+
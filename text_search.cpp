@@ -0,0 +1,179 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <boost/utility/string_ref.hpp>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#include <daw/csv_helper/data_common.h>
+
+#include "text_search.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define DAW_TEXT_SEARCH_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define DAW_TEXT_SEARCH_SSE2 0
+#endif
+
+namespace daw {
+	namespace data {
+		namespace {
+			// Rows searched between publishing matches and checking for cancellation
+			size_t const s_rows_per_block = 8192;
+
+#if DAW_TEXT_SEARCH_SSE2
+			unsigned lowest_bit( unsigned value ) {
+#ifdef _MSC_VER
+				unsigned long result;
+				_BitScanForward( &result, value );
+				return static_cast<unsigned>(result);
+#else
+				return static_cast<unsigned>(__builtin_ctz( value ));
+#endif
+			}
+#endif
+
+			void to_lower_ascii( boost::string_ref str, ::std::string & out ) {
+				out.resize( str.size( ) );
+				for( size_t n = 0; n < str.size( ); ++n ) {
+					auto const c = static_cast<unsigned char>(str[n]);
+					out[n] = static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+				}
+			}
+		}	// namespace anonymous
+
+		size_t find_substring( char const * haystack, size_t haystack_size, char const * needle, size_t needle_size ) {
+			if( 0 == needle_size ) {
+				return 0;
+			}
+			if( needle_size > haystack_size ) {
+				return ::std::string::npos;
+			}
+			auto const last_start = haystack_size - needle_size;	// Last position needle can start at
+			size_t pos = 0;
+#if DAW_TEXT_SEARCH_SSE2
+			auto const first_char = _mm_set1_epi8( needle[0] );
+			auto const last_char = _mm_set1_epi8( needle[needle_size - 1] );
+			for( ; pos + 16 <= last_start + 1; pos += 16 ) {
+				auto const block_first = _mm_loadu_si128( reinterpret_cast<__m128i const *>(haystack + pos) );
+				auto const block_last = _mm_loadu_si128( reinterpret_cast<__m128i const *>(haystack + pos + needle_size - 1) );
+				auto mask = static_cast<unsigned>(_mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( block_first, first_char ), _mm_cmpeq_epi8( block_last, last_char ) ) ));
+				while( 0 != mask ) {
+					auto const candidate = pos + lowest_bit( mask );
+					if( needle_size <= 2 || 0 == ::std::memcmp( haystack + candidate + 1, needle + 1, needle_size - 2 ) ) {
+						return candidate;
+					}
+					mask &= mask - 1;
+				}
+			}
+#endif
+			for( ; pos <= last_start; ++pos ) {
+				if( haystack[pos] == needle[0] && 0 == ::std::memcmp( haystack + pos, needle, needle_size ) ) {
+					return pos;
+				}
+			}
+			return ::std::string::npos;
+		}
+
+		text_search_t::text_search_t( ::std::shared_ptr<void const> keep_alive, daw::data::compact_table_t const & table, ::std::string needle ):
+				m_mutex( ),
+				m_matches( ),
+				m_match_count( 0 ),
+				m_done( false ),
+				m_cancel( false ),
+				m_needle( ::std::move( needle ) ),
+				m_worker( ) {
+
+			m_worker = task_pool_t::get( ).submit( task_priority_t::interactive, [this, keep_alive = ::std::move( keep_alive ), &table]( ) {
+				::std::string needle_lower;
+				to_lower_ascii( m_needle, needle_lower );
+				::std::string cell_lower;
+				::std::vector<match_t> block_matches;
+				auto const row_count = table.empty( ) ? 0 : table[0].size( );
+				for( size_t first = 0; first < row_count && !m_cancel; first += s_rows_per_block ) {
+					auto const last = ::std::min( first + s_rows_per_block, row_count );
+					// Column at a time to stay within a column's storage, then put back in row order
+					block_matches.clear( );
+					for( size_t col = 0; col < table.size( ); ++col ) {
+						auto const & column = table[col];
+						for( auto row = first; row < last; ++row ) {
+							auto const & cell = column[row];
+							if( DataCellType::string != cell.type( ) ) {
+								continue;
+							}
+							to_lower_ascii( cell.string( ), cell_lower );
+							if( ::std::string::npos != find_substring( cell_lower.data( ), cell_lower.size( ), needle_lower.data( ), needle_lower.size( ) ) ) {
+								block_matches.push_back( match_t{ row, col } );
+							}
+						}
+					}
+					if( block_matches.empty( ) ) {
+						continue;
+					}
+					::std::sort( block_matches.begin( ), block_matches.end( ), []( match_t const & a, match_t const & b ) {
+						return a.row < b.row || (a.row == b.row && a.col < b.col);
+					} );
+					::std::lock_guard<shared_mutex_t> lock( m_mutex );
+					m_matches.insert( m_matches.end( ), block_matches.begin( ), block_matches.end( ) );
+					m_match_count.store( m_matches.size( ), ::std::memory_order_release );
+				}
+				m_done = true;
+			} );
+		}
+
+		text_search_t::~text_search_t( ) {
+			cancel( );
+			if( m_worker.valid( ) ) {
+				m_worker.wait( );
+			}
+		}
+
+		::std::string const & text_search_t::needle( ) const {
+			return m_needle;
+		}
+
+		size_t text_search_t::match_count( ) const {
+			return m_match_count.load( ::std::memory_order_acquire );
+		}
+
+		text_search_t::match_t text_search_t::match( size_t pos ) const {
+			::std::shared_lock<shared_mutex_t> lock( m_mutex );
+			return m_matches[pos];
+		}
+
+		bool text_search_t::is_done( ) const {
+			return m_done;
+		}
+
+		void text_search_t::cancel( ) {
+			m_cancel = true;
+		}
+	}	// namespace data
+}	// namespace daw
+
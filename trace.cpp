@@ -0,0 +1,212 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2015 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "trace.h"
+
+namespace daw {
+	namespace impl {
+		::std::atomic<bool> g_trace_enabled( false );
+	}	// namespace impl
+
+	namespace {
+		struct trace_event_t {
+			char const * name;
+			trace_clock_t::time_point begin;
+			trace_clock_t::time_point end;
+			::std::array<trace_span_t::counter_t, trace_span_t::max_counters> counters;
+			size_t counter_count;
+		};	// trace_event_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>One thread's spans.  Only the owning thread writes, the
+		/// mutex is uncontended unless a dump is being written</summary>
+		//////////////////////////////////////////////////////////////////////////
+		struct trace_buffer_t {
+			static size_t const capacity = 16384;
+
+			::std::mutex mutex;
+			size_t const thread_id;
+			::std::string thread_name;
+			::std::vector<trace_event_t> events;
+			size_t next;	// Slot written next once events is full
+
+			explicit trace_buffer_t( size_t id ):
+					mutex( ),
+					thread_id( id ),
+					thread_name( ),
+					events( ),
+					next( 0 ) { }
+
+			void push( trace_event_t const & event ) {
+				::std::lock_guard<::std::mutex> lock( mutex );
+				if( events.size( ) < capacity ) {
+					events.push_back( event );
+					return;
+				}
+				events[next] = event;
+				next = (next + 1) % capacity;
+			}
+		};	// trace_buffer_t
+
+		//////////////////////////////////////////////////////////////////////////
+		/// <summary>Every thread's buffer.  Buffers outlive their threads so
+		/// spans of finished threads are still written</summary>
+		//////////////////////////////////////////////////////////////////////////
+		struct trace_registry_t {
+			::std::mutex mutex;
+			::std::vector<::std::shared_ptr<trace_buffer_t>> buffers;
+			trace_clock_t::time_point const epoch;
+
+			trace_registry_t( ):
+					mutex( ),
+					buffers( ),
+					epoch( trace_clock_t::now( ) ) { }
+
+			static trace_registry_t & get( ) {
+				static trace_registry_t s_registry;
+				return s_registry;
+			}
+		};	// trace_registry_t
+
+		trace_buffer_t & thread_buffer( ) {
+			thread_local ::std::shared_ptr<trace_buffer_t> t_buffer;
+			if( !t_buffer ) {
+				auto & registry = trace_registry_t::get( );
+				::std::lock_guard<::std::mutex> lock( registry.mutex );
+				t_buffer = ::std::make_shared<trace_buffer_t>( registry.buffers.size( ) + 1 );
+				registry.buffers.push_back( t_buffer );
+			}
+			return *t_buffer;
+		}
+
+		void write_json_string( ::std::ostream & os, char const * str ) {
+			os << '"';
+			for( ; 0 != *str; ++str ) {
+				auto const c = *str;
+				if( '"' == c || '\\' == c ) {
+					os << '\\' << c;
+				} else if( static_cast<unsigned char>(c) < 0x20 ) {
+					os << ' ';
+				} else {
+					os << c;
+				}
+			}
+			os << '"';
+		}
+
+		double microseconds( trace_clock_t::duration d ) {
+			return ::std::chrono::duration<double, ::std::micro>( d ).count( );
+		}
+	}	// namespace anonymous
+
+	void set_trace_enabled( bool enabled ) {
+		// Make sure the epoch predates every span
+		trace_registry_t::get( );
+		impl::g_trace_enabled.store( enabled, ::std::memory_order_relaxed );
+	}
+
+	void set_trace_thread_name( ::std::string name ) {
+		auto & buffer = thread_buffer( );
+		::std::lock_guard<::std::mutex> lock( buffer.mutex );
+		buffer.thread_name = ::std::move( name );
+	}
+
+	void clear_trace( ) {
+		auto & registry = trace_registry_t::get( );
+		::std::lock_guard<::std::mutex> lock( registry.mutex );
+		for( auto const & buffer : registry.buffers ) {
+			::std::lock_guard<::std::mutex> buffer_lock( buffer->mutex );
+			buffer->events.clear( );
+			buffer->next = 0;
+		}
+	}
+
+	void trace_span_t::record( ) {
+		thread_buffer( ).push( trace_event_t{ m_name, m_begin, trace_clock_t::now( ), m_counters, m_counter_count } );
+	}
+
+	void write_chrome_trace( ::std::ostream & os ) {
+		auto & registry = trace_registry_t::get( );
+		::std::lock_guard<::std::mutex> lock( registry.mutex );
+		auto const old_flags = os.flags( );
+		auto const old_precision = os.precision( 3 );
+		os.setf( ::std::ios::fixed, ::std::ios::floatfield );
+		os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		auto const separator = [&]( ) {
+			os << (first ? "\n" : ",\n");
+			first = false;
+		};
+		for( auto const & buffer : registry.buffers ) {
+			::std::lock_guard<::std::mutex> buffer_lock( buffer->mutex );
+			if( !buffer->thread_name.empty( ) ) {
+				separator( );
+				os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"args\":{\"name\":";
+				write_json_string( os, buffer->thread_name.c_str( ) );
+				os << "}}";
+			}
+			for( auto const & event : buffer->events ) {
+				separator( );
+				os << "{\"name\":";
+				write_json_string( os, event.name );
+				os << ",\"cat\":\"mm_history\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id;
+				os << ",\"ts\":" << microseconds( event.begin - registry.epoch ) << ",\"dur\":" << microseconds( event.end - event.begin );
+				if( 0 < event.counter_count ) {
+					os << ",\"args\":{";
+					for( size_t n = 0; n < event.counter_count; ++n ) {
+						if( 0 < n ) {
+							os << ',';
+						}
+						write_json_string( os, event.counters[n].name );
+						os << ':' << event.counters[n].value;
+					}
+					os << '}';
+				}
+				os << '}';
+			}
+		}
+		os << "\n]}\n";
+		os.flags( old_flags );
+		os.precision( old_precision );
+	}
+
+	void write_chrome_trace( ::std::string const & filename ) {
+		::std::ofstream out( filename, ::std::ios::out | ::std::ios::trunc );
+		if( !out ) {
+			throw ::std::runtime_error( "Could not open " + filename + " for writing" );
+		}
+		write_chrome_trace( out );
+		if( !out ) {
+			throw ::std::runtime_error( "Could not write " + filename );
+		}
+	}
+}	// namespace daw
+